@@ -971,7 +971,7 @@ static void setupOneReduceIntent(VarSymbol* iterRec, BlockStmt* parLoop,
   parLoop->insertAfter("chpl__delete(%S)",
                        globalOp);
   parLoop->insertAfter(new CallExpr("=", reduceVar->copy(),
-                         new_Expr(".(%S, 'generate')()", globalOp)));
+                         new CallExpr("chpl__reduceGenerate", globalOp)));
 }
 
 // Setup for forall intents
@@ -1886,7 +1886,7 @@ CallExpr* buildReduceExpr(Expr* opExpr, Expr* dataExpr, bool zippered) {
   fn->insertAtTail(new CondStmt(new SymExpr(gTryToken), leadBlock, serialBlock));
 
   VarSymbol* result = new VarSymbol("result");
-  fn->insertAtTail(new DefExpr(result, new CallExpr(new CallExpr(".", globalOp, new_CStringSymbol("generate")))));
+  fn->insertAtTail(new DefExpr(result, new CallExpr("chpl__reduceGenerate", globalOp)));
   fn->insertAtTail("chpl__delete(%S)", globalOp);
   fn->insertAtTail("'return'(%S)", result);
   return new CallExpr(new DefExpr(fn), dataExpr);
@@ -1912,11 +1912,15 @@ CallExpr* buildScanExpr(Expr* opExpr, Expr* dataExpr, bool zippered) {
   buildReduceScanPreface1(fn, data, eltType, opExpr, dataExpr, zippered);
   buildReduceScanPreface2(fn, eltType, globalOp, opExpr);
 
-  fn->insertAtTail("compilerWarning('scan has been serialized (see issue #5760)')");
-
   if( !zippered ) {
-    fn->insertAtTail("'return'(chpl__scanIterator(%S, %S))", globalOp, data);
+    CallExpr* isParallel = new CallExpr("chpl__scanIsParallel", globalOp, data);
+    CallExpr* warning    = new CallExpr("compilerWarning",
+                             new_StringSymbol("scan has been serialized (see issue #5760)"));
+
+    fn->insertAtTail(new CondStmt(new CallExpr("!", isParallel), warning));
+    fn->insertAtTail("'return'(chpl__scan(%S, %S))", globalOp, data);
   } else {
+    fn->insertAtTail("compilerWarning('scan has been serialized (see issue #5760)')");
     fn->insertAtTail("'return'(chpl__scanIteratorZip(%S, %S))", globalOp, data);
   }
 
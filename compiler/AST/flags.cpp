@@ -62,6 +62,17 @@ initFlags() {
 
 }
 
+// Does sym carry any flag that can be set with a pragma?
+bool hasPragmaFlag(Symbol* sym) {
+  for (int flagNum = FLAG_FIRST; flagNum <= FLAG_LAST; flagNum++) {
+    if (sym->flags[flagNum] && flagPragma[flagNum]) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
 void writeFlags(FILE* fp, Symbol* sym) {
   for (int flagNum = FLAG_FIRST; flagNum <= FLAG_LAST; flagNum++) {
     if (sym->flags[flagNum]) {
@@ -32,6 +32,7 @@
 #include "llvmUtil.h"
 #include "LayeredValueTable.h"
 #include "mysystem.h"
+#include "objectCache.h"
 #include "passes.h"
 #include "stlUtil.h"
 #include "stmt.h"
@@ -57,6 +58,7 @@
 #include <cctype>
 #include <cstring>
 #include <cstdio>
+#include <set>
 #include <vector>
 
 // function prototypes
@@ -70,6 +72,8 @@ int      gStmtCount =  0;
 
 std::map<std::string, int> commIDMap;
 
+int fParallelCCompile = 0;
+
 
 // ensure these two produce consistent output
 std::string zlineToString(BaseAST* ast) {
@@ -1350,7 +1354,7 @@ static void codegen_defn(std::set<const char*> & cnames, std::vector<TypeSymbol*
   genComment("Virtual Method Table");
   genVirtualMethodTable(types, false);
 
-  if(fIncrementalCompilation) {
+  if(codegenSeparateTUs()) {
     genComment("Global Variables");
     forv_Vec(VarSymbol, varSymbol, globals) {
       varSymbol->codegenGlobalDef(false);
@@ -2219,6 +2223,213 @@ static void setupDefaultFilenames() {
 }
 
 
+// The object file compiled from _main.c is $(TMPBINNAME).o, and in
+// --incremental mode each user module (and with --parallel-c-compile each
+// unit) is compiled to the object named in userObjFiles from the .c file
+// with the same name.
+static const char* mainTmpBinName = NULL;
+static std::vector<const char*> userObjFiles;
+
+// The object compiled from the compilation config when it isn't part of
+// _main.c, which is only the case with --c-cache-dir.
+static const char* cfgObjFile = NULL;
+
+//
+// With --parallel-c-compile, the functions of the modules that would
+// otherwise be #included into _main.c are split across fParallelCCompile
+// translation units, chpl__unit<i>.c, of roughly equal size, and the
+// generated Makefile compiles them in parallel.  Functions small enough to
+// be worth inlining across units are instead defined static inline in
+// chpl__inline.h, which every unit sees through chpl__header.h.
+//
+static const int parallelInlineWeight = 32;
+
+static std::vector<std::vector<FnSymbol*> > codegenUnits;
+static std::vector<FnSymbol*>               headerInlineFns;
+
+static bool parallelCCompile() {
+  return fParallelCCompile > 1 && !llvmCodegen;
+}
+
+bool codegenSeparateTUs() {
+  return fIncrementalCompilation || parallelCCompile();
+}
+
+// The number of AST nodes in the body, as an estimate of how long the
+// back-end compiler will take over the function.
+static int codegenWeight(FnSymbol* fn) {
+  std::vector<BaseAST*> asts;
+
+  collect_asts(fn->body, asts);
+
+  return (int) asts.size();
+}
+
+// A function can be defined in the header if it is only ever called
+// directly: each translation unit then gets its own copy, so its address
+// must not be taken, whether by a first-class function, the function
+// pointer table or a virtual method table.
+static bool canCodegenInHeader(FnSymbol* fn, std::set<FnSymbol*>& vmtFns) {
+  if (fn->hasFlag(FLAG_EXPORT)                    ||
+      fn->hasFlag(FLAG_EXTERN)                    ||
+      fn->hasFlag(FLAG_NO_PROTOTYPE)              ||
+      fn->hasFlag(FLAG_BEGIN_BLOCK)               ||
+      fn->hasFlag(FLAG_COBEGIN_OR_COFORALL_BLOCK) ||
+      fn->hasFlag(FLAG_ON_BLOCK)                  ||
+      vmtFns.count(fn) != 0)
+    return false;
+
+  for_SymbolSymExprs(se, fn) {
+    CallExpr* call = toCallExpr(se->parentExpr);
+
+    if (call == NULL || call->baseExpr != se)
+      return false;
+  }
+
+  return true;
+}
+
+struct UnitCandidate {
+  FnSymbol* fn;
+  int       weight;
+  int       order;
+};
+
+static bool heavierCandidate(const UnitCandidate& a, const UnitCandidate& b) {
+  if (a.weight != b.weight)
+    return a.weight > b.weight;
+
+  return a.order < b.order;
+}
+
+static bool earlierCandidate(const UnitCandidate& a, const UnitCandidate& b) {
+  return a.order < b.order;
+}
+
+//
+// Assign the functions to units, largest first, each to the unit with the
+// least weight so far.  Everything is ordered by weight and then by
+// position in the AST, so the same program always gets the same split and
+// the object cache can reuse the units that didn't change.
+//
+static void partitionCodegenUnits() {
+  typedef MapElem<Type*, Vec<FnSymbol*>*> VmtMapElem;
+
+  std::set<FnSymbol*>                 vmtFns;
+  std::vector<UnitCandidate>          candidates;
+  std::vector<int>                    unitWeights(fParallelCCompile, 0);
+  std::vector<std::vector<UnitCandidate> > units(fParallelCCompile);
+
+  codegenUnits.clear();
+  headerInlineFns.clear();
+
+  form_Map(VmtMapElem, elem, virtualMethodTable) {
+    if (elem->value) {
+      forv_Vec(FnSymbol, fn, *elem->value) {
+        vmtFns.insert(fn);
+      }
+    }
+  }
+
+  forv_Vec(ModuleSymbol, currentModule, allModules) {
+    if (fIncrementalCompilation && currentModule->modTag == MOD_USER)
+      continue;
+
+    for_vector(FnSymbol, fn, currentModule->getTopLevelFunctions(false)) {
+      if (fn->hasFlag(FLAG_NO_CODEGEN))
+        continue;
+
+      UnitCandidate candidate = { fn, codegenWeight(fn),
+                                  (int) candidates.size() };
+
+      if (candidate.weight <= parallelInlineWeight &&
+          canCodegenInHeader(fn, vmtFns)) {
+        fn->addFlag(FLAG_CODEGEN_IN_HEADER);
+        headerInlineFns.push_back(fn);
+      } else {
+        candidates.push_back(candidate);
+      }
+    }
+  }
+
+  std::sort(candidates.begin(), candidates.end(), heavierCandidate);
+
+  for (size_t i = 0; i < candidates.size(); i++) {
+    int lightest = 0;
+
+    for (int j = 1; j < fParallelCCompile; j++) {
+      if (unitWeights[j] < unitWeights[lightest])
+        lightest = j;
+    }
+
+    unitWeights[lightest] += candidates[i].weight;
+    units[lightest].push_back(candidates[i]);
+  }
+
+  // Within a unit, keep the functions in their original order.
+  for (int i = 0; i < fParallelCCompile; i++) {
+    std::vector<FnSymbol*> fns;
+
+    std::sort(units[i].begin(), units[i].end(), earlierCandidate);
+
+    for (size_t j = 0; j < units[i].size(); j++)
+      fns.push_back(units[i][j].fn);
+
+    codegenUnits.push_back(fns);
+  }
+}
+
+static const char* codegenUnitName(int i) {
+  return astr("chpl__unit", istr(i));
+}
+
+static void codegenFunctionsToFile(const char*                   name,
+                                   const char*                   ext,
+                                   const std::vector<FnSymbol*>& fns) {
+  GenInfo* info = gGenInfo;
+  fileinfo file = { NULL, NULL, NULL };
+
+  openCFile(&file, name, ext);
+  info->cfile = file.fptr;
+
+  if (strcmp(ext, "c") == 0)
+    fprintf(file.fptr, "#include \"chpl__header.h\"\n");
+
+  for_vector(FnSymbol, fn, fns) {
+    ModuleSymbol* mod = fn->getModule();
+
+    info->filename = mod->fname();
+    info->lineno   = mod->linenum();
+
+    fn->codegenDef();
+  }
+
+  flushStatements();
+  closeCFile(&file);
+}
+
+static void codegenParallelUnits() {
+  // Comm IDs are numbered per source file, as ModuleSymbol::codegenDef()
+  // does, but each file is numbered only once since its functions may be
+  // spread over several units.
+  forv_Vec(ModuleSymbol, currentModule, allModules) {
+    if (!(fIncrementalCompilation && currentModule->modTag == MOD_USER))
+      commIDMap[currentModule->fname()] = 0;
+  }
+
+  mysystem("# codegen-ing inline functions",
+           "generating comment for --print-commands option");
+  codegenFunctionsToFile("chpl__inline", "h", headerInlineFns);
+
+  for (size_t i = 0; i < codegenUnits.size(); i++) {
+    const char* name = codegenUnitName(i);
+
+    mysystem(astr("# codegen-ing unit ", name),
+             "generating comment for --print-commands option");
+    codegenFunctionsToFile(name, "c", codegenUnits[i]);
+  }
+}
+
 void codegen(void) {
   if (no_codegen)
     return;
@@ -2311,10 +2522,29 @@ void codegen(void) {
     zlineToFileIfNeeded(rootModule, mainfile.fptr);
     fprintf(mainfile.fptr, "#include \"chpl_str_config.c\"\n");
     fprintf(mainfile.fptr, "#include \"chpl__header.h\"\n");
-    fprintf(mainfile.fptr, "#include \"%s.c\"\n", sCfgFname);
+    if (objectCacheEnabled() == false)
+      fprintf(mainfile.fptr, "#include \"%s.c\"\n", sCfgFname);
     fprintf(mainfile.fptr, "#include \"chpl__defn.c\"\n");
 
-    std::vector<const char*> userFileName;
+    std::vector<const char*>& userFileName = userObjFiles;
+    userFileName.clear();
+
+    // The compilation config records the compile command and directories,
+    // which would make every object cache key unique.  With the cache it is
+    // compiled on its own and never cached.
+    cfgObjFile = NULL;
+    if (objectCacheEnabled()) {
+      cfgObjFile = genIntermediateFilename(sCfgFname);
+      userFileName.push_back(cfgObjFile);
+    }
+
+    if (parallelCCompile()) {
+      partitionCodegenUnits();
+
+      for (int i = 0; i < fParallelCCompile; i++)
+        userFileName.push_back(genIntermediateFilename(codegenUnitName(i)));
+    }
+
     if(fIncrementalCompilation) {
       ChainHashMap<char*, StringHashFns, int> fileNameHashMap;
       forv_Vec(ModuleSymbol, currentModule, allModules) {
@@ -2333,7 +2563,7 @@ void codegen(void) {
       }
     }
 
-    codegen_makefile(&mainfile, NULL, false, userFileName);
+    codegen_makefile(&mainfile, &mainTmpBinName, false, userFileName);
     if (fLibraryCompile && fLibraryMakefile) {
       codegen_library_makefile();
     }
@@ -2388,18 +2618,28 @@ void codegen(void) {
       const char* filename = NULL;
       filename = generateFileName(fileNameHashMap, filename,currentModule->name);
 
+      bool separateModule = fIncrementalCompilation &&
+                            currentModule->modTag == MOD_USER;
+
+      // These functions go into the --parallel-c-compile units instead.
+      if (parallelCCompile() && !separateModule)
+        continue;
+
       fileinfo modulefile;
       openCFile(&modulefile, filename, "c");
       info->cfile = modulefile.fptr;
-      if(fIncrementalCompilation && (currentModule->modTag == MOD_USER))
+      if(separateModule)
         fprintf(modulefile.fptr, "#include \"chpl__header.h\"\n");
       currentModule->codegenDef();
       closeCFile(&modulefile);
 
-      if(!(fIncrementalCompilation && (currentModule->modTag == MOD_USER)))
+      if(!separateModule)
         fprintf(mainfile.fptr, "#include \"%s%s\"\n", filename, ".c");
     }
 
+    if (parallelCCompile())
+      codegenParallelUnits();
+
     fprintf(strconfig.fptr, "#include \"chpl-string.h\"\n");
     fprintf(strconfig.fptr, "chpl_string defaultStringValue=\"\";\n");
 
@@ -2409,6 +2649,10 @@ void codegen(void) {
     info->cfile = hdrfile.fptr;
     codegen_header_addons();
 
+    // The inline functions may use any of the types above.
+    if (parallelCCompile())
+      fprintf(hdrfile.fptr, "#include \"chpl__inline.h\"\n");
+
     closeCFile(&hdrfile);
     fprintf(mainfile.fptr, "/* last line not #include to avoid gcc bug */\n");
     closeCFile(&mainfile);
@@ -2432,11 +2676,36 @@ void makeBinary(void) {
 #endif
   } else {
     const char* makeflags = printSystemCommands ? "-f " : "-s -f ";
+
+    if (parallelCCompile())
+      makeflags = astr("-j", istr(fParallelCCompile), " ", makeflags);
+
     const char* command = astr(astr(CHPL_MAKE, " "),
                                makeflags,
                                getIntermediateDirName(), "/Makefile");
+
+    if (objectCacheEnabled()) {
+      std::vector<GeneratedTU> tus;
+      GeneratedTU main = { astr(getIntermediateDirName(), "/_main.c"),
+                           astr(mainTmpBinName, ".o") };
+
+      tus.push_back(main);
+      for_vector(const char, userObj, userObjFiles) {
+        if (userObj != cfgObjFile) {
+          GeneratedTU tu = { astr(userObj, ".c"), userObj };
+          tus.push_back(tu);
+        }
+      }
+
+      std::string cachedObjs = objectCacheLookup(tus);
+      command = astr(command, " ", cachedObjs.c_str());
+    }
+
     mysystem(command, "compiling generated source");
 
+    if (objectCacheEnabled())
+      objectCacheStore();
+
     if (fLibraryCompile && fLibraryPython) {
       codegen_make_python_module();
     }
@@ -0,0 +1,273 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "objectCache.h"
+
+#include "driver.h"
+#include "files.h"
+#include "misc.h"
+#include "mysystem.h"
+#include "stringutil.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+char fCCacheDir[FILENAME_MAX + 1] = "";
+
+//
+// The cache key hash.  This is not a cryptographic hash; it only has to
+// make accidental collisions between different translation units
+// vanishingly unlikely, so it runs two independent 64-bit multiplicative
+// hashes over the input and uses both as the key.
+//
+class KeyHasher {
+public:
+  KeyHasher() : a(0xcbf29ce484222325ULL), b(0x9e3779b97f4a7c15ULL) { }
+
+  void add(const char* data, size_t len) {
+    const unsigned char* p = (const unsigned char*) data;
+
+    for (size_t i = 0; i < len; i++) {
+      a = (a ^ p[i]) * 0x100000001b3ULL;
+      b = (b ^ p[i]) * 0xff51afd7ed558ccdULL;
+      b ^= b >> 29;
+    }
+  }
+
+  void add(const std::string& s) {
+    // Include the length so that consecutive strings can't run together.
+    size_t len = s.size();
+
+    add((const char*) &len, sizeof(len));
+    add(s.c_str(), len);
+  }
+
+  std::string hex() const {
+    char buf[33];
+
+    snprintf(buf, sizeof(buf), "%016llx%016llx",
+             (unsigned long long) a, (unsigned long long) b);
+
+    return buf;
+  }
+
+private:
+  unsigned long long a;
+  unsigned long long b;
+};
+
+struct CacheEntry {
+  const char* object;
+  std::string key;
+  bool        hit;
+};
+
+static std::vector<CacheEntry> entries;
+
+bool objectCacheEnabled() {
+  return fCCacheDir[0] != '\0' && !llvmCodegen;
+}
+
+// Runs a command and returns its standard output.  Unlike runCommand(),
+// a failing command is not an error; the caller checks 'ok'.
+static std::string readCommand(const std::string& command, bool& ok) {
+  std::string result;
+  char        buffer[4096];
+  FILE*       pipe = popen(command.c_str(), "r");
+
+  if (pipe == NULL) {
+    ok = false;
+    return result;
+  }
+
+  while (size_t n = fread(buffer, 1, sizeof(buffer), pipe))
+    result.append(buffer, n);
+
+  ok = (pclose(pipe) == 0);
+
+  return result;
+}
+
+// Removes every occurrence of the intermediate directory name, which is a
+// new temporary directory for each compile, so that it doesn't change the
+// key.  It shows up in line markers and in __FILE__ expansions.
+static void stripIntDir(std::string& s) {
+  const char* intDir = getIntermediateDirName();
+  size_t      len    = strlen(intDir);
+  size_t      pos    = 0;
+
+  while ((pos = s.find(intDir, pos)) != std::string::npos)
+    s.erase(pos, len);
+}
+
+// Replaces the argument of each "-o" option with a fixed name, so that
+// the name of the object (and so of the executable) doesn't change the key.
+static void stripOutputName(std::string& s) {
+  size_t pos = 0;
+
+  while ((pos = s.find(" -o ", pos)) != std::string::npos) {
+    size_t start = pos + strlen(" -o ");
+    size_t end   = s.find(' ', start);
+
+    s.replace(start, end == std::string::npos ? end : end - start, "OBJ");
+    pos = start;
+  }
+}
+
+// Adds the preprocessed form of a translation unit to the hash.  The
+// output is hashed a line at a time so that a large translation unit
+// doesn't have to be held in memory.
+static bool hashPreprocessed(KeyHasher&         hasher,
+                             const std::string& compileLine,
+                             const char*        source) {
+  std::string command = compileLine + " -E " + source + " 2>/dev/null";
+  FILE*       pipe    = popen(command.c_str(), "r");
+  char*       line    = NULL;
+  size_t      cap     = 0;
+  ssize_t     len     = 0;
+
+  if (pipe == NULL)
+    return false;
+
+  while ((len = getline(&line, &cap, pipe)) >= 0) {
+    std::string s(line, len);
+
+    stripIntDir(s);
+    hasher.add(s.c_str(), s.size());
+  }
+
+  free(line);
+
+  return pclose(pipe) == 0;
+}
+
+static bool copyFile(const char* from, const char* to) {
+  FILE* in  = fopen(from, "rb");
+  FILE* out = NULL;
+  bool  ok  = false;
+  char  buffer[1 << 16];
+
+  if (in != NULL && (out = fopen(to, "wb")) != NULL) {
+    size_t n = 0;
+
+    ok = true;
+
+    while (ok && (n = fread(buffer, 1, sizeof(buffer), in)) > 0)
+      ok = (fwrite(buffer, 1, n, out) == n);
+
+    ok = (ferror(in) == 0) && ok;
+  }
+
+  if (in  != NULL) fclose(in);
+  if (out != NULL) ok = (fclose(out) == 0) && ok;
+
+  return ok;
+}
+
+static std::string cachePath(const std::string& key) {
+  return std::string(fCCacheDir) + "/" + key + ".o";
+}
+
+std::string objectCacheLookup(const std::vector<GeneratedTU>& tus) {
+  std::string makefile = std::string(getIntermediateDirName()) + "/Makefile";
+  std::string command  = std::string(CHPL_MAKE) + " -s -f " + makefile +
+                         " printcompileline";
+  std::string cached;
+  std::string compileLine;
+  std::string ccVersion;
+  bool        ok       = false;
+  int         numHits  = 0;
+
+  entries.clear();
+
+  compileLine = readCommand(command, ok);
+
+  if (ok == false) {
+    USR_WARN("could not get the C compile line, not using --c-cache-dir");
+    return cached;
+  }
+
+  compileLine.erase(compileLine.find_last_not_of("\n\r") + 1);
+
+  // The back-end compiler is the first word of the compile line.
+  ccVersion = readCommand(compileLine.substr(0, compileLine.find(' ')) +
+                          " --version 2>&1", ok);
+
+  ensureDirExists(fCCacheDir, "ensuring --c-cache-dir directory exists");
+
+  for (size_t i = 0; i < tus.size(); i++) {
+    KeyHasher  hasher;
+    CacheEntry entry;
+    std::string line = compileLine;
+
+    stripIntDir(line);
+    stripOutputName(line);
+
+    hasher.add(line);
+    hasher.add(ccVersion);
+
+    entry.object = tus[i].object;
+    entry.hit    = false;
+
+    if (hashPreprocessed(hasher, compileLine, tus[i].source)) {
+      entry.key = hasher.hex();
+
+      if (copyFile(cachePath(entry.key).c_str(), entry.object)) {
+        entry.hit = true;
+        cached   += std::string(cached.empty() ? "" : " ") + entry.object;
+        numHits  += 1;
+      }
+    }
+
+    if (printSystemCommands) {
+      printf("# --c-cache-dir %s: %s\n",
+             entry.hit ? "hit" : "miss", tus[i].source);
+    }
+
+    entries.push_back(entry);
+  }
+
+  if (numHits == 0)
+    return cached;
+
+  return "CHPL_CACHED_OBJS=\"" + cached + "\"";
+}
+
+void objectCacheStore() {
+  for (size_t i = 0; i < entries.size(); i++) {
+    const CacheEntry& entry = entries[i];
+
+    if (entry.hit || entry.key.empty())
+      continue;
+
+    // Write to a private name first and rename it into place, so that a
+    // compile running concurrently never sees a partial object.
+    std::string path = cachePath(entry.key);
+    std::string tmp  = path + "." + istr(getpid()) + ".tmp";
+
+    if (copyFile(entry.object, tmp.c_str()) == false ||
+        rename(tmp.c_str(), path.c_str()) != 0) {
+      unlink(tmp.c_str());
+    }
+  }
+
+  entries.clear();
+}
@@ -578,7 +578,7 @@ void VarSymbol::codegenDefC(bool global, bool isHeader) {
   //
   std::string str;
 
-  if(fIncrementalCompilation || (this->hasFlag(FLAG_EXTERN) &&
+  if(codegenSeparateTUs() || (this->hasFlag(FLAG_EXTERN) &&
                                  this->hasFlag(FLAG_GENERATE_SIGNATURE))) {
     bool addExtern =  global && isHeader;
     str = (addExtern ? "extern " : "") + typestr + " " + cname;
@@ -1432,7 +1432,9 @@ void FnSymbol::codegenHeaderC(void) {
   if (fGenIDS)
     fprintf(outfile, "%s", idCommentTemp(this));
 
-  if (!fIncrementalCompilation && !hasFlag(FLAG_EXPORT) && !hasFlag(FLAG_EXTERN)) {
+  if (hasFlag(FLAG_CODEGEN_IN_HEADER)) {
+    fprintf(outfile, "static inline ");
+  } else if (!codegenSeparateTUs() && !hasFlag(FLAG_EXPORT) && !hasFlag(FLAG_EXTERN)) {
     fprintf(outfile, "static ");
   }
   fprintf(outfile, "%s", codegenFunctionType(true).c.c_str());
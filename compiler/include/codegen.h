@@ -152,6 +152,11 @@ const char* idCommentTemp(BaseAST* ast);
 void genComment(const char* comment, bool push=false);
 void flushStatements(void);
 
+// True if the generated code is compiled as more than one translation unit
+// (--incremental or --parallel-c-compile), so that functions and globals
+// need external linkage.
+bool codegenSeparateTUs();
+
 void registerPrimitiveCodegens();
 
 #endif //CODEGEN_H
@@ -34,6 +34,7 @@ extern int  instantiation_limit;
 // optimization control flags
 extern bool fFastFlag;
 extern bool fNoBoundsChecks;
+extern bool fNoCopyElision;
 extern bool fNoCopyPropagation;
 extern bool fNoDeadCodeElimination;
 extern bool fNoGlobalConstOpt;
@@ -118,6 +119,7 @@ extern const char* CHPL_LAUNCHER_SUBDIR;
 
 extern bool  printPasses;
 extern FILE* printPassesFile;
+extern FILE* printPassStatsFile;
 
 extern char fExplainCall[256];
 extern int  explainCallID;
@@ -146,6 +148,7 @@ extern bool fOverrideChecking;
 extern bool fHeterogeneous;
 extern int  ffloatOpt;
 extern int  fMaxCIdentLen;
+extern int  fParallelCCompile;
 
 extern bool llvmCodegen;
 
@@ -193,7 +196,10 @@ extern bool fReportInlinedIterators;
 extern bool fReportOrderIndependentLoops;
 extern bool fReportOptimizedOn;
 extern bool fReportPromotion;
+extern bool fReportResolutionCandidates;
 extern bool fReportScalarReplace;
+extern bool fReportElidedCopies;
+extern bool fReportHoistedInvariants;
 extern bool fReportDeadBlocks;
 extern bool fReportDeadModules;
 
@@ -227,6 +233,12 @@ extern bool fIncrementalCompilation;
 // Interactive Programming Environment (IPE) mode.
 extern bool fUseIPE;
 
+// Set to false to run IPE procedures with the tree-walking evaluator only.
+extern bool fIpeBytecode;
+
+// Set to false to keep every standard module function through resolution.
+extern bool fPruneStandardFunctions;
+
 // LLVM flags (-mllvm)
 extern std::string llvmFlags;
 
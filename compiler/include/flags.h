@@ -66,6 +66,7 @@ Flag pragma2flag(const char* str);
 void initFlags();
 void viewFlags(BaseAST* sym);
 void writeFlags(FILE* fp, Symbol* sym);
+bool hasPragmaFlag(Symbol* sym);
 TypeSymbol* getDataClassType(TypeSymbol* ts);
 void setDataClassType(TypeSymbol* ts, TypeSymbol* ets);
 
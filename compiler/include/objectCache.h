@@ -0,0 +1,51 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _OBJECT_CACHE_H_
+#define _OBJECT_CACHE_H_
+
+#include <string>
+#include <vector>
+
+//
+// A persistent cache of the object files compiled from the generated C
+// code (see --c-cache-dir).
+//
+// Each translation unit is keyed by a hash of its preprocessed source, the
+// back-end compile command and the back-end compiler version.  Before the
+// generated Makefile runs, objects found in the cache are copied into
+// place and the returned make variable assignment tells the Makefile not
+// to rebuild them.  After a successful build the remaining objects are
+// added to the cache.
+//
+
+extern char fCCacheDir[];
+
+struct GeneratedTU {
+  const char* source;
+  const char* object;
+};
+
+bool        objectCacheEnabled();
+
+std::string objectCacheLookup(const std::vector<GeneratedTU>& tus);
+
+void        objectCacheStore();
+
+#endif
@@ -140,6 +140,9 @@ Type* getOrMakeRefTypeDuringCodegen(Type* type);
 Type* getOrMakeWideTypeDuringCodegen(Type* refType);
 CallExpr* findDownEndCount(FnSymbol* fn);
 
+// pruneStandardFunctions.cpp
+void pruneStandardFunctions();
+
 // resolution
 Expr*     resolveExpr(Expr* expr);
 
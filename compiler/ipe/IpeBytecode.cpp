@@ -0,0 +1,1394 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "IpeBytecode.h"
+
+#include "expr.h"
+#include "IpeCallExpr.h"
+#include "IpeDefExpr.h"
+#include "IpeEnv.h"
+#include "IpeMethod.h"
+#include "IpeProcedure.h"
+#include "IpeSequence.h"
+#include "IpeValue.h"
+
+#include "ipeDriver.h"
+#include "ipeEvaluate.h"
+
+#include "misc.h"
+#include "stmt.h"
+#include "symbol.h"
+#include "type.h"
+#include "WhileDoStmt.h"
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+
+/************************************ | *************************************
+*                                                                           *
+* Every register is 8 bytes, the same as an IpeValue.  The registers for    *
+* every active invocation are allocated from a single fixed stack so that   *
+* the address of a register, which is passed for a ref formal, is stable.   *
+*                                                                           *
+************************************* | ************************************/
+
+union IpeReg
+{
+  long   i;
+  double r;
+  void*  p;
+};
+
+static const int kStackSize  = 1 << 16;
+static const int kMaxActuals =      16;
+static const int kMaxInline  =      16;
+
+static IpeReg    sStack[kStackSize];
+static int       sStackTop   =       0;
+
+/************************************ | *************************************
+*                                                                           *
+* Translate resolved IPE code to bytecode.  Anything the translator does    *
+* not understand makes the whole compilation fail, and the caller falls     *
+* back to the tree-walking evaluator.                                       *
+*                                                                           *
+************************************* | ************************************/
+
+class IpeBytecodeCompiler
+{
+public:
+                           IpeBytecodeCompiler(IpeBytecode* code,
+                                               IpeEnv*      env,
+                                               int          depth);
+
+  bool                     stmt(Expr* expr);
+  void                     finish();
+
+private:
+  enum OperandKind
+  {
+    kValue,
+    kAddrReg,
+    kAddrGlobal
+  };
+
+  struct Operand
+  {
+    OperandKind            kind;
+    int                    reg;
+    void*                  ptr;
+  };
+
+  // The operands for the formals of an inlined procedure
+  typedef std::map<Symbol*, Operand> Subst;
+
+  bool                     expr    (Expr*        expr,  Subst* subst, int& reg);
+  bool                     symbol  (SymExpr*     expr,  Subst* subst, int& reg);
+  bool                     operand (Expr*        expr,  Subst* subst, Operand& op);
+  bool                     call    (IpeCallExpr* expr,  Subst* subst, int& reg);
+  bool                     inlineCall(IpeMethod*   callee,
+                                      IpeCallExpr* expr,
+                                      Subst*       subst,
+                                      int&         reg);
+  bool                     prim    (IpeCallExpr* expr,  Subst* subst, int& reg);
+
+  bool                     shouldInline(IpeMethod* callee)                     const;
+
+  bool                     isLocal(LcnSymbol* sym)                             const;
+  bool                     isValueType(Type* type)                             const;
+  void*                    globalAddr(LcnSymbol* sym)                          const;
+
+  int                      temp();
+  int                      constant(IpeValue value);
+  int                      label()                                             const;
+  void                     bind();
+  void                     patch(int at, int target);
+
+  void                     move(int dst, int src);
+  void                     emit(int op, int a, int b = 0, int c = 0, void* ptr = NULL);
+
+  static bool              writesA(int op);
+
+  IpeBytecode*             mCode;
+  IpeEnv*                  mEnv;
+  int                      mDepth;
+  int                      mInlineDepth;
+  int                      mLastLabel;
+  std::vector<bool>        mIsTemp;
+};
+
+static bool     isScopeless(BlockStmt* stmt);
+static Expr*    singleStmt(BlockStmt* stmt);
+static bool     isType(Type* type, const char* name);
+static bool     immediateValue(VarSymbol* var, IpeValue& value);
+
+IpeBytecodeCompiler::IpeBytecodeCompiler(IpeBytecode* code,
+                                         IpeEnv*      env,
+                                         int          depth)
+{
+  mCode        = code;
+  mEnv         = env;
+  mDepth       = depth;
+  mInlineDepth = 0;
+  mLastLabel   = -1;
+
+  mIsTemp.resize(code->mNumRegs, false);
+}
+
+void IpeBytecodeCompiler::finish()
+{
+  emit(IpeBytecode::kReturnVoid, 0);
+}
+
+/************************************ | *************************************
+*                                                                           *
+* Statements                                                                *
+*                                                                           *
+************************************* | ************************************/
+
+bool IpeBytecodeCompiler::stmt(Expr* expr)
+{
+  bool retval = false;
+
+  if      (DefExpr*     sel = toDefExpr(expr))
+  {
+    IpeDefExpr* defExpr = (IpeDefExpr*) sel;
+    VarSymbol*  var     = toVarSymbol(defExpr->sym);
+    int         src     = -1;
+
+    if (defExpr->moduleSymbolGet() != NULL || defExpr->fnSymbolGet() != NULL)
+      retval = false;
+
+    else if (var == NULL || isLocal(var) == false)
+      retval = false;
+
+    else if (defExpr->init != NULL)
+    {
+      retval = this->expr(defExpr->init, NULL, src) && src >= 0;
+    }
+
+    else
+    {
+      VarSymbol* defaultValue = toVarSymbol(var->type->defaultValue);
+      IpeValue   value;
+
+      if (defaultValue                        != NULL &&
+          defaultValue->isImmediate()         == true &&
+          immediateValue(defaultValue, value) == true)
+      {
+        src    = constant(value);
+        retval = true;
+      }
+    }
+
+    if (retval == true)
+      move(var->offset() / 8, src);
+  }
+
+  else if (CondStmt*    sel = toCondStmt(expr))
+  {
+    int cond = -1;
+
+    if (this->expr(sel->condExpr, NULL, cond) == true && cond >= 0)
+    {
+      int jumpElse = label();
+
+      emit(IpeBytecode::kJumpFalse, cond, -1);
+
+      retval = stmt(sel->thenStmt);
+
+      if (retval == true && sel->elseStmt != NULL)
+      {
+        int jumpEnd = label();
+
+        emit(IpeBytecode::kJump, -1);
+
+        patch(jumpElse, label());
+        bind();
+
+        retval = stmt(sel->elseStmt);
+
+        patch(jumpEnd, label());
+        bind();
+      }
+
+      else
+      {
+        patch(jumpElse, label());
+        bind();
+      }
+    }
+  }
+
+  // The condition is tested at the bottom so that each iteration
+  // executes a single branch
+  else if (WhileDoStmt* sel = toWhileDoStmt(expr))
+  {
+    int jumpCond = label();
+    int top      = -1;
+    int cond     = -1;
+
+    emit(IpeBytecode::kJump, -1);
+
+    top = label();
+    bind();
+
+    retval = true;
+
+    for (int i = 1; i <= sel->body.length && retval == true; i++)
+      retval = stmt(sel->body.get(i));
+
+    if (retval == true)
+    {
+      patch(jumpCond, label());
+      bind();
+
+      retval = this->expr(sel->condExprGet(), NULL, cond) && cond >= 0;
+
+      if (retval == true)
+        emit(IpeBytecode::kJumpTrue, cond, top);
+    }
+  }
+
+  else if (BlockStmt*   sel = toBlockStmt(expr))
+  {
+    retval = isScopeless(sel);
+
+    for (int i = 1; i <= sel->body.length && retval == true; i++)
+      retval = stmt(sel->body.get(i));
+  }
+
+  else if (CallExpr*    sel = toCallExpr(expr))
+  {
+    IpeCallExpr* callExpr = (IpeCallExpr*) sel;
+    int          reg      = -1;
+
+    if (callExpr->isPrimitive(PRIM_RETURN) == true)
+    {
+      if (callExpr->numActuals() == 1)
+      {
+        retval = this->expr(callExpr->get(1), NULL, reg) && reg >= 0;
+
+        if (retval == true)
+          emit(IpeBytecode::kReturn, reg);
+      }
+    }
+
+    else
+    {
+      retval = this->expr(callExpr, NULL, reg);
+    }
+  }
+
+  return retval;
+}
+
+/************************************ | *************************************
+*                                                                           *
+* Expressions.  The register holding the value is returned in 'reg', or -1  *
+* if the expression has no value.  'subst' is NULL unless the expression    *
+* is the body of an inlined procedure.                                      *
+*                                                                           *
+************************************* | ************************************/
+
+bool IpeBytecodeCompiler::expr(Expr* expr, Subst* subst, int& reg)
+{
+  bool retval = false;
+
+  reg = -1;
+
+  if      (SymExpr*  sel = toSymExpr(expr))
+    retval = symbol(sel, subst, reg);
+
+  else if (CallExpr* sel = toCallExpr(expr))
+  {
+    IpeCallExpr* callExpr = (IpeCallExpr*) sel;
+
+    if (callExpr->baseExpr != NULL)
+      retval = call(callExpr, subst, reg);
+    else
+      retval = prim(callExpr, subst, reg);
+  }
+
+  return retval;
+}
+
+bool IpeBytecodeCompiler::symbol(SymExpr* symExpr, Subst* subst, int& reg)
+{
+  Symbol*    sym    = symExpr->symbol();
+  VarSymbol* var    = toVarSymbol(sym);
+  LcnSymbol* lcn    = toLcnSymbol(sym);
+  bool       retval = false;
+
+  if (var != NULL && var->isImmediate() == true)
+  {
+    IpeValue value;
+
+    if (immediateValue(var, value) == true)
+    {
+      reg    = constant(value);
+      retval = true;
+    }
+  }
+
+  else if (subst != NULL && subst->count(sym) > 0)
+  {
+    Operand& op = (*subst)[sym];
+
+    // The tree-walker yields the address held by a ref formal, not its value
+    if (op.kind == kValue)
+    {
+      reg    = op.reg;
+      retval = true;
+    }
+  }
+
+  else if (lcn == NULL || isValueType(lcn->type) == false)
+    retval = false;
+
+  else if (subst == NULL && isLocal(lcn) == true)
+  {
+    ArgSymbol* arg = toArgSymbol(lcn);
+
+    if (arg == NULL || (arg->intent & INTENT_REF) == 0)
+    {
+      reg    = lcn->offset() / 8;
+      retval = true;
+    }
+  }
+
+  else if (void* addr = globalAddr(lcn))
+  {
+    reg    = temp();
+    retval = true;
+
+    emit(IpeBytecode::kLoadGlobal, reg, 0, 0, addr);
+  }
+
+  return retval;
+}
+
+// An actual for an inlined or out-of-line call.  The actual for a ref
+// formal is always PRIM_ADDR_OF a variable.
+bool IpeBytecodeCompiler::operand(Expr* actual, Subst* subst, Operand& op)
+{
+  IpeCallExpr* callExpr = (IpeCallExpr*) toCallExpr(actual);
+  bool         retval   = false;
+
+  op.kind = kValue;
+  op.reg  =     -1;
+  op.ptr  =   NULL;
+
+  if (callExpr != NULL && callExpr->isPrimitive(PRIM_ADDR_OF) == true)
+  {
+    SymExpr*   symExpr = toSymExpr(callExpr->get(1));
+    Symbol*    sym     = (symExpr != NULL) ? symExpr->symbol() : NULL;
+    LcnSymbol* lcn     = toLcnSymbol(sym);
+
+    if      (sym == NULL)
+      retval = false;
+
+    else if (subst != NULL && subst->count(sym) > 0)
+    {
+      op     = (*subst)[sym];
+      retval = (op.kind != kValue) ? true : false;
+    }
+
+    else if (lcn == NULL || isValueType(lcn->type) == false)
+      retval = false;
+
+    else if (subst == NULL && isLocal(lcn) == true)
+    {
+      ArgSymbol* arg = toArgSymbol(lcn);
+
+      if (arg == NULL || (arg->intent & INTENT_REF) == 0)
+      {
+        op.kind = kAddrReg;
+        op.reg  = lcn->offset() / 8;
+        retval  = true;
+      }
+    }
+
+    else if (void* addr = globalAddr(lcn))
+    {
+      op.kind = kAddrGlobal;
+      op.ptr  = addr;
+      retval  = true;
+    }
+  }
+
+  else
+  {
+    retval = expr(actual, subst, op.reg) && op.reg >= 0;
+  }
+
+  return retval;
+}
+
+bool IpeBytecodeCompiler::call(IpeCallExpr* callExpr, Subst* subst, int& reg)
+{
+  SymExpr*      symExpr   = toSymExpr(callExpr->baseExpr);
+  VarSymbol*    var       = (symExpr != NULL) ? toVarSymbol(symExpr->symbol()) : NULL;
+  IpeProcedure* procedure = NULL;
+  IpeMethod*    callee    = NULL;
+  int           numArgs   = callExpr->numActuals();
+  bool          retval    = false;
+
+  if (var                        != NULL              &&
+      var->type                  == gIpeTypeProcedure &&
+      var->depth()               == 0                 &&
+      var->offset()              >= 0                 &&
+      numArgs                    <= kMaxActuals)
+  {
+    procedure = (IpeProcedure*) mEnv->fetchPtr(var);
+
+    if (procedure != NULL &&
+        procedure->isValid(callExpr->procedureGeneration()) == true)
+      callee = procedure->methodGet(callExpr->methodId());
+  }
+
+  if      (callee == NULL)
+    retval = false;
+
+  else if (shouldInline(callee) == true)
+    retval = inlineCall(callee, callExpr, subst, reg);
+
+  else
+  {
+    int base = (numArgs > 0) ? temp() : 0;
+
+    for (int i = 1; i < numArgs; i++)
+      temp();
+
+    retval = true;
+
+    for (int i = 0; i < numArgs && retval == true; i++)
+    {
+      Operand op;
+
+      retval = operand(callExpr->get(i + 1), subst, op);
+
+      if      (retval  == false)
+        ;
+
+      else if (op.kind == kValue)
+        move(base + i, op.reg);
+
+      else if (op.kind == kAddrReg)
+        emit(IpeBytecode::kAddrOf, base + i, op.reg);
+
+      else
+        move(base + i, constant(IpeValue((IpeValue*) op.ptr)));
+    }
+
+    if (retval == true)
+    {
+      IpeBytecode::CallSite* site = new IpeBytecode::CallSite;
+
+      site->procedure = procedure;
+      site->methodId  = callExpr->methodId();
+      site->method    = callee;
+      site->code      = NULL;
+      site->resolved  = false;
+
+      mCode->mCallSites.push_back(site);
+
+      reg = temp();
+
+      emit(IpeBytecode::kCall, reg, base, numArgs, site);
+    }
+  }
+
+  return retval;
+}
+
+bool IpeBytecodeCompiler::shouldInline(IpeMethod* callee) const
+{
+  FnSymbol* fn     = callee->fnSymbol();
+  bool      retval = false;
+
+  if (fn->hasFlag(FLAG_INLINE)  == true  &&
+      fn->hasFlag(FLAG_EXTERN)  == false &&
+      mInlineDepth              <  kMaxInline &&
+      callee->resolveBody()     == true)
+  {
+    CallExpr* callExpr = toCallExpr(singleStmt(callee->bodyGet()));
+
+    retval = (callExpr != NULL && callExpr->baseExpr == NULL) ? true : false;
+  }
+
+  return retval;
+}
+
+bool IpeBytecodeCompiler::inlineCall(IpeMethod*   callee,
+                                     IpeCallExpr* callExpr,
+                                     Subst*       subst,
+                                     int&         reg)
+{
+  Subst calleeSubst;
+  bool  retval = true;
+
+  for (int i = 1; i <= callExpr->numActuals() && retval == true; i++)
+  {
+    Operand op;
+
+    retval = operand(callExpr->get(i), subst, op);
+
+    if (retval == true)
+      calleeSubst[callee->formalGet(i - 1)] = op;
+  }
+
+  if (retval == true)
+  {
+    mInlineDepth = mInlineDepth + 1;
+
+    retval = expr(singleStmt(callee->bodyGet()), &calleeSubst, reg);
+
+    mInlineDepth = mInlineDepth - 1;
+  }
+
+  return retval;
+}
+
+bool IpeBytecodeCompiler::prim(IpeCallExpr* callExpr, Subst* subst, int& reg)
+{
+  bool retval = false;
+
+  if      (callExpr->isPrimitive(PRIM_ADDR_OF) == true)
+  {
+    Operand op;
+
+    if (operand(callExpr, subst, op) == true)
+    {
+      if (op.kind == kAddrReg)
+      {
+        reg = temp();
+        emit(IpeBytecode::kAddrOf, reg, op.reg);
+      }
+      else
+      {
+        reg = constant(IpeValue((IpeValue*) op.ptr));
+      }
+
+      retval = true;
+    }
+  }
+
+  else if (callExpr->isPrimitive(PRIM_ASSIGN) == true)
+  {
+    SymExpr* dstExpr = toSymExpr(callExpr->get(1));
+    Symbol*  dst     = (dstExpr != NULL) ? dstExpr->symbol() : NULL;
+    int      src     = -1;
+
+    if (dst != NULL && expr(callExpr->get(2), subst, src) == true && src >= 0)
+    {
+      if (subst != NULL && subst->count(dst) > 0)
+      {
+        Operand& op = (*subst)[dst];
+
+        if      (op.kind == kAddrReg)
+        {
+          move(op.reg, src);
+          retval = true;
+        }
+
+        else if (op.kind == kAddrGlobal)
+        {
+          emit(IpeBytecode::kStoreGlobal, src, 0, 0, op.ptr);
+          retval = true;
+        }
+      }
+
+      else if (subst == NULL && isLocal(toLcnSymbol(dst)) == true)
+      {
+        ArgSymbol* arg = toArgSymbol(dst);
+
+        if (arg != NULL && (arg->intent & INTENT_REF) != 0)
+        {
+          emit(IpeBytecode::kStoreRef, arg->offset() / 8, src);
+          retval = true;
+        }
+      }
+    }
+  }
+
+  else if (callExpr->isPrimitive(PRIM_UNARY_MINUS) == true)
+  {
+    Type* type = callExpr->typeInfo();
+    int   arg  = -1;
+
+    if (expr(callExpr->get(1), subst, arg) == true && arg >= 0)
+    {
+      if      (isType(type, "int")  == true)
+      {
+        reg    = temp();
+        retval = true;
+
+        emit(IpeBytecode::kNegInt,  reg, arg);
+      }
+
+      else if (isType(type, "real") == true)
+      {
+        reg    = temp();
+        retval = true;
+
+        emit(IpeBytecode::kNegReal, reg, arg);
+      }
+    }
+  }
+
+  else if (callExpr->isPrimitive(PRIM_RETURN) == true)
+  {
+    // The body of an inlined procedure
+    if (callExpr->numActuals() == 1)
+      retval = expr(callExpr->get(1), subst, reg);
+  }
+
+  else
+  {
+    int   opInt  = -1;
+    int   opReal = -1;
+    int   opBool = -1;
+    Type* type   = NULL;
+
+    if      (callExpr->isPrimitive(PRIM_ADD)            == true)
+    {
+      opInt = IpeBytecode::kAddInt; opReal = IpeBytecode::kAddReal;
+    }
+
+    else if (callExpr->isPrimitive(PRIM_SUBTRACT)       == true)
+    {
+      opInt = IpeBytecode::kSubInt; opReal = IpeBytecode::kSubReal;
+    }
+
+    else if (callExpr->isPrimitive(PRIM_MULT)           == true)
+    {
+      opInt = IpeBytecode::kMulInt; opReal = IpeBytecode::kMulReal;
+    }
+
+    else if (callExpr->isPrimitive(PRIM_DIV)            == true)
+    {
+      opInt = IpeBytecode::kDivInt; opReal = IpeBytecode::kDivReal;
+    }
+
+    else if (callExpr->isPrimitive(PRIM_EQUAL)          == true)
+    {
+      opInt  = IpeBytecode::kEqInt; opReal = IpeBytecode::kEqReal;
+      opBool = IpeBytecode::kEqInt;
+    }
+
+    else if (callExpr->isPrimitive(PRIM_NOTEQUAL)       == true)
+    {
+      opInt  = IpeBytecode::kNeInt; opReal = IpeBytecode::kNeReal;
+      opBool = IpeBytecode::kNeInt;
+    }
+
+    else if (callExpr->isPrimitive(PRIM_LESS)           == true)
+    {
+      opInt = IpeBytecode::kLtInt;  opReal = IpeBytecode::kLtReal;
+    }
+
+    else if (callExpr->isPrimitive(PRIM_GREATER)        == true)
+    {
+      opInt = IpeBytecode::kGtInt;  opReal = IpeBytecode::kGtReal;
+    }
+
+    else if (callExpr->isPrimitive(PRIM_LESSOREQUAL)    == true)
+    {
+      opInt = IpeBytecode::kLeInt;  opReal = IpeBytecode::kLeReal;
+    }
+
+    else if (callExpr->isPrimitive(PRIM_GREATEROREQUAL) == true)
+    {
+      opInt = IpeBytecode::kGeInt;  opReal = IpeBytecode::kGeReal;
+    }
+
+    // As in evaluatePrim(), arithmetic is typed by the result and
+    // comparisons are typed by the first operand
+    if (opInt >= 0 && callExpr->numActuals() == 2)
+    {
+      int arg1 = -1;
+      int arg2 = -1;
+      int op   = -1;
+
+      if (opInt >= IpeBytecode::kEqInt)
+        type = callExpr->get(1)->typeInfo();
+      else
+        type = callExpr->typeInfo();
+
+      if      (isType(type, "int")  == true)
+        op = opInt;
+
+      else if (isType(type, "real") == true)
+        op = opReal;
+
+      else if (isType(type, "bool") == true)
+        op = opBool;
+
+      if (op                                     >= 0    &&
+          expr(callExpr->get(1), subst, arg1)    == true &&
+          arg1                                   >= 0    &&
+          expr(callExpr->get(2), subst, arg2)    == true &&
+          arg2                                   >= 0)
+      {
+        reg    = temp();
+        retval = true;
+
+        emit(op, reg, arg1, arg2);
+      }
+    }
+  }
+
+  return retval;
+}
+
+/************************************ | *************************************
+*                                                                           *
+*                                                                           *
+*                                                                           *
+************************************* | ************************************/
+
+bool IpeBytecodeCompiler::isLocal(LcnSymbol* sym) const
+{
+  bool retval = false;
+
+  if (sym != NULL && mCode->mMethod != NULL && sym->depth() == mDepth)
+  {
+    int offset = sym->offset();
+
+    retval = (offset >= 0 && offset / 8 < mCode->mNumLocals) ? true : false;
+  }
+
+  return retval;
+}
+
+bool IpeBytecodeCompiler::isValueType(Type* type) const
+{
+  return (type == dtBools[BOOL_SIZE_SYS] ||
+          type == dtBool                 ||
+          type == dtInt[INT_SIZE_64]     ||
+          type == dtReal[FLOAT_SIZE_64]  ||
+          type == dtStringC) ? true : false;
+}
+
+// The module store is never reallocated, so the address of a module
+// level variable can be bound when the code is compiled
+void* IpeBytecodeCompiler::globalAddr(LcnSymbol* sym) const
+{
+  void* retval = NULL;
+
+  if (sym->depth() == 0 && sym->offset() >= 0)
+    retval = mEnv->addrOf(sym).refGet();
+
+  return retval;
+}
+
+int IpeBytecodeCompiler::temp()
+{
+  int retval = mCode->mNumRegs;
+
+  mCode->mNumRegs = mCode->mNumRegs + 1;
+  mIsTemp.push_back(true);
+
+  return retval;
+}
+
+int IpeBytecodeCompiler::constant(IpeValue value)
+{
+  std::vector<IpeBytecode::Constant>& constants = mCode->mConstants;
+  int                                 retval    = -1;
+
+  for (size_t i = 0; i < constants.size() && retval < 0; i++)
+  {
+    if (memcmp(&constants[i].value, &value, sizeof(IpeValue)) == 0)
+      retval = constants[i].reg;
+  }
+
+  if (retval < 0)
+  {
+    IpeBytecode::Constant constant;
+
+    retval          = mCode->mNumRegs;
+
+    constant.reg    = retval;
+    constant.value  = value;
+
+    mCode->mNumRegs = mCode->mNumRegs + 1;
+    mIsTemp.push_back(false);
+
+    constants.push_back(constant);
+  }
+
+  return retval;
+}
+
+int IpeBytecodeCompiler::label() const
+{
+  return (int) mCode->mCode.size();
+}
+
+// Note that a jump may arrive at the next instruction
+void IpeBytecodeCompiler::bind()
+{
+  mLastLabel = label();
+}
+
+void IpeBytecodeCompiler::patch(int at, int target)
+{
+  IpeBytecode::Instr& instr = mCode->mCode[at];
+
+  if (instr.op == IpeBytecode::kJump)
+    instr.a = target;
+  else
+    instr.b = target;
+}
+
+// A value is usually computed into a fresh temporary and then moved.
+// When that temporary was written by the previous instruction, write
+// the destination directly instead.
+void IpeBytecodeCompiler::move(int dst, int src)
+{
+  std::vector<IpeBytecode::Instr>& code = mCode->mCode;
+
+  if (dst == src)
+    ;
+
+  else if (code.empty()          == false     &&
+           mIsTemp[src]          == true      &&
+           mLastLabel            != label()   &&
+           writesA(code.back().op)            &&
+           code.back().a         == src)
+    code.back().a = dst;
+
+  else
+    emit(IpeBytecode::kMove, dst, src);
+}
+
+void IpeBytecodeCompiler::emit(int op, int a, int b, int c, void* ptr)
+{
+  IpeBytecode::Instr instr;
+
+  instr.op  = op;
+  instr.a   = a;
+  instr.b   = b;
+  instr.c   = c;
+  instr.ptr = ptr;
+
+  mCode->mCode.push_back(instr);
+}
+
+// A CondStmt wraps a resolved branch in a plain BlockStmt, which the
+// evaluator runs in the enclosing environment
+static bool isScopeless(BlockStmt* stmt)
+{
+  IpeSequence* seq = dynamic_cast<IpeSequence*>(stmt);
+
+  return (seq != NULL) ? seq->isScopeless() : true;
+}
+
+// The only statement in a block, looking through nested blocks
+static Expr* singleStmt(BlockStmt* stmt)
+{
+  Expr* retval = NULL;
+
+  if (stmt->body.length == 1 && isScopeless(stmt) == true)
+  {
+    retval = stmt->body.get(1);
+
+    if (BlockStmt* block = toBlockStmt(retval))
+      retval = (isWhileDoStmt(block) == true) ? NULL : singleStmt(block);
+  }
+
+  return retval;
+}
+
+static bool isType(Type* type, const char* name)
+{
+  return (type                       != NULL &&
+          type->symbol               != NULL &&
+          strcmp(type->symbol->name, name) == 0) ? true : false;
+}
+
+static bool immediateValue(VarSymbol* var, IpeValue& value)
+{
+  Immediate* imm    = var->immediate;
+  Type*      type   = var->type;
+  bool       retval = true;
+
+  if      (isType(type, "bool")     == true)
+    value.boolSet(imm->v_bool);
+
+  else if (isType(type, "int")      == true)
+    value.integerSet(imm->v_int64);
+
+  else if (isType(type, "real")     == true)
+    value.realSet(imm->v_float64);
+
+  else if (isType(type, "c_string") == true)
+    value.cstringSet(imm->v_string);
+
+  else
+    retval = false;
+
+  return retval;
+}
+
+bool IpeBytecodeCompiler::writesA(int op)
+{
+  bool retval = true;
+
+  switch (op)
+  {
+    case IpeBytecode::kStoreGlobal:
+    case IpeBytecode::kStoreRef:
+    case IpeBytecode::kJump:
+    case IpeBytecode::kJumpFalse:
+    case IpeBytecode::kJumpTrue:
+    case IpeBytecode::kReturn:
+    case IpeBytecode::kReturnVoid:
+      retval = false;
+      break;
+
+    default:
+      break;
+  }
+
+  return retval;
+}
+
+/************************************ | *************************************
+*                                                                           *
+*                                                                           *
+*                                                                           *
+************************************* | ************************************/
+
+IpeBytecode* IpeBytecode::compile(IpeMethod* method)
+{
+  FnSymbol*    fn     = method->fnSymbol();
+  IpeBytecode* retval = NULL;
+
+  if (fn->hasFlag(FLAG_EXTERN)  == false &&
+      fn->formals.length        <= kMaxActuals &&
+      method->resolveBody()     == true)
+  {
+    IpeEnv*             env      = method->envParentGet();
+    IpeSequence*        body     = method->bodyGet();
+    IpeBytecode*        code     = new IpeBytecode(method);
+    bool                ok       = true;
+
+    code->mNumFormals = fn->formals.length;
+    code->mNumLocals  = method->frameSize() / 8;
+    code->mNumRegs    = code->mNumLocals;
+
+    IpeBytecodeCompiler compiler(code, env, env->depth() + 1);
+
+    for (int i = 1; i <= body->body.length && ok == true; i++)
+      ok = compiler.stmt(body->body.get(i));
+
+    if (ok == true)
+    {
+      compiler.finish();
+      retval = code;
+    }
+
+    else
+      delete code;
+  }
+
+  return retval;
+}
+
+IpeBytecode* IpeBytecode::compile(Expr* stmt, IpeEnv* env)
+{
+  IpeBytecode* retval = NULL;
+
+  if (isWhileDoStmt(stmt) == true && env->depth() == 0)
+  {
+    IpeBytecode*        code = new IpeBytecode(NULL);
+    IpeBytecodeCompiler compiler(code, env, 0);
+
+    if (compiler.stmt(stmt) == true)
+    {
+      compiler.finish();
+      retval = code;
+    }
+
+    else
+      delete code;
+  }
+
+  return retval;
+}
+
+IpeBytecode::IpeBytecode(IpeMethod* method)
+{
+  INT_ASSERT(sizeof(IpeValue) == sizeof(IpeReg));
+
+  mMethod     = method;
+  mNumFormals = 0;
+  mNumLocals  = 0;
+  mNumRegs    = 0;
+}
+
+IpeBytecode::~IpeBytecode()
+{
+  for (size_t i = 0; i < mCallSites.size(); i++)
+    delete mCallSites[i];
+}
+
+IpeValue IpeBytecode::apply(IpeCallExpr* callExpr, IpeEnv* callingEnv)
+{
+  IpeValue actuals[kMaxActuals];
+  int      count = callExpr->numActuals();
+
+  INT_ASSERT(count <= kMaxActuals);
+
+  // Evaluate the actuals in the calling environment
+  for (int i = 0; i < count; i++)
+    actuals[i] = evaluateExpr(callExpr->get(i + 1), callingEnv);
+
+  return invoke(actuals, count);
+}
+
+IpeValue IpeBytecode::execute()
+{
+  return invoke(NULL, 0);
+}
+
+IpeValue IpeBytecode::invoke(const void* actuals, int count)
+{
+  IpeReg*  regs   = sStack + sStackTop;
+  IpeValue retval;
+
+  if (sStackTop + mNumRegs > kStackSize)
+    USR_FATAL("IPE stack overflow");
+
+  if (count > 0)
+    memcpy(regs, actuals, count * sizeof(IpeReg));
+
+  if (mNumLocals > count)
+    memset(regs + count, 0, (mNumLocals - count) * sizeof(IpeReg));
+
+  for (size_t i = 0; i < mConstants.size(); i++)
+    memcpy(regs + mConstants[i].reg, &mConstants[i].value, sizeof(IpeReg));
+
+  sStackTop = sStackTop + mNumRegs;
+
+  retval    = run(regs);
+
+  sStackTop = sStackTop - mNumRegs;
+
+  return retval;
+}
+
+/************************************ | *************************************
+*                                                                           *
+* The dispatch loop.  GCC and clang support computed goto, which gives      *
+* every instruction its own indirect branch; otherwise use a switch.        *
+*                                                                           *
+************************************* | ************************************/
+
+#if defined(__GNUC__)
+
+#define IPE_OP(name)   L_##name:
+#define IPE_NEXT()     goto *sLabels[(++pc)->op]
+#define IPE_JUMP(to)   pc = code + (to); goto *sLabels[pc->op]
+
+#else
+
+#define IPE_OP(name)   case name:
+#define IPE_NEXT()     ++pc; continue
+#define IPE_JUMP(to)   pc = code + (to); continue
+
+#endif
+
+IpeValue IpeBytecode::run(void* regsArg)
+{
+  IpeReg*      regs = (IpeReg*) regsArg;
+  const Instr* code = &mCode[0];
+  const Instr* pc   = code;
+  IpeValue     retval;
+
+#if defined(__GNUC__)
+  // In Opcode order
+  static void* sLabels[] =
+  {
+    &&L_kMove,   &&L_kLoadGlobal, &&L_kStoreGlobal, &&L_kStoreRef, &&L_kAddrOf,
+
+    &&L_kAddInt,  &&L_kSubInt,  &&L_kMulInt,  &&L_kDivInt,  &&L_kNegInt,
+    &&L_kAddReal, &&L_kSubReal, &&L_kMulReal, &&L_kDivReal, &&L_kNegReal,
+
+    &&L_kEqInt,  &&L_kNeInt,  &&L_kLtInt,  &&L_kGtInt,  &&L_kLeInt,  &&L_kGeInt,
+    &&L_kEqReal, &&L_kNeReal, &&L_kLtReal, &&L_kGtReal, &&L_kLeReal, &&L_kGeReal,
+
+    &&L_kJump, &&L_kJumpFalse, &&L_kJumpTrue,
+
+    &&L_kCall, &&L_kReturn, &&L_kReturnVoid
+  };
+
+  INT_ASSERT(sizeof(sLabels) / sizeof(sLabels[0]) == kNumOpcodes);
+
+  goto *sLabels[pc->op];
+#else
+  for (;;)
+  {
+    switch (pc->op)
+    {
+#endif
+
+  IPE_OP(kMove)
+    regs[pc->a] = regs[pc->b];
+    IPE_NEXT();
+
+  IPE_OP(kLoadGlobal)
+    regs[pc->a] = *((IpeReg*) pc->ptr);
+    IPE_NEXT();
+
+  IPE_OP(kStoreGlobal)
+    *((IpeReg*) pc->ptr) = regs[pc->a];
+    IPE_NEXT();
+
+  IPE_OP(kStoreRef)
+    *((IpeReg*) regs[pc->a].p) = regs[pc->b];
+    IPE_NEXT();
+
+  IPE_OP(kAddrOf)
+    regs[pc->a].p = regs + pc->b;
+    IPE_NEXT();
+
+  IPE_OP(kAddInt)
+    regs[pc->a].i = regs[pc->b].i + regs[pc->c].i;
+    IPE_NEXT();
+
+  IPE_OP(kSubInt)
+    regs[pc->a].i = regs[pc->b].i - regs[pc->c].i;
+    IPE_NEXT();
+
+  IPE_OP(kMulInt)
+    regs[pc->a].i = regs[pc->b].i * regs[pc->c].i;
+    IPE_NEXT();
+
+  IPE_OP(kDivInt)
+    regs[pc->a].i = regs[pc->b].i / regs[pc->c].i;
+    IPE_NEXT();
+
+  IPE_OP(kNegInt)
+    regs[pc->a].i = -regs[pc->b].i;
+    IPE_NEXT();
+
+  IPE_OP(kAddReal)
+    regs[pc->a].r = regs[pc->b].r + regs[pc->c].r;
+    IPE_NEXT();
+
+  IPE_OP(kSubReal)
+    regs[pc->a].r = regs[pc->b].r - regs[pc->c].r;
+    IPE_NEXT();
+
+  IPE_OP(kMulReal)
+    regs[pc->a].r = regs[pc->b].r * regs[pc->c].r;
+    IPE_NEXT();
+
+  IPE_OP(kDivReal)
+    regs[pc->a].r = regs[pc->b].r / regs[pc->c].r;
+    IPE_NEXT();
+
+  IPE_OP(kNegReal)
+    regs[pc->a].r = -regs[pc->b].r;
+    IPE_NEXT();
+
+  IPE_OP(kEqInt)
+    regs[pc->a].i = (regs[pc->b].i == regs[pc->c].i) ? 1 : 0;
+    IPE_NEXT();
+
+  IPE_OP(kNeInt)
+    regs[pc->a].i = (regs[pc->b].i != regs[pc->c].i) ? 1 : 0;
+    IPE_NEXT();
+
+  IPE_OP(kLtInt)
+    regs[pc->a].i = (regs[pc->b].i <  regs[pc->c].i) ? 1 : 0;
+    IPE_NEXT();
+
+  IPE_OP(kGtInt)
+    regs[pc->a].i = (regs[pc->b].i >  regs[pc->c].i) ? 1 : 0;
+    IPE_NEXT();
+
+  IPE_OP(kLeInt)
+    regs[pc->a].i = (regs[pc->b].i <= regs[pc->c].i) ? 1 : 0;
+    IPE_NEXT();
+
+  IPE_OP(kGeInt)
+    regs[pc->a].i = (regs[pc->b].i >= regs[pc->c].i) ? 1 : 0;
+    IPE_NEXT();
+
+  IPE_OP(kEqReal)
+    regs[pc->a].i = (regs[pc->b].r == regs[pc->c].r) ? 1 : 0;
+    IPE_NEXT();
+
+  IPE_OP(kNeReal)
+    regs[pc->a].i = (regs[pc->b].r != regs[pc->c].r) ? 1 : 0;
+    IPE_NEXT();
+
+  IPE_OP(kLtReal)
+    regs[pc->a].i = (regs[pc->b].r <  regs[pc->c].r) ? 1 : 0;
+    IPE_NEXT();
+
+  IPE_OP(kGtReal)
+    regs[pc->a].i = (regs[pc->b].r >  regs[pc->c].r) ? 1 : 0;
+    IPE_NEXT();
+
+  IPE_OP(kLeReal)
+    regs[pc->a].i = (regs[pc->b].r <= regs[pc->c].r) ? 1 : 0;
+    IPE_NEXT();
+
+  IPE_OP(kGeReal)
+    regs[pc->a].i = (regs[pc->b].r >= regs[pc->c].r) ? 1 : 0;
+    IPE_NEXT();
+
+  IPE_OP(kJump)
+    IPE_JUMP(pc->a);
+
+  // A bool is true only if it is 1; see IpeValue::boolGet()
+  IPE_OP(kJumpFalse)
+    if (regs[pc->a].i != 1)
+    {
+      IPE_JUMP(pc->b);
+    }
+    IPE_NEXT();
+
+  IPE_OP(kJumpTrue)
+    if (regs[pc->a].i == 1)
+    {
+      IPE_JUMP(pc->b);
+    }
+    IPE_NEXT();
+
+  // The callee is compiled the first time the call is executed, which
+  // allows for recursion
+  IPE_OP(kCall)
+  {
+    CallSite* site = (CallSite*) pc->ptr;
+    IpeValue  value;
+
+    if (site->resolved == false)
+    {
+      site->code     = site->procedure->bytecodeGet(site->methodId);
+      site->resolved = true;
+    }
+
+    if (site->code != NULL)
+      value = site->code->invoke(regs + pc->b, pc->c);
+    else
+      value = site->method->apply((const IpeValue*) (regs + pc->b), pc->c);
+
+    memcpy(regs + pc->a, &value, sizeof(IpeReg));
+  }
+    IPE_NEXT();
+
+  IPE_OP(kReturn)
+    memcpy(&retval, regs + pc->a, sizeof(IpeReg));
+    return retval;
+
+  IPE_OP(kReturnVoid)
+    return retval;
+
+#if !defined(__GNUC__)
+      default:
+        INT_ASSERT(false);
+        return retval;
+    }
+  }
+#endif
+}
+
+#undef IPE_OP
+#undef IPE_NEXT
+#undef IPE_JUMP
+
+/************************************ | *************************************
+*                                                                           *
+*                                                                           *
+*                                                                           *
+************************************* | ************************************/
+
+const char* IpeBytecode::opcodeName(int op)
+{
+  static const char* sNames[] =
+  {
+    "move",   "loadGlobal", "storeGlobal", "storeRef", "addrOf",
+
+    "addInt",  "subInt",  "mulInt",  "divInt",  "negInt",
+    "addReal", "subReal", "mulReal", "divReal", "negReal",
+
+    "eqInt",  "neInt",  "ltInt",  "gtInt",  "leInt",  "geInt",
+    "eqReal", "neReal", "ltReal", "gtReal", "leReal", "geReal",
+
+    "jump", "jumpFalse", "jumpTrue",
+
+    "call", "return", "returnVoid"
+  };
+
+  return (op >= 0 && op < kNumOpcodes) ? sNames[op] : "???";
+}
+
+void IpeBytecode::describe(int offset) const
+{
+  char pad[32] = { '\0' };
+
+  if (offset < 32)
+  {
+    char* tptr = pad;
+
+    for (int i = 0; i < offset; i++)
+      *tptr++ = ' ';
+
+    *tptr = '\0';
+  }
+
+  printf("%s#<IpeBytecode %s\n",
+         pad,
+         (mMethod != NULL) ? mMethod->name() : "<top level>");
+
+  printf("%s  Registers: %4d (%d formals, %d locals, %d constants)\n",
+         pad,
+         mNumRegs,
+         mNumFormals,
+         mNumLocals,
+         (int) mConstants.size());
+
+  for (size_t i = 0; i < mCode.size(); i++)
+  {
+    const Instr& instr = mCode[i];
+
+    printf("%s  %4d  %-12s %4d %4d %4d",
+           pad,
+           (int) i,
+           opcodeName(instr.op),
+           instr.a,
+           instr.b,
+           instr.c);
+
+    if (instr.op == kCall)
+      printf("  %s", ((CallSite*) instr.ptr)->method->name());
+
+    printf("\n");
+  }
+
+  printf("%s>\n", pad);
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _IPE_BYTECODE_H_
+#define _IPE_BYTECODE_H_
+
+#include "IpeValue.h"
+
+#include <vector>
+
+class Expr;
+class IpeBytecodeCompiler;
+class IpeCallExpr;
+class IpeEnv;
+class IpeMethod;
+class IpeProcedure;
+
+//
+// A register-based bytecode for resolved IPE code.
+//
+// A method is compiled once, the first time it is called, and the result
+// is cached by its IpeProcedure.  Every register is 8 bytes, like every
+// IPE value, and the first registers of a method are laid out exactly
+// like the frame the tree-walking evaluator would use: the formals and
+// then the locals.  Constants follow, and then the temporaries.
+//
+// Calls to small inline procedures, including all of the operators in
+// ChapelBase, are expanded in place.  Other calls pass their actuals in
+// a block of registers.  If the callee can't be compiled, for example
+// an extern procedure, the call is passed to IpeMethod::apply() instead.
+//
+// A top-level while loop is compiled the same way, so that loops typed
+// at the REPL also run from bytecode.
+//
+class IpeBytecode
+{
+public:
+  static IpeBytecode*        compile(IpeMethod* method);
+  static IpeBytecode*        compile(Expr* stmt, IpeEnv* env);
+
+                            ~IpeBytecode();
+
+  IpeValue                   apply(IpeCallExpr* callExpr, IpeEnv* callingEnv);
+  IpeValue                   execute();
+
+  void                       describe(int offset)                       const;
+
+private:
+  friend class IpeBytecodeCompiler;
+
+  enum Opcode
+  {
+    kMove,
+    kLoadGlobal,
+    kStoreGlobal,
+    kStoreRef,
+    kAddrOf,
+
+    kAddInt,
+    kSubInt,
+    kMulInt,
+    kDivInt,
+    kNegInt,
+
+    kAddReal,
+    kSubReal,
+    kMulReal,
+    kDivReal,
+    kNegReal,
+
+    kEqInt,
+    kNeInt,
+    kLtInt,
+    kGtInt,
+    kLeInt,
+    kGeInt,
+
+    kEqReal,
+    kNeReal,
+    kLtReal,
+    kGtReal,
+    kLeReal,
+    kGeReal,
+
+    kJump,
+    kJumpFalse,
+    kJumpTrue,
+
+    kCall,
+    kReturn,
+    kReturnVoid,
+
+    kNumOpcodes
+  };
+
+  struct Instr
+  {
+    int                      op;
+    int                      a;
+    int                      b;
+    int                      c;
+    void*                    ptr;
+  };
+
+  struct CallSite
+  {
+    IpeProcedure*            procedure;
+    int                      methodId;
+    IpeMethod*               method;
+    IpeBytecode*             code;
+    bool                     resolved;
+  };
+
+  struct Constant
+  {
+    int                      reg;
+    IpeValue                 value;
+  };
+
+                             IpeBytecode(IpeMethod* method);
+
+  IpeValue                   invoke(const void* actuals, int count);
+  IpeValue                   run(void* regs);
+
+  static const char*         opcodeName(int op);
+
+  IpeMethod*                 mMethod;
+  int                        mNumFormals;
+  int                        mNumLocals;
+  int                        mNumRegs;
+
+  std::vector<Instr>         mCode;
+  std::vector<Constant>      mConstants;
+  std::vector<CallSite*>     mCallSites;
+};
+
+#endif
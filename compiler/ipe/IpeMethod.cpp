@@ -129,6 +129,26 @@ const char* IpeMethod::stateAsString() const
   return retval;
 }
 
+IpeEnv* IpeMethod::envParentGet() const
+{
+  return mEnvParent;
+}
+
+IpeScope* IpeMethod::scopeGet() const
+{
+  return mScope;
+}
+
+int IpeMethod::frameSize() const
+{
+  return mFrameSize;
+}
+
+IpeSequence* IpeMethod::bodyGet() const
+{
+  return mBody;
+}
+
 ArgSymbol* IpeMethod::formalGet(int index) const
 {
   ArgSymbol* retval = NULL;
@@ -329,6 +349,41 @@ IpeValue IpeMethod::apply(IpeCallExpr* callingExpr, IpeEnv* callingEnv)
   return retval;
 }
 
+// Apply the method to actuals that have already been evaluated
+IpeValue IpeMethod::apply(const IpeValue* actuals, int count)
+{
+  IpeValue retval;
+
+  if (resolveBody() == true)
+  {
+    void*  frame = (mFrameSize > 0) ? malloc(mFrameSize) : NULL;
+    IpeEnv newEnv(mEnvParent, mScope, mFrameSize, frame);
+
+    if (frame)
+      memset(frame, 0, mFrameSize);
+
+    for (int i = 0; i < count; i++)
+      newEnv.store(formalGet(i), actuals[i]);
+
+    if (isExternFunction(mFnDecl) == true)
+      retval = externFunctionInvoke(&newEnv);
+    else
+      retval = evaluateExpr(mBody, &newEnv);
+
+    mInvokeCount = mInvokeCount + 1;
+
+    if (frame != NULL)
+      free(frame);
+  }
+
+  else
+  {
+    INT_ASSERT(false);
+  }
+
+  return retval;
+}
+
 bool IpeMethod::resolveBody()
 {
   if (mState == kResolvedReturnType)
@@ -64,6 +64,14 @@ public:
   bool                    isExactMatch(std::vector<Expr*>& actuals)                  const;
 
   IpeValue                apply(IpeCallExpr* expr, IpeEnv* env);
+  IpeValue                apply(const IpeValue* actuals, int count);
+
+  bool                    resolveBody();
+
+  IpeEnv*                 envParentGet()                                             const;
+  IpeScope*               scopeGet()                                                 const;
+  int                     frameSize()                                                const;
+  IpeSequence*            bodyGet()                                                  const;
 
   void                    describe(int offset, bool fullP = false)                   const;
 
@@ -81,7 +89,6 @@ private:
 
   const char*             stateAsString()                                            const;
 
-  bool                    resolveBody();
   bool                    bodyIsSimple(IpeSequence* body)                            const;
 
   bool                    isExternFunction(FnSymbol* fn)                             const;
@@ -21,6 +21,7 @@
 
 #include "AstDumpToNode.h"
 #include "expr.h"
+#include "IpeBytecode.h"
 #include "IpeCallExpr.h"
 #include "IpeMethod.h"
 
@@ -32,7 +33,8 @@ IpeProcedure::IpeProcedure(const char* identifierName)
 
 IpeProcedure::~IpeProcedure()
 {
-
+  for (size_t i = 0; i < mBytecode.size(); i++)
+    delete mBytecode[i];
 }
 
 const char* IpeProcedure::name() const
@@ -65,6 +67,30 @@ IpeMethod* IpeProcedure::methodGet(int index) const
   return retval;
 }
 
+IpeBytecode* IpeProcedure::bytecodeGet(int index)
+{
+  IpeBytecode* retval = NULL;
+
+  if (mBytecode.size() < mMethods.size())
+  {
+    mBytecode.resize(mMethods.size(), NULL);
+    mBytecodeFailed.resize(mMethods.size(), false);
+  }
+
+  if (index >= 0 && index < (int) mMethods.size())
+  {
+    if (mBytecode[index] == NULL && mBytecodeFailed[index] == false)
+    {
+      mBytecode[index]       = IpeBytecode::compile(mMethods[index]);
+      mBytecodeFailed[index] = (mBytecode[index] == NULL) ? true : false;
+    }
+
+    retval = mBytecode[index];
+  }
+
+  return retval;
+}
+
 IpeCallExpr* IpeProcedure::resolve(SymExpr*            procSymExpr,
                                    std::vector<Expr*>& actuals) const
 {
@@ -23,6 +23,7 @@
 #include <vector>
 
 class Expr;
+class IpeBytecode;
 class IpeCallExpr;
 class IpeMethod;
 class SymExpr;
@@ -41,6 +42,8 @@ public:
   void                      methodAdd(IpeMethod* method);
   IpeMethod*                methodGet(int index)                                     const;
 
+  IpeBytecode*              bytecodeGet(int index);
+
   IpeCallExpr*              resolve(SymExpr* procExpr, std::vector<Expr*>& actuals)  const;
 
   void                      describe(int offset)                                     const;
@@ -53,6 +56,10 @@ private:
   const char*               mIdentifierName;
   int                       mVersion;
   std::vector<IpeMethod*>   mMethods;
+
+  // Indexed like mMethods.  A method that can't be compiled is only tried once.
+  std::vector<IpeBytecode*> mBytecode;
+  std::vector<bool>         mBytecodeFailed;
 };
 
 #endif
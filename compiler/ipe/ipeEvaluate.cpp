@@ -20,7 +20,9 @@
 #include "ipeEvaluate.h"
 
 #include "AstDumpToNode.h"
+#include "driver.h"
 #include "expr.h"
+#include "IpeBytecode.h"
 #include "IpeEnv.h"
 
 IpeEnv* sFooEnv = NULL;
@@ -67,7 +69,22 @@ IpeValue evaluate(Expr* untypedExpr, IpeEnv* env)
   }
 
   if (exprRes != NULL)
-    retval = evaluateExpr(exprRes, env);
+  {
+    IpeBytecode* code = NULL;
+
+    // A loop at the top level is run from bytecode if possible
+    if (fIpeBytecode == true && isWhileDoStmt(exprRes) == true)
+      code = IpeBytecode::compile(exprRes, env);
+
+    if (code != NULL)
+    {
+      retval = code->execute();
+      delete code;
+    }
+
+    else
+      retval = evaluateExpr(exprRes, env);
+  }
 
   return retval;
 }
@@ -423,12 +440,19 @@ static IpeValue evaluateCall(IpeCallExpr* callExpr, IpeEnv* env)
 
     if (ipeProcedure->isValid(callExpr->procedureGeneration()) == true)
     {
-      int        methodId  = callExpr->methodId();
-      IpeMethod* ipeMethod = ipeProcedure->methodGet(methodId);
+      int          methodId  = callExpr->methodId();
+      IpeMethod*   ipeMethod = ipeProcedure->methodGet(methodId);
+      IpeBytecode* code      = NULL;
 
       INT_ASSERT(ipeMethod);
 
-      retval = ipeMethod->apply(callExpr, env);
+      if (fIpeBytecode == true)
+        code = ipeProcedure->bytecodeGet(methodId);
+
+      if (code != NULL)
+        retval = code->apply(callExpr, env);
+      else
+        retval = ipeMethod->apply(callExpr, env);
     }
 
     else
@@ -26,6 +26,8 @@
 #include <cstring>
 #include <algorithm>
 
+#include <sys/resource.h>
+
 // Used to collect the times as the program runs
 class Phase
 {
@@ -33,7 +35,8 @@ public:
                            Phase(const char*            name,
                                  int                    passId,
                                  PhaseTracker::SubPhase subPhase,
-                                 unsigned long          startTime);
+                                 unsigned long          startTime,
+                                 unsigned long          peakMemory);
                           ~Phase();
 
   bool                     IsStartOfPass()                            const;
@@ -48,6 +51,7 @@ public:
   int                      mPassId;
   PhaseTracker::SubPhase   mSubPhase;
   unsigned long            mStartTime;  // Elapsed time from main() usecs
+  unsigned long            mPeakMemory; // Peak RSS at the start, in KB
 
 private:
   Phase();
@@ -76,12 +80,15 @@ public:
                        unsigned long accumTime, 
                        unsigned long totalTime)      const;
 
+  void           PrintStats(FILE* fp)                const;
+
   char*          mName;
   int            mPassId;
   int            mIndex;
   unsigned long  mPrimary;          // usecs()
   unsigned long  mVerify;           // usecs()
   unsigned long  mCleanAst;         // usecs()
+  unsigned long  mPeakMemory;       // KB at the end of the pass
 };
 
 struct SortByTime
@@ -101,6 +108,8 @@ static void PassesReport(FILE*                    fp,
                          const std::vector<Pass>& passes,
                          unsigned long            totalTime);
 
+static unsigned long peakMemory();
+
 /************************************* | **************************************
 *                                                                             *
 * Implementation of PhaseTracker                                              *
@@ -140,7 +149,11 @@ void PhaseTracker::StartPhase(const char* name,
                               int         passId,
                               SubPhase    subPhase)
 {
-  Phase* phase = new Phase(name, passId, subPhase, mTimer.elapsedUsecs());
+  Phase* phase = new Phase(name,
+                           passId,
+                           subPhase,
+                           mTimer.elapsedUsecs(),
+                           peakMemory());
 
   mPhases.push_back(phase);
 }
@@ -179,6 +192,34 @@ void PhaseTracker::ReportRollup() const
   PassesReport(passes, totalTime);
 }
 
+void PhaseTracker::ReportStats(FILE* fp) const
+{
+  std::vector<Pass> passes;
+  unsigned long     mainTime  = 0;
+  unsigned long     checkTime = 0;
+  unsigned long     cleanTime = 0;
+
+  PassesCollect(passes);
+
+  fprintf(fp, "# Pass\tMain\tCheck\tClean\tPeak Memory (MB)\n");
+
+  for (size_t i = 0; i < passes.size(); i++)
+  {
+    passes[i].PrintStats(fp);
+
+    mainTime  = mainTime  + passes[i].mPrimary;
+    checkTime = checkTime + passes[i].mVerify;
+    cleanTime = cleanTime + passes[i].mCleanAst;
+  }
+
+  fprintf(fp,
+          "total\t%.6f\t%.6f\t%.6f\t%.3f\n",
+          mainTime  / 1e6,
+          checkTime / 1e6,
+          cleanTime / 1e6,
+          peakMemory() / 1024.0);
+}
+
 void PhaseTracker::PassesCollect(std::vector<Pass>& passes) const
 {
   unsigned long totalTime = mTimer.elapsedUsecs();
@@ -200,9 +241,15 @@ void PhaseTracker::PassesCollect(std::vector<Pass>& passes) const
       }
 
       if (i < mPhases.size() - 1)
-        elapsed = mPhases[i + 1]->mStartTime - start;
+      {
+        elapsed          = mPhases[i + 1]->mStartTime - start;
+        pass.mPeakMemory = mPhases[i + 1]->mPeakMemory;
+      }
       else
-        elapsed = totalTime                 - start;
+      {
+        elapsed          = totalTime                 - start;
+        pass.mPeakMemory = peakMemory();
+      }
 
       switch (mPhases[i]->mSubPhase)
       {
@@ -271,6 +318,24 @@ static void PassesReport(FILE*                    fp,
   Pass::Footer(fp, mainTime, checkTime, cleanTime, totalTime);
 }
 
+// The peak resident set size of the compiler so far, in KB
+static unsigned long peakMemory()
+{
+  struct rusage usage;
+  unsigned long retval = 0;
+
+  if (getrusage(RUSAGE_SELF, &usage) == 0)
+  {
+#ifdef __APPLE__
+    retval = usage.ru_maxrss / 1024;   // bytes on Mac OS X
+#else
+    retval = usage.ru_maxrss;
+#endif
+  }
+
+  return retval;
+}
+
 /************************************* | **************************************
 *                                                                             *
 * Implementation of Phase                                                     *
@@ -280,12 +345,14 @@ static void PassesReport(FILE*                    fp,
 Phase::Phase(const char*            name,
              int                    passId,
              PhaseTracker::SubPhase subPhase,
-             unsigned long          startTime)
+             unsigned long          startTime,
+             unsigned long          peakMemory)
 {
-  mName      = (subPhase == PhaseTracker::kPrimary) ? strdup(name) : 0;
-  mPassId    = passId;
-  mSubPhase  = subPhase;
-  mStartTime = startTime;
+  mName       = (subPhase == PhaseTracker::kPrimary) ? strdup(name) : 0;
+  mPassId     = passId;
+  mSubPhase   = subPhase;
+  mStartTime  = startTime;
+  mPeakMemory = peakMemory;
 }
 
 Phase::~Phase()
@@ -362,12 +429,13 @@ Pass::~Pass()
 
 void Pass::Reset()
 {
-  mName     = 0;
-  mPassId   = 0;
-  mIndex    = 0;
-  mPrimary  = 0;
-  mVerify   = 0;
-  mCleanAst = 0;
+  mName       = 0;
+  mPassId     = 0;
+  mIndex      = 0;
+  mPrimary    = 0;
+  mVerify     = 0;
+  mCleanAst   = 0;
+  mPeakMemory = 0;
 }
 
 unsigned long Pass::TotalTime() const
@@ -441,6 +509,17 @@ void Pass::Print(FILE*         fp,
   fprintf(fp, "\n");
 }
 
+void Pass::PrintStats(FILE* fp) const
+{
+  fprintf(fp,
+          "%s\t%.6f\t%.6f\t%.6f\t%.3f\n",
+          mName,
+          mPrimary    / 1e6,
+          mVerify     / 1e6,
+          mCleanAst   / 1e6,
+          mPeakMemory / 1024.0);
+}
+
 void Pass::Footer(FILE*         fp, 
                   unsigned long mainTime,
                   unsigned long checkTime,
@@ -56,6 +56,10 @@
 * of these passes.  Phases that occur before and after the Passes ignore      *
 * the check and clean phases.                                                 *
 *                                                                             *
+* The peak memory use of the compiler is also sampled at the start of every   *
+* phase.  ReportStats() writes the time and peak memory of each pass as a     *
+* tab-separated table for scripts to consume (see util/test/compilerPerf).    *
+*                                                                             *
 ************************************** | *************************************/
 
 class Phase;
@@ -84,6 +88,8 @@ public:
 
   void                 ReportRollup()                                const;
 
+  void                 ReportStats (FILE* fp)                        const;
+
 private:
   void                 PassesCollect(std::vector<Pass>& passes) const;
   
@@ -37,6 +37,7 @@
 #include "ModuleSymbol.h"
 #include "misc.h"
 #include "mysystem.h"
+#include "objectCache.h"
 #include "parser.h"
 #include "PhaseTracker.h"
 #include "primitive.h"
@@ -111,6 +112,7 @@ int  fcg = 0;
 bool fCacheRemote = false;
 bool fFastFlag = false;
 bool fUseNoinit = true;
+bool fNoCopyElision = false;
 bool fNoCopyPropagation = false;
 bool fNoDeadCodeElimination = false;
 bool fNoScalarReplacement = false;
@@ -141,6 +143,7 @@ bool fEnableTaskTracking = false;
 
 bool  printPasses     = false;
 FILE* printPassesFile = NULL;
+FILE* printPassStatsFile = NULL;
 
 // flag for llvmWideOpt
 bool fLLVMWideOpt = false;
@@ -166,6 +169,8 @@ bool fRemoveUnreachableBlocks = true;
 bool fMinimalModules = false;
 bool fIncrementalCompilation = false;
 bool fUseIPE         = false;
+bool fIpeBytecode    = true;
+bool fPruneStandardFunctions = false;
 
 int optimize_on_clause_limit = 20;
 int scalar_replace_limit = 8;
@@ -205,7 +210,10 @@ bool fReportInlinedIterators = false;
 bool fReportOrderIndependentLoops = false;
 bool fReportOptimizedOn = false;
 bool fReportPromotion = false;
+bool fReportResolutionCandidates = false;
 bool fReportScalarReplace = false;
+bool fReportElidedCopies = false;
+bool fReportHoistedInvariants = false;
 bool fReportDeadBlocks = false;
 bool fReportDeadModules = false;
 bool fPermitUnhandledModuleErrors = false;
@@ -635,6 +643,14 @@ static void verifySaveCDir(const ArgumentDescription* desc, const char* unused)
   }
 }
 
+static void verifyCCacheDir(const ArgumentDescription* desc, const char* unused) {
+  if (fCCacheDir[0] == '-') {
+    USR_FATAL("--c-cache-dir takes a directory name as its argument\n"
+              "       (you specified '%s', assumed to be another flag)",
+              fCCacheDir);
+  }
+}
+
 static void setLibmode(const ArgumentDescription* desc, const char* unused);
 
 static void verifySaveLibDir(const ArgumentDescription* desc, const char* unused) {
@@ -664,6 +680,7 @@ static void setFastFlag(const ArgumentDescription* desc, const char* unused) {
   // don't set fieeefloat since it can change program behavior.
   // instead, we rely on the backend C compiler to choose
   // an appropriate level of optimization.
+  fNoCopyElision = false;
   fNoCopyPropagation = false;
   fNoDeadCodeElimination = false;
   fNoFastFollowers = false;
@@ -712,6 +729,7 @@ static void setBaselineFlag(const ArgumentDescription* desc, const char* unused)
   //
   fBaseline = true;                   // --baseline
 
+  fNoCopyElision = true;              // --no-copy-elision
   fNoCopyPropagation = true;          // --no-copy-propagation
   fNoDeadCodeElimination = true;      // --no-dead-code-elimination
   fNoFastFollowers = true;            // --no-fast-followers
@@ -784,6 +802,14 @@ static void setPrintPassesFile(const ArgumentDescription* desc, const char* file
   }
 }
 
+static void setPrintPassStatsFile(const ArgumentDescription* desc, const char* fileName) {
+  printPassStatsFile = fopen(fileName, "w");
+
+  if (printPassStatsFile == NULL) {
+    USR_WARN("Error opening printPassStatsFile: %s.", fileName);
+  }
+}
+
 static void setLocal (const ArgumentDescription* desc, const char* unused) {
   // Used in postLocal() to set fLocal if user threw flag
   fUserSetLocal = true;
@@ -847,6 +873,7 @@ static ArgumentDescription arg_desc[] = {
  {"", ' ', NULL, "Optimization Control Options", NULL, NULL, NULL, NULL},
  {"baseline", ' ', NULL, "Disable all Chapel optimizations", "F", &fBaseline, "CHPL_BASELINE", setBaselineFlag},
  {"cache-remote", ' ', NULL, "[Don't] enable cache for remote data", "N", &fCacheRemote, "CHPL_CACHE_REMOTE", setCacheEnable},
+ {"copy-elision", ' ', NULL, "Enable [disable] turning copies of dead values into moves", "n", &fNoCopyElision, "CHPL_DISABLE_COPY_ELISION", NULL},
  {"copy-propagation", ' ', NULL, "Enable [disable] copy propagation", "n", &fNoCopyPropagation, "CHPL_DISABLE_COPY_PROPAGATION", NULL},
  {"dead-code-elimination", ' ', NULL, "Enable [disable] dead code elimination", "n", &fNoDeadCodeElimination, "CHPL_DISABLE_DEAD_CODE_ELIMINATION", NULL},
  {"fast", ' ', NULL, "Use fast default settings", "F", &fFastFlag, "CHPL_FAST", setFastFlag},
@@ -892,6 +919,7 @@ static ArgumentDescription arg_desc[] = {
  {"savec", ' ', "<directory>", "Save generated C code in directory", "P", saveCDir, "CHPL_SAVEC_DIR", verifySaveCDir},
 
  {"", ' ', NULL, "C Code Compilation Options", NULL, NULL, NULL, NULL},
+ {"c-cache-dir", ' ', "<directory>", "Cache objects compiled from generated C code in directory", "P", fCCacheDir, "CHPL_C_CACHE_DIR", verifyCCacheDir},
  {"ccflags", ' ', "<flags>", "Back-end C compiler flags (can be specified multiple times)", "S", NULL, "CHPL_CC_FLAGS", setCCFlags},
  {"debug", 'g', NULL, "[Don't] Support debugging of generated C code", "N", &debugCCode, "CHPL_DEBUG", setChapelDebug},
  {"dynamic", ' ', NULL, "Generate a dynamically linked binary", "F", &fLinkStyle, NULL, setDynamicLink},
@@ -900,6 +928,7 @@ static ArgumentDescription arg_desc[] = {
  {"lib-linkage", 'l', "<library>", "C library linkage", "P", libraryFilename, "CHPL_LIB_NAME", handleLibrary},
  {"lib-search-path", 'L', "<directory>", "C library search path", "P", libraryFilename, "CHPL_LIB_PATH", handleLibPath},
  {"optimize", 'O', NULL, "[Don't] Optimize generated C code", "N", &optimizeCCode, "CHPL_OPTIMIZE", NULL},
+ {"parallel-c-compile", ' ', "<jobs>", "Split generated C code into <jobs> parts and compile them in parallel", "I", &fParallelCCompile, "CHPL_PARALLEL_C_COMPILE", NULL},
  {"specialize", ' ', NULL, "[Don't] Specialize generated C code for CHPL_TARGET_ARCH", "N", &specializeCCode, "CHPL_SPECIALIZE", NULL},
  {"output", 'o', "<filename>", "Name output executable", "P", executableFilename, "CHPL_EXE_NAME", NULL},
  {"static", ' ', NULL, "Generate a statically linked binary", "F", &fLinkStyle, NULL, NULL},
@@ -985,15 +1014,19 @@ static ArgumentDescription arg_desc[] = {
  {"print-module-resolution", ' ', NULL, "Print name of module being resolved", "F", &fPrintModuleResolution, "CHPL_PRINT_MODULE_RESOLUTION", NULL},
  {"print-dispatch", ' ', NULL, "Print dynamic dispatch table", "F", &fPrintDispatch, NULL, NULL},
  {"print-statistics", ' ', "[n|k|t]", "Print AST statistics", "S256", fPrintStatistics, NULL, NULL},
+ {"print-pass-stats-file", ' ', "<filename>", "Print per-pass time and peak memory to <filename>", "S", NULL, "CHPL_PRINT_PASS_STATS_FILE", setPrintPassStatsFile},
  {"report-aliases", ' ', NULL, "Report aliases in user code", "N", &fReportAliases, NULL, NULL},
  {"report-inlining", ' ', NULL, "Print inlined functions", "F", &report_inlining, NULL, NULL},
  {"report-dead-blocks", ' ', NULL, "Print dead block removal stats", "F", &fReportDeadBlocks, NULL, NULL},
+ {"report-elided-copies", ' ', NULL, "Print copies turned into moves by copy elision", "F", &fReportElidedCopies, NULL, NULL},
+ {"report-hoisted-invariants", ' ', NULL, "Print loops that loop invariant code was hoisted out of", "F", &fReportHoistedInvariants, NULL, NULL},
  {"report-dead-modules", ' ', NULL, "Print dead module removal stats", "F", &fReportDeadModules, NULL, NULL},
  {"report-optimized-loop-iterators", ' ', NULL, "Print stats on optimized single loop iterators", "F", &fReportOptimizedLoopIterators, NULL, NULL},
  {"report-inlined-iterators", ' ', NULL, "Print stats on inlined iterators", "F", &fReportInlinedIterators, NULL, NULL},
  {"report-order-independent-loops", ' ', NULL, "Print stats on order independent loops", "F", &fReportOrderIndependentLoops, NULL, NULL},
  {"report-optimized-on", ' ', NULL, "Print information about on clauses that have been optimized for potential fast remote fork operation", "F", &fReportOptimizedOn, NULL, NULL},
  {"report-promotion", ' ', NULL, "Print information about scalar promotion", "F", &fReportPromotion, NULL, NULL},
+ {"report-resolution-candidates", ' ', NULL, "Print stats on the functions considered by function resolution", "F", &fReportResolutionCandidates, NULL, NULL},
  {"report-scalar-replace", ' ', NULL, "Print scalar replacement stats", "F", &fReportScalarReplace, NULL, NULL},
  {"default-unmanaged", ' ', NULL, "Enable [disable] class type defaulting to unmanaged", "N", &fDefaultUnmanaged, "CHPL_DEFAULT_UNMANAGED", NULL},
  {"legacy-new", ' ', NULL, "Enable [disable] 'new SomeClass' legacy behavior", "N", &fLegacyNew, "CHPL_LEGACY_NEW", NULL},
@@ -1033,6 +1066,8 @@ static ArgumentDescription arg_desc[] = {
  {"remove-unreachable-blocks", ' ', NULL, "[Don't] remove unreachable blocks after resolution", "N", &fRemoveUnreachableBlocks, "CHPL_REMOVE_UNREACHABLE_BLOCKS", NULL},
  {"replace-array-accesses-with-ref-temps", ' ', NULL, "Enable [disable] replacing array accesses with reference temps (experimental)", "N", &fReplaceArrayAccessesWithRefTemps, NULL, NULL },
  {"incremental", ' ', NULL, "Enable [disable] using incremental compilation", "N", &fIncrementalCompilation, "CHPL_INCREMENTAL_COMP", NULL},
+ {"ipe-bytecode", ' ', NULL, "Enable [disable] bytecode compilation of IPE procedures", "N", &fIpeBytecode, "CHPL_IPE_BYTECODE", NULL},
+ {"prune-standard-functions", ' ', NULL, "Enable [disable] removing unreferenced functions of standard modules only, not internal or user ones (experimental)", "N", &fPruneStandardFunctions, "CHPL_PRUNE_STANDARD_FUNCTIONS", NULL},
  {"minimal-modules", ' ', NULL, "Enable [disable] using minimal modules",               "N", &fMinimalModules, "CHPL_MINIMAL_MODULES", NULL},
  {"print-chpl-settings", ' ', NULL, "Print current chapel settings and exit", "F", &fPrintChplSettings, NULL,NULL},
  {"stop-after-pass", ' ', "<passname>", "Stop compilation after reaching this pass", "S128", &stopAfterPass, "CHPL_STOP_AFTER_PASS", NULL},
@@ -1430,6 +1465,11 @@ int main(int argc, char* argv[]) {
     fclose(printPassesFile);
   }
 
+  if (printPassStatsFile != NULL) {
+    tracker.ReportStats(printPassStatsFile);
+    fclose(printPassStatsFile);
+  }
+
   clean_exit(0);
 
   return 0;
@@ -138,6 +138,11 @@ public:
       }
     }
 
+    //get the AST for the loop, if there is one
+    LoopStmt* getLoopAST() {
+      return loopAST;
+    }
+
     //add all the blocks from other loop to this loop
     void combine(Loop* otherLoop) {
       for_vector(BasicBlock, block, *otherLoop->getBlocks()) {
@@ -439,6 +444,7 @@ static bool isLoopInvariantPrimitive(PrimitiveOp* primitiveOp)
       case PRIM_CHECK_NIL:
       case PRIM_GET_REAL:
       case PRIM_GET_IMAG:
+      case PRIM_CAST:
 
       case PRIM_SET_SVEC_MEMBER:
       case PRIM_GET_SVEC_MEMBER:
@@ -457,6 +463,28 @@ static bool isLoopInvariantPrimitive(PrimitiveOp* primitiveOp)
 }
 
 
+/*
+ * Checks if sym is the runtime's table of privatized objects. Entries are only
+ * added to (and the table only reallocated) when a new object is privatized,
+ * which requires a call. So in a loop without calls, a privatized instance
+ * lookup is invariant as long as the pid is.
+ */
+static bool isPrivatizedObjectTable(Symbol* sym) {
+  return sym->hasFlag(FLAG_EXTERN) &&
+         strcmp(sym->name, "chpl_privateObjects") == 0;
+}
+
+static bool isPrivatizedObjectLoad(CallExpr* call) {
+  if (call->isPrimitive(PRIM_ARRAY_GET) ||
+      call->isPrimitive(PRIM_ARRAY_GET_VALUE)) {
+    if (SymExpr* base = toSymExpr(call->get(1))) {
+      return isPrivatizedObjectTable(base->symbol());
+    }
+  }
+  return false;
+}
+
+
 /*
  * Simple function to check if a symExpr is constant
  */
@@ -466,6 +494,10 @@ static bool isConst(SymExpr* symExpr) {
       return true;
     }
   }
+  //types (e.g. the first argument of a cast) never change
+  if(isTypeSymbol(symExpr->symbol())) {
+    return true;
+  }
   return false;
 
   //TODO can we use vass's backend const?
@@ -595,7 +627,9 @@ static bool allOperandsAreLoopInvariant(Expr* expr, std::set<SymExpr*>& loopInva
   //if there was a different loop invariant operand, make sure all its arguments
   //are invariant
   if(CallExpr* callExpr = toCallExpr(expr)) {
-    if(callExpr->primitive && isLoopInvariantPrimitive(callExpr->primitive)) {
+    if(callExpr->primitive &&
+       (isLoopInvariantPrimitive(callExpr->primitive) ||
+        isPrivatizedObjectLoad(callExpr))) {
       if(callExpr->isPrimitive(PRIM_MOVE) || callExpr->isPrimitive(PRIM_ASSIGN)) {
         return allOperandsAreLoopInvariant(callExpr->get(2), loopInvariants, loopInvariantInstructions, loop, actualDefs);
       }
@@ -676,6 +710,125 @@ static bool allOperandsAreLoopInvariant(Expr* expr, std::set<SymExpr*>& loopInva
 }
 
 
+/*
+ * The fields of the array, domain, and distribution wrapper records (_instance,
+ * _pid, ...) do not vary once the wrapper has been initialized (see the notes
+ * in remoteValueForwarding.cpp). So a load of one of them is invariant as long
+ * as the wrapper is not declared, initialized, or overwritten inside the loop,
+ * even if the wrapper is a ref formal, which is how arrays are usually passed.
+ */
+static bool isInvariantWrapperFieldLoad(CallExpr* call,
+    std::set<Symbol*>& defsInLoop,
+    std::map<SymExpr*, std::set<SymExpr*> >& actualDefs) {
+
+  if(!call->isPrimitive(PRIM_GET_MEMBER_VALUE)) {
+    return false;
+  }
+
+  SymExpr* base  = toSymExpr(call->get(1));
+  SymExpr* field = toSymExpr(call->get(2));
+  if(!base || !field || !isRecordWrappedType(base->getValType())) {
+    return false;
+  }
+
+  if(defsInLoop.count(base->symbol()) == 1 || actualDefs.count(field) == 1) {
+    return false;
+  }
+
+  //Taking a reference to the wrapper is fine, but storing to it or to one
+  //of its fields (directly or through an alias) is not
+  if(actualDefs.count(base) == 1) {
+    for_set(SymExpr, def, actualDefs[base]) {
+      CallExpr* defCall = toCallExpr(def->parentExpr);
+      if(!defCall || !defCall->primitive) {
+        return false;
+      }
+      if(defCall->isPrimitive(PRIM_MOVE) ||
+         defCall->isPrimitive(PRIM_ASSIGN) ||
+         defCall->isPrimitive(PRIM_SET_MEMBER) ||
+         defCall->isPrimitive(PRIM_SET_SVEC_MEMBER)) {
+        if(defCall->get(1) == def) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+
+/*
+ * Checks if sym is a field of an array class, e.g. DefaultRectangularArr's
+ * shiftedData, blk, or off.
+ */
+static bool isArrayClassField(Symbol* sym) {
+  if (sym->defPoint != NULL) {
+    if (TypeSymbol* ts = toTypeSymbol(sym->defPoint->parentSymbol)) {
+      return isArrayClass(ts->type);
+    }
+  }
+  return false;
+}
+
+
+/*
+ * Checks that a ref is neither declared nor defined in a loop and that every
+ * use of it in the loop only reads through it: a deref, a field load with
+ * the ref as the base, or a move of its value into a non-ref.
+ */
+static bool isOnlyReadInLoop(Symbol* ref,
+                             std::vector<SymExpr*>& loopSymExprs,
+                             std::set<Symbol*>& defsInLoop,
+                             symToVecSymExprMap& localDefMap) {
+  if (defsInLoop.count(ref) == 1 || localDefMap.count(ref) == 1)
+    return false;
+
+  for_vector(SymExpr, se, loopSymExprs) {
+    if (se->symbol() != ref)
+      continue;
+
+    CallExpr* call = toCallExpr(se->parentExpr);
+
+    if (call == NULL)
+      return false;
+
+    if (call->isPrimitive(PRIM_DEREF))
+      continue;
+
+    if ((call->isPrimitive(PRIM_GET_MEMBER_VALUE) ||
+         call->isPrimitive(PRIM_GET_SVEC_MEMBER_VALUE)) &&
+        se == call->get(1))
+      continue;
+
+    if (call->isPrimitive(PRIM_MOVE) && se == call->get(2) &&
+        call->get(1)->isRef() == false)
+      continue;
+
+    return false;
+  }
+
+  return true;
+}
+
+
+/*
+ * Checks if a hoisted definition loads array metadata: a wrapper record field,
+ * a field of an array class (shiftedData, blk, off, ...), or a privatized
+ * instance. Used for reporting only.
+ */
+static bool isArrayMetadataLoad(CallExpr* move) {
+  if(CallExpr* rhs = toCallExpr(move->get(2))) {
+    if(rhs->isPrimitive(PRIM_GET_MEMBER_VALUE)) {
+      Type* baseType = rhs->get(1)->getValType();
+      return isRecordWrappedType(baseType) || isArrayClass(baseType);
+    } else if(isPrivatizedObjectLoad(rhs)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
 /*
  * The basic algorithm will be to find all of the constants, and then find things that
  * have no definitions in the loop. We also need to consider a symbols aliases when we're
@@ -946,9 +1099,17 @@ static void computeLoopInvariants(std::vector<SymExpr*>& loopInvariants,
     if (symExpr->symbol()->isRef()) {
         mightHaveBeenDeffedElseWhere = true;
     }
+    // A ref to an array class's metadata field (e.g. to its blk tuple)
+    // doesn't matter in a call-free loop if the loop provably only reads
+    // through it.
     for_set(Symbol, aliasSym, aliases[symExpr->symbol()]) {
       if (aliasSym->isRef()) {
-        mightHaveBeenDeffedElseWhere = true;
+        if (callsInLoop.size() != 0 ||
+            !isArrayClassField(symExpr->symbol()) ||
+            !isOnlyReadInLoop(aliasSym, loopSymExprs, defsInLoop,
+                              localDefMap)) {
+          mightHaveBeenDeffedElseWhere = true;
+        }
       }
     }
     //if there were no defs of the symbol, it is invariant
@@ -956,6 +1117,22 @@ static void computeLoopInvariants(std::vector<SymExpr*>& loopInvariants,
       loopInvariantOperands.insert(symExpr);
     }
   }
+
+  //In a loop without any calls nothing can reallocate an array's data or
+  //change its metadata, so once the load of the array class out of its
+  //wrapper is known to be invariant, the loads of the class's fields
+  //(shiftedData, blk, off, ...) that depend on it can be hoisted too.
+  if(callsInLoop.size() == 0) {
+    for_vector(SymExpr, symExpr, loopSymExprs) {
+      if(CallExpr* call = toCallExpr(symExpr->parentExpr)) {
+        if(symExpr == call->get(1) &&
+           isInvariantWrapperFieldLoad(call, defsInLoop, actualDefs)) {
+          loopInvariantOperands.insert(symExpr);
+          loopInvariantOperands.insert(toSymExpr(call->get(2)));
+        }
+      }
+    }
+  }
   stopTimer(calculateActualDefsTimer);
 
   //now we want to iteratively search for all of the variables that have
@@ -1225,7 +1402,15 @@ static long licmFn(FnSymbol* fn) {
     computeLoopInvariants(loopInvariants, defsInLoop, curLoop, localDefMap, fn);
     stopTimer(computeLoopInvariantsTimer);
 
+    //Note where the loop is before anything is moved out of it
+    Expr* loopLoc = curLoop->getLoopAST();
+    if(loopLoc == NULL && curLoop->getHeader()->exprs.size() != 0) {
+      loopLoc = curLoop->getHeader()->exprs[0];
+    }
+
     //For each invariant, only move it if its def, dominates all uses and all exits
+    int numHoisted = 0;
+    int numMetadataHoisted = 0;
     for_vector(SymExpr, symExpr, loopInvariants) {
       if(CallExpr* call = toCallExpr(symExpr->parentExpr)) {
         if(defDominatesAllUses(curLoop, symExpr, dominators, localMap, localUseMap)) {
@@ -1234,11 +1419,28 @@ static long licmFn(FnSymbol* fn) {
               curLoop->insertBefore(symExpr->symbol()->defPoint);
             }
             curLoop->insertBefore(call);
+
+            numHoisted++;
+            if(isArrayMetadataLoad(call)) {
+              numMetadataHoisted++;
+            }
           }
         }
       }
     }
 
+    if(fReportHoistedInvariants && numHoisted > 0 && loopLoc != NULL) {
+      ModuleSymbol* mod = fn->getModule();
+
+      if(developer || mod->modTag == MOD_USER) {
+        printf("Hoisted %d invariant%s (%d array metadata load%s) "
+               "out of loop in function %s (%s:%d)\n",
+               numHoisted, numHoisted == 1 ? "" : "s",
+               numMetadataHoisted, numMetadataHoisted == 1 ? "" : "s",
+               fn->name, loopLoc->fname(), loopLoc->linenum());
+      }
+    }
+
     freeLocalDefUseMaps(localDefMap, localUseMap);
   }
   numLoops += loops.size();
@@ -20,11 +20,16 @@
 #include "optimizations.h"
 
 #include "astutil.h"
+#include "bb.h"
 #include "driver.h"
 #include "expr.h"
 #include "passes.h"
 #include "stlUtil.h"
 #include "stmt.h"
+#include "UnmanagedClassType.h"
+
+#include <map>
+#include <set>
 
 // We can remove the calls to chpl__initCopy (should actually be chpl__autoCopy)
 // and corresponding calls to chpl__autoDestroy for Plain-Old-Data (POD) types.
@@ -93,6 +98,476 @@ static void removePODinitDestroy()
 }
 
 
+//
+// Copy elision for values that are dead after they are copied.
+//
+// A copy of a local variable 'a' into 'b', either through an
+// initCopy/autoCopy call or through a compiler-generated copy
+// initializer, can instead transfer ownership of 'a' to 'b' when 'a'
+// is not used again before its (single) autoDestroy.  The copy becomes
+// a move and the autoDestroy of 'a' is dropped.
+//
+// Whether 'a' is dead after the copy is determined by walking the
+// basic blocks reachable from the copy, so copies inside loops or
+// followed on any path by another use of 'a' are left alone.  Symbols
+// that may alias 'a' (references, member accesses, shallow copies) are
+// tracked as uses of 'a' as well.
+//
+
+static std::map<Type*, bool> movableTypes;
+
+static bool isMovableType(Type* t);
+
+static bool isMovableArrayType(AggregateType* at) {
+  Symbol* instance = at->getField("_instance", false);
+  if (instance == NULL)
+    return false;
+
+  AggregateType* instanceType = toAggregateType(canonicalClassType(instance->type));
+  if (instanceType == NULL)
+    return false;
+
+  // Only handle arrays whose elements are stored in a single data class,
+  // so that the element type is known.
+  for_fields(field, instanceType) {
+    if (field->type->symbol->hasFlag(FLAG_DATA_CLASS)) {
+      TypeSymbol* eltType = getDataClassType(field->type->symbol);
+      return eltType != NULL && isMovableType(eltType->type);
+    }
+  }
+
+  return false;
+}
+
+// Can a value of type 't' be moved bitwise instead of being copied and
+// destroyed, without skipping user-visible copy initializers or deinits?
+static bool isMovableType(Type* t) {
+  t = t->getValType();
+
+  std::map<Type*, bool>::iterator it = movableTypes.find(t);
+  if (it != movableTypes.end())
+    return it->second;
+
+  // Assume true while visiting recursive types.
+  movableTypes[t] = true;
+
+  bool retval = false;
+
+  if (t == dtString) {
+    retval = true;
+
+  } else if (isClassLike(t)) {
+    retval = true;
+
+  } else if (AggregateType* at = toAggregateType(t)) {
+    TypeSymbol* ts = at->symbol;
+
+    if (ts->hasFlag(FLAG_ARRAY)) {
+      retval = isMovableArrayType(at);
+
+    } else if (!isRecord(at) ||
+               ts->hasFlag(FLAG_DOMAIN) ||
+               ts->hasFlag(FLAG_DISTRIBUTION) ||
+               ts->hasFlag(FLAG_ITERATOR_RECORD) ||
+               ts->hasFlag(FLAG_SYNC) ||
+               ts->hasFlag(FLAG_SINGLE) ||
+               ts->hasFlag(FLAG_ATOMIC_TYPE) ||
+               isManagedPtrType(at)) {
+      retval = false;
+
+    } else {
+      retval = true;
+
+      // Copy initializers and deinitializers must be compiler-generated.
+      forv_Vec(FnSymbol, method, at->methods) {
+        if (method != NULL &&
+            !method->hasFlag(FLAG_COMPILER_GENERATED) &&
+            (method->isInitializer() ||
+             method->hasFlag(FLAG_DESTRUCTOR))) {
+          retval = false;
+          break;
+        }
+      }
+
+      if (retval) {
+        for_fields(field, at) {
+          if (!isPOD(field->type) && !isMovableType(field->type)) {
+            retval = false;
+            break;
+          }
+        }
+      }
+    }
+
+  } else {
+    retval = isPOD(t);
+  }
+
+  movableTypes[t] = retval;
+
+  return retval;
+}
+
+static bool isTrueActual(Expr* actual) {
+  if (SymExpr* se = toSymExpr(actual)) {
+    if (se->symbol() == gTrue)
+      return true;
+
+    if (VarSymbol* var = toVarSymbol(se->symbol()))
+      if (var->immediate != NULL &&
+          var->immediate->const_kind == NUM_KIND_BOOL &&
+          var->immediate->bool_value() == true)
+        return true;
+  }
+
+  return false;
+}
+
+//
+// If 'call' copies a variable, return the variable being copied.
+//
+// Handles
+//   (move b (chpl__initCopy a)) / (move b (chpl__autoCopy a))
+//   (call init b a)             -- compiler-generated copy initializer
+//   (call init b a true)        -- string copy initializer
+//
+static Symbol* copiedSymbol(CallExpr* call) {
+  FnSymbol* fn = call->resolvedFunction();
+
+  if (fn == NULL)
+    return NULL;
+
+  if (fn->hasFlag(FLAG_INIT_COPY_FN) || fn->hasFlag(FLAG_AUTO_COPY_FN)) {
+    CallExpr* move = toCallExpr(call->parentExpr);
+
+    if (call->numActuals() != 1 ||
+        move == NULL || !isMoveOrAssign(move) ||
+        fn->getFormal(1)->type != fn->retType)
+      return NULL;
+
+    if (SymExpr* lhs = toSymExpr(move->get(1)))
+      if (lhs->symbol()->hasFlag(FLAG_NECESSARY_AUTO_COPY))
+        return NULL;
+
+    if (SymExpr* actual = toSymExpr(call->get(1)))
+      return actual->symbol();
+
+  } else if (fn->isInitializer() && call->getStmtExpr() == call) {
+    SymExpr* lhs = toSymExpr(call->get(1));
+    SymExpr* rhs = call->numActuals() >= 2 ? toSymExpr(call->get(2)) : NULL;
+
+    if (lhs == NULL || rhs == NULL ||
+        lhs->symbol()->type->getValType() != rhs->symbol()->type->getValType())
+      return NULL;
+
+    Type* t = rhs->symbol()->type->getValType();
+
+    if (call->numActuals() == 2 && isRecord(t) &&
+        fn->hasFlag(FLAG_COMPILER_GENERATED))
+      return rhs->symbol();
+
+    if (call->numActuals() == 3 && t == dtString && isTrueActual(call->get(3)))
+      return rhs->symbol();
+  }
+
+  return NULL;
+}
+
+static bool isAutoDestroyOf(CallExpr* call, Symbol* sym) {
+  FnSymbol* fn = call->resolvedFunction();
+
+  if (fn != NULL && fn->hasFlag(FLAG_AUTO_DESTROY_FN) &&
+      call->numActuals() == 1)
+    if (SymExpr* se = toSymExpr(call->get(1)))
+      return se->symbol() == sym;
+
+  return false;
+}
+
+// Does the value of 'call' possibly refer to the memory of its actuals?
+static bool resultMayAlias(CallExpr* call, Symbol* result) {
+  if (result->isRef() || isClassLike(result->type->getValType()))
+    return true;
+
+  if (call->isPrimitive())
+    return !isPOD(result->type);
+
+  FnSymbol* fn = call->resolvedFunction();
+
+  if (fn == NULL || fn->retTag == RET_REF ||
+      fn->hasFlag(FLAG_RETURNS_ALIASING_ARRAY))
+    return true;
+
+  // A copy owns its value; anything else that is not POD, e.g. a string
+  // that borrows the buffer of an actual or an array view, may not.
+  if (fn->hasFlag(FLAG_INIT_COPY_FN) || fn->hasFlag(FLAG_AUTO_COPY_FN))
+    return false;
+
+  return !isPOD(result->type->getValType());
+}
+
+//
+// Strings and arrays may borrow their buffer or elements from another
+// value (isowned == false, _unowned == true).  Moving such a value would
+// hand memory that it does not own to the destination, so only values
+// that are known to be owned are moved: copies and default-initialized
+// values.
+//
+static bool isKnownOwned(Symbol* sym) {
+  Type* t      = sym->type->getValType();
+  bool  retval = true;
+
+  if (t == dtString || t->symbol->hasFlag(FLAG_ARRAY)) {
+    for_SymbolDefs(def, sym) {
+      CallExpr* parent = toCallExpr(def->parentExpr);
+      CallExpr* rhs    = NULL;
+      FnSymbol* fn     = NULL;
+
+      if (parent != NULL && isMoveOrAssign(parent) && def == parent->get(1))
+        rhs = toCallExpr(parent->get(2));
+
+      if (rhs != NULL)
+        fn = rhs->resolvedFunction();
+
+      if (fn != NULL &&
+          (fn->hasFlag(FLAG_INIT_COPY_FN) || fn->hasFlag(FLAG_AUTO_COPY_FN))) {
+        // A copy owns its value.
+
+      } else if (parent                     != NULL &&
+                 parent->resolvedFunction() != NULL &&
+                 parent->resolvedFunction()->isInitializer() &&
+                 def == parent->get(1) &&
+                 (parent->numActuals() == 1 || copiedSymbol(parent) != NULL)) {
+        // Default-initialized, or copy-initialized.
+
+      } else {
+        retval = false;
+        break;
+      }
+    }
+  }
+
+  return retval;
+}
+
+//
+// Collect 'sym' and the symbols that may alias it into 'aliases'.
+// Returns false if 'sym' escapes in a way that cannot be tracked.
+//
+static bool collectAliases(Symbol* sym, std::set<Symbol*>& aliases) {
+  std::vector<Symbol*> worklist;
+
+  aliases.insert(sym);
+  worklist.push_back(sym);
+
+  while (!worklist.empty()) {
+    Symbol* cur = worklist.back();
+
+    worklist.pop_back();
+
+    for_SymbolSymExprs(se, cur) {
+      CallExpr* parent = toCallExpr(se->parentExpr);
+
+      if (parent == NULL)
+        continue;
+
+      Symbol* result = NULL;
+
+      if (isMoveOrAssign(parent)) {
+        // (move cur ...) defines 'cur'; (move x cur) shallow copies it.
+        if (se == parent->get(2))
+          if (SymExpr* lhs = toSymExpr(parent->get(1)))
+            result = lhs->symbol();
+
+      } else {
+        CallExpr* move = toCallExpr(parent->parentExpr);
+
+        if (move != NULL && isMoveOrAssign(move) && parent == move->get(2)) {
+          SymExpr* lhs = toSymExpr(move->get(1));
+
+          if (lhs != NULL && resultMayAlias(parent, lhs->symbol()))
+            result = lhs->symbol();
+
+        } else if (parent->isPrimitive(PRIM_ADDR_OF) ||
+                   parent->isPrimitive(PRIM_SET_REFERENCE) ||
+                   parent->isPrimitive(PRIM_GET_MEMBER) ||
+                   parent->isPrimitive(PRIM_GET_SVEC_MEMBER)) {
+          // A reference that is consumed in some other way.
+          return false;
+
+        } else if (FnSymbol* fn = parent->resolvedFunction()) {
+          // Asynchronous tasks may use 'cur' at any later time.
+          if (fn->hasFlag(FLAG_BEGIN))
+            return false;
+        }
+      }
+
+      if (result != NULL && aliases.count(result) == 0) {
+        aliases.insert(result);
+        worklist.push_back(result);
+      }
+    }
+  }
+
+  return true;
+}
+
+static bool usesAlias(Expr* expr,
+                      std::set<Symbol*>& aliases,
+                      CallExpr* destroy) {
+  std::vector<SymExpr*> symExprs;
+
+  collectSymExprs(expr, symExprs);
+
+  for_vector(SymExpr, se, symExprs) {
+    if (se->parentExpr != destroy && aliases.count(se->symbol()) != 0)
+      return true;
+  }
+
+  return false;
+}
+
+// Is any alias used on some path starting just after 'stmt'?
+static bool isUsedAfter(FnSymbol* fn,
+                        Expr* stmt,
+                        std::set<Symbol*>& aliases,
+                        CallExpr* destroy) {
+  BasicBlock* start = NULL;
+  size_t      index = 0;
+
+  for_vector(BasicBlock, bb, *fn->basicBlocks) {
+    for (size_t i = 0; i < bb->exprs.size() && start == NULL; i++) {
+      if (bb->exprs[i] == stmt) {
+        start = bb;
+        index = i;
+      }
+    }
+  }
+
+  if (start == NULL)
+    return true;
+
+  for (size_t i = index + 1; i < start->exprs.size(); i++)
+    if (usesAlias(start->exprs[i], aliases, destroy))
+      return true;
+
+  std::set<BasicBlock*>    visited;
+  std::vector<BasicBlock*> worklist(start->outs.begin(), start->outs.end());
+
+  while (!worklist.empty()) {
+    BasicBlock* bb = worklist.back();
+
+    worklist.pop_back();
+
+    if (visited.insert(bb).second == false)
+      continue;
+
+    for_vector(Expr, expr, bb->exprs)
+      if (usesAlias(expr, aliases, destroy))
+        return true;
+
+    for_vector(BasicBlock, out, bb->outs)
+      worklist.push_back(out);
+  }
+
+  return false;
+}
+
+// Returns the number of copies elided in 'fn'.
+static int elideCopiesInFunction(FnSymbol* fn) {
+  std::vector<CallExpr*> calls;
+  int                    numElided = 0;
+  bool                   needBasicBlocks = true;
+
+  collectCallExprs(fn, calls);
+
+  for_vector(CallExpr, call, calls) {
+    if (call->parentSymbol == NULL)
+      continue;
+
+    Symbol* sym = copiedSymbol(call);
+
+    if (sym == NULL || !isVarSymbol(sym) || sym->isRef() ||
+        sym->defPoint->getFunction() != fn ||
+        sym->hasFlag(FLAG_NO_AUTO_DESTROY) ||
+        !isMovableType(sym->type) ||
+        !isKnownOwned(sym))
+      continue;
+
+    Expr*     stmt    = call->getStmtExpr();
+    CallExpr* destroy = NULL;
+    int       numDestroys = 0;
+
+    for_SymbolSymExprs(se, sym) {
+      CallExpr* parent = toCallExpr(se->parentExpr);
+
+      if (parent != NULL && isAutoDestroyOf(parent, sym)) {
+        destroy = parent;
+        numDestroys++;
+      }
+    }
+
+    // The single autoDestroy must end the lifetime of 'sym' in the block
+    // that contains the copy.
+    if (numDestroys != 1 || destroy->parentExpr != stmt->parentExpr)
+      continue;
+
+    std::set<Symbol*> aliases;
+
+    if (!collectAliases(sym, aliases))
+      continue;
+
+    if (needBasicBlocks) {
+      BasicBlock::buildBasicBlocks(fn);
+      needBasicBlocks = false;
+    }
+
+    if (isUsedAfter(fn, stmt, aliases, destroy))
+      continue;
+
+    SET_LINENO(call);
+
+    if (call->isResolved() && call->resolvedFunction()->isInitializer()) {
+      Expr* lhs = call->get(1)->remove();
+      Expr* rhs = call->get(1)->remove();
+
+      call->replace(new CallExpr(PRIM_MOVE, lhs, rhs));
+
+    } else {
+      call->replace(new SymExpr(sym));
+    }
+
+    destroy->remove();
+
+    needBasicBlocks = true;
+    numElided++;
+  }
+
+  return numElided;
+}
+
+static void elideCopies() {
+  forv_Vec(FnSymbol, fn, gFnSymbols) {
+    if (fn->defPoint->parentSymbol == NULL)
+      continue;
+
+    int numElided = elideCopiesInFunction(fn);
+
+    if (numElided > 0 && fReportElidedCopies) {
+      ModuleSymbol* mod = fn->getModule();
+
+      if (developer || mod->modTag == MOD_USER) {
+        printf("Elided %d cop%s in function %s (%s:%d)\n",
+               numElided, numElided == 1 ? "y" : "ies",
+               fn->name, fn->fname(), fn->linenum());
+      }
+    }
+  }
+
+  movableTypes.clear();
+}
+
+
 void removeUnnecessaryAutoCopyCalls() {
   if (fNoRemoveCopyCalls)
     return;
@@ -102,4 +577,10 @@ void removeUnnecessaryAutoCopyCalls() {
   // primitive types
   //
   removePODinitDestroy();
+
+  //
+  // turn copies of values that are dead afterwards into moves
+  //
+  if (!fNoCopyElision)
+    elideCopies();
 }
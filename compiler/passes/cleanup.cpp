@@ -58,6 +58,8 @@ void cleanup() {
   for_vector(ModuleSymbol, mod, mods) {
     cleanup(mod);
   }
+
+  pruneStandardFunctions();
 }
 
 /************************************* | **************************************
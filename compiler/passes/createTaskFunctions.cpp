@@ -257,7 +257,7 @@ I.e. add the following to the AST:
     delete currOp;
 
 * after 'call' and its _waitEndCount()
-    origSym = parentOp.generate();
+    origSym = chpl__reduceGenerate(parentOp);
     delete parentOp;
 
 Put in a different way, a coforall like this:
@@ -297,7 +297,7 @@ is transformed into
 
     call coforall_fn(globalOp);
     // wait for endCount - not shown
-    x = globalOp.generate();
+    x = chpl__reduceGenerate(globalOp);
     delete globalOp;
 
 Todo: to support cobegin constructs, need to share 'globalOp'
@@ -354,8 +354,8 @@ static void addReduceIntentSupport(FnSymbol* fn, CallExpr* call,
   // Can't insertBefore() on tailAnchor->next - that can be NULL.
   tailAnchor->insertAfter("chpl__delete(%S)",
                          globalOp);
-  tailAnchor->insertAfter("'='(%S, generate(%S,%S))",
-                         origSym, gMethodToken, globalOp);
+  tailAnchor->insertAfter("'='(%S, chpl__reduceGenerate(%S))",
+                         origSym, globalOp);
 
   ArgSymbol* parentOp = new ArgSymbol(INTENT_BLANK, "reduceParent", dtUnknown);
   newFormal = parentOp;
@@ -0,0 +1,259 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// pruneStandardFunctions
+//
+// Every program parses most of the standard modules, but uses only a small
+// part of them.  Scope resolution, normalization and the default function
+// builder all process every function that was parsed, so the unused ones
+// cost compile time long before resolution and the later prune pass can
+// tell that they are dead.
+//
+// This removes the module-level functions and methods of the standard
+// modules whose names cannot be called by the program, right after
+// cleanup.  Names are all that is known at this point, so this is
+// conservative: a function is kept if any reachable code mentions its
+// name as an identifier, a method name or a string literal, and the
+// names reachable from a kept function are followed in turn.  Functions
+// that the compiler or runtime may call without the program naming them
+// are always kept.
+//
+// Only the standard modules are trimmed; internal and user modules are
+// processed in full as before.  The pass is off by default and enabled
+// with --prune-standard-functions.
+//
+
+#include "passes.h"
+
+#include "astutil.h"
+#include "CatchStmt.h"
+#include "CForLoop.h"
+#include "DeferStmt.h"
+#include "docsDriver.h"
+#include "driver.h"
+#include "expr.h"
+#include "ForallStmt.h"
+#include "ForLoop.h"
+#include "IfExpr.h"
+#include "LoopExpr.h"
+#include "ParamForLoop.h"
+#include "stlUtil.h"
+#include "stmt.h"
+#include "stringutil.h"
+#include "symbol.h"
+#include "TryStmt.h"
+#include "UseStmt.h"
+#include "WhileStmt.h"
+
+#include <map>
+#include <set>
+
+typedef std::map<const char*, std::vector<FnSymbol*> > CandidateMap;
+
+static bool isCandidate(FnSymbol* fn);
+
+static bool isCompilerCalled(const char* name);
+
+static void collectNames(BaseAST*                  ast,
+                         std::set<FnSymbol*>&      candidates,
+                         std::vector<const char*>& names);
+
+void pruneStandardFunctions() {
+  std::set<FnSymbol*>      candidates;
+  CandidateMap             byName;
+  std::set<const char*>    seen;
+  std::vector<const char*> names;
+
+  if (fPruneStandardFunctions == false || fDocs == true || fUseIPE == true) {
+    return;
+  }
+
+  forv_Vec(FnSymbol, fn, gFnSymbols) {
+    if (fn->inTree() == true && isCandidate(fn) == true) {
+      candidates.insert(fn);
+      byName[fn->name].push_back(fn);
+    }
+  }
+
+  // Every module, including the module-level code of the standard
+  // modules, is reachable
+  collectNames(rootModule, candidates, names);
+
+  while (names.empty() == false) {
+    const char* name = names.back();
+
+    names.pop_back();
+
+    if (seen.insert(name).second == true) {
+      CandidateMap::iterator it = byName.find(name);
+
+      if (it != byName.end()) {
+        for_vector(FnSymbol, fn, it->second) {
+          candidates.erase(fn);
+
+          collectNames(fn, candidates, names);
+        }
+      }
+    }
+  }
+
+  for_set(FnSymbol, fn, candidates) {
+    // A primary method is also recorded by its type
+    if (fn->_this != NULL) {
+      Vec<FnSymbol*>& methods = fn->_this->type->methods;
+
+      for (int i = 0; i < methods.n; i++) {
+        if (methods.v[i] == fn) {
+          methods.remove(i);
+          break;
+        }
+      }
+    }
+
+    fn->defPoint->remove();
+  }
+}
+
+/************************************* | **************************************
+*                                                                             *
+* A function may be pruned if it is defined at the module level of a         *
+* standard module, or is a method that cleanup() has moved there, and it     *
+* can only be reached by name.                                                *
+*                                                                             *
+************************************** | *************************************/
+
+static bool isCandidate(FnSymbol* fn) {
+  ModuleSymbol* mod    = toModuleSymbol(fn->defPoint->parentSymbol);
+  bool          retval = false;
+
+  if (mod != NULL && mod->modTag == MOD_STANDARD) {
+    retval = fn->hasFlag(FLAG_EXPORT)             == false &&
+             fn->hasFlag(FLAG_EXTERN)             == false &&
+             fn->hasFlag(FLAG_COMPILER_GENERATED) == false &&
+             hasPragmaFlag(fn)                    == false &&
+             isCompilerCalled(fn->name)           == false;
+  }
+
+  return retval;
+}
+
+// Functions that the compiler creates calls to, or that the runtime calls,
+// by these names.  Names that start with '_' or 'chpl' and operators are
+// reserved for this, and are always kept.
+static bool isCompilerCalled(const char* name) {
+  static const char* names[] = {
+    "init",
+    "init=",
+    "postinit",
+    "deinit",
+    "this",
+    "these",
+    "size",
+    "readThis",
+    "writeThis",
+    "readWriteThis",
+    "main",
+    "halt",
+    "min",
+    "max",
+    "isArray",
+    "isDomain",
+    "isTuple",
+    "isType",
+    NULL
+  };
+
+  bool retval = false;
+
+  if (name[0] == '_' || strncmp(name, "chpl", 4) == 0) {
+    retval = true;
+
+  } else if (isalpha(name[0]) == false) {
+    retval = true;
+
+  } else {
+    for (int i = 0; names[i] != NULL && retval == false; i++) {
+      retval = strcmp(name, names[i]) == 0;
+    }
+  }
+
+  return retval;
+}
+
+/************************************* | **************************************
+*                                                                             *
+* Collect every name that ast mentions, without looking into the bodies of   *
+* the functions that have not been reached yet.                               *
+*                                                                             *
+************************************** | *************************************/
+
+static void collectNames(BaseAST*                  ast,
+                         std::set<FnSymbol*>&      candidates,
+                         std::vector<const char*>& names) {
+  if (DefExpr* def = toDefExpr(ast)) {
+    if (FnSymbol* fn = toFnSymbol(def->sym)) {
+      if (candidates.count(fn) != 0) {
+        return;
+      }
+    }
+
+  } else if (UnresolvedSymExpr* use = toUnresolvedSymExpr(ast)) {
+    names.push_back(use->unresolved);
+
+  } else if (SymExpr* se = toSymExpr(ast)) {
+    if (VarSymbol* var = toVarSymbol(se->symbol())) {
+      if (var->immediate                         != NULL &&
+          var->immediate->const_kind             == CONST_KIND_STRING) {
+        names.push_back(astr(var->immediate->v_string));
+      }
+
+    } else if (FnSymbol* fn = toFnSymbol(se->symbol())) {
+      names.push_back(fn->name);
+    }
+
+  } else if (UseStmt* use = toUseStmt(ast)) {
+    for_vector(const char, name, use->named) {
+      names.push_back(astr(name));
+    }
+
+    for (std::map<const char*, const char*>::iterator it =
+           use->renamed.begin();
+         it != use->renamed.end();
+         ++it) {
+      names.push_back(astr(it->first));
+      names.push_back(astr(it->second));
+    }
+
+  } else if (ForwardingStmt* fwd = toForwardingStmt(ast)) {
+    for_set(const char, name, fwd->named) {
+      names.push_back(astr(name));
+    }
+
+    for (std::map<const char*, const char*>::iterator it =
+           fwd->renamed.begin();
+         it != fwd->renamed.end();
+         ++it) {
+      names.push_back(astr(it->first));
+      names.push_back(astr(it->second));
+    }
+  }
+
+  AST_CHILDREN_CALL(ast, collectNames, candidates, names);
+}
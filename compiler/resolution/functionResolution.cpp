@@ -95,6 +95,73 @@ public:
 // map: (block id) -> (map: sym -> sym)
 typedef std::map<int, SymbolMap*> CapturedValueMap;
 
+// What disambiguation depends on: the scope of the call, the applicable
+// candidates in the order they were gathered, and the name, type and
+// param value of each actual.
+struct DisambiguationKey {
+  Expr*                    scope;
+  std::vector<FnSymbol*>   fns;
+  std::vector<const char*> names;
+  std::vector<Type*>       types;
+  std::vector<void*>       values;
+
+  bool operator<(const DisambiguationKey& other) const {
+    if (scope != other.scope) return scope < other.scope;
+    if (fns   != other.fns)   return fns   < other.fns;
+    if (names != other.names) return names < other.names;
+    if (types != other.types) return types < other.types;
+
+    return values < other.values;
+  }
+};
+
+// The outcome of disambiguateByMatch(), as indices into the candidates
+struct DisambiguationResult {
+  int numMatches;
+  int bestRef;
+  int bestConstRef;
+  int bestValue;
+};
+
+typedef std::map<DisambiguationKey, DisambiguationResult> DisambiguationCache;
+
+// A coarse classification of the type of an argument.  An actual can
+// only dispatch to a formal in the same category, unless either of them
+// is ARG_ANY.
+enum ArgCategory {
+  ARG_ANY,
+  ARG_NUMERIC,
+  ARG_RECORD,
+  ARG_CLASS,
+  ARG_C_PTR,
+  ARG_STRING,
+  ARG_NIL
+};
+
+// The categories of the first two arguments of a call or the first two
+// formals of a function, not counting the method token.  Two are kept so
+// that the value argument of calls like _cast(type t, x) and the second
+// operand of binary operators are also compared.
+struct ArgCategories {
+  bool        hasMethodToken;
+  ArgCategory category[2];
+};
+
+typedef std::map<FnSymbol*, ArgCategories> FormalCategoryIndex;
+
+// Counts for --report-resolution-candidates
+struct CandidateStats {
+  long numCalls;
+  long numVisible;
+  long numFiltered;
+  long numFilteredByCategory;
+  long numChecked;
+  long numApplicable;
+  long numDisambiguated;
+  long numCacheHits;
+  long maxVisible;
+};
+
 //#
 //# Global Variables
 //#
@@ -147,6 +214,12 @@ static std::map<FnSymbol*, const char*> outerCompilerErrorMap;
 
 static CapturedValueMap            capturedValues;
 
+static DisambiguationCache         disambiguationCache;
+
+static FormalCategoryIndex         formalCategories;
+
+static CandidateStats              candidateStats;
+
 
 //#
 //# Static Function Declarations
@@ -2859,7 +2932,10 @@ static void gatherCandidates(CallInfo&                  info,
                              bool                       lastResort,
                              Vec<ResolutionCandidate*>& candidates);
 
+static void findActualCategories(CallInfo& info, ArgCategories& cats);
+
 static void filterCandidate (CallInfo&                  info,
+                             const ArgCategories&       actualCats,
                              FnSymbol*                  fn,
                              Vec<ResolutionCandidate*>& candidates);
 
@@ -2953,6 +3029,15 @@ static void findVisibleFunctionsAndCandidates(
     findVisibleFunctions(info, visibleFns);
   }
 
+  if (fReportResolutionCandidates == true) {
+    candidateStats.numCalls   = candidateStats.numCalls   + 1;
+    candidateStats.numVisible = candidateStats.numVisible + visibleFns.n;
+
+    if (visibleFns.n > candidateStats.maxVisible) {
+      candidateStats.maxVisible = visibleFns.n;
+    }
+  }
+
   trimVisibleCandidates(info, mostApplicable, visibleFns);
 
   findVisibleCandidates(info, mostApplicable, candidates);
@@ -2976,6 +3061,10 @@ static void gatherCandidates(CallInfo&                  info,
                              Vec<FnSymbol*>&            visibleFns,
                              bool                       lastResort,
                              Vec<ResolutionCandidate*>& candidates) {
+  ArgCategories actualCats;
+
+  findActualCategories(info, actualCats);
+
   forv_Vec(FnSymbol, fn, visibleFns) {
     // Only consider functions marked with/without FLAG_LAST_RESORT
     // (where existence of the flag matches the lastResort argument)
@@ -3008,23 +3097,27 @@ static void gatherCandidates(CallInfo&                  info,
       //
 
       if (info.call->methodTag == false) {
-        filterCandidate(info, fn, candidates);
+        filterCandidate(info, actualCats, fn, candidates);
 
       } else {
         if (fn->hasFlag(FLAG_NO_PARENS)        == true ||
             fn->hasFlag(FLAG_TYPE_CONSTRUCTOR) == true) {
-          filterCandidate(info, fn, candidates);
+          filterCandidate(info, actualCats, fn, candidates);
         }
       }
     }
   }
 }
 
+static bool isShapeCompatible(CallInfo& info, FnSymbol* fn);
+
+static bool isCategoryCompatible(const ArgCategories& actualCats,
+                                 FnSymbol*            fn);
+
 static void filterCandidate(CallInfo&                  info,
+                            const ArgCategories&       actualCats,
                             FnSymbol*                  fn,
                             Vec<ResolutionCandidate*>& candidates) {
-  ResolutionCandidate* candidate = new ResolutionCandidate(fn);
-
   if (fExplainVerbose &&
       ((explainCallLine && explainCallMatch(info.call)) ||
        info.call->id == explainCallID)) {
@@ -3035,11 +3128,108 @@ static void filterCandidate(CallInfo&                  info,
     }
   }
 
-  if (candidate->isApplicable(info) == true) {
-    candidates.add(candidate);
+  if (isShapeCompatible(info, fn) == false) {
+    if (fReportResolutionCandidates == true) {
+      candidateStats.numFiltered = candidateStats.numFiltered + 1;
+    }
+
+  } else if (isCategoryCompatible(actualCats, fn) == false) {
+    if (fReportResolutionCandidates == true) {
+      candidateStats.numFilteredByCategory =
+        candidateStats.numFilteredByCategory + 1;
+    }
+
   } else {
-    delete candidate;
+    ResolutionCandidate* candidate = new ResolutionCandidate(fn);
+
+    if (fReportResolutionCandidates == true) {
+      candidateStats.numChecked = candidateStats.numChecked + 1;
+    }
+
+    if (candidate->isApplicable(info) == true) {
+      if (fReportResolutionCandidates == true) {
+        candidateStats.numApplicable = candidateStats.numApplicable + 1;
+      }
+
+      candidates.add(candidate);
+
+    } else {
+      delete candidate;
+    }
+  }
+}
+
+//
+// A quick check that rejects the functions that computeAlignment() and
+// checkGenericFormals() would reject on the shape of the call alone,
+// before a ResolutionCandidate is built and the formals' types are
+// resolved: the number of actuals, the method token, and, for generic
+// functions called with positional actuals, which actuals are types.
+// Functions with a varargs formal are always left to isApplicable().
+//
+static bool isShapeCompatible(CallInfo& info, FnSymbol* fn) {
+  int  numRequired  = 0;
+  bool hasVarArgs   = false;
+  bool hasNamed     = false;
+  bool hasMethodTok = false;
+  bool retval       = true;
+
+  for_formals(formal, fn) {
+    if (formal->variableExpr != NULL) {
+      hasVarArgs = true;
+
+    } else if (formal->defaultExpr == NULL) {
+      numRequired++;
+    }
+  }
+
+  for (int i = 0; i < info.actuals.n; i++) {
+    if (info.actualNames.v[i] != NULL) {
+      hasNamed = true;
+    }
+
+    if (info.actuals.v[i]->type == dtMethodToken) {
+      hasMethodTok = true;
+    }
+  }
+
+  if (hasVarArgs == true) {
+    retval = true;
+
+  } else if (info.actuals.n < numRequired) {
+    retval = false;
+
+  } else if (hasNamed                   == false            &&
+             info.actuals.n             >  fn->numFormals() &&
+             (fn->hasFlag(FLAG_GENERIC) == false            ||
+              (fn->hasFlag(FLAG_INIT_TUPLE) == false &&
+               isTupleTypeConstructor(fn)   == false))) {
+    retval = false;
+
+  } else if (fn->numFormals()           >  0             &&
+             fn->getFormal(1)->type     == dtMethodToken &&
+             hasMethodTok               == false) {
+    retval = false;
+
+  } else if (fn->hasFlag(FLAG_GENERIC) == true && hasNamed == false) {
+    int i = 0;
+
+    for_formals(formal, fn) {
+      if (i < info.actuals.n && formal->type != dtUnknown) {
+        Symbol* actual = info.actuals.v[i];
+
+        if (actual->hasFlag(FLAG_TYPE_VARIABLE) !=
+            formal->hasFlag(FLAG_TYPE_VARIABLE)) {
+          retval = false;
+          break;
+        }
+      }
+
+      i++;
+    }
   }
+
+  return retval;
 }
 
 static bool typeUsesForwarding(Type* t) {
@@ -3052,6 +3242,212 @@ static bool typeUsesForwarding(Type* t) {
   return retval;
 }
 
+//
+// Many overloads of an operator or a method have the same shape, e.g.
+// every binary +, so isShapeCompatible() cannot tell them apart.  This
+// check compares the categories of the first two actuals (starting with
+// the receiver, for a method call) with those of the formals they are
+// aligned with.
+//
+// The categories are conservative: an actual that might be promoted,
+// read out of a sync/single, borrowed from an owned/shared, or forwarded
+// is ARG_ANY, as is nil and a formal that is fully generic or whose type
+// is not known yet.  Numeric coercions, class-to-parent coercions, tuple
+// coercions, c_ptr to c_void_ptr, param string to c_string, and the
+// instantiation of generic formals such as int(?w), integral or borrowed
+// all stay within one category.
+//
+static ArgCategory typeCategory(Type* t, bool isActual) {
+  ArgCategory retval = ARG_ANY;
+
+  t = t->getValType();
+
+  if (isActual == true && t->scalarPromotionType != NULL) {
+    retval = ARG_ANY;
+
+  } else if (is_bool_type(t)    == true ||
+             is_int_type(t)     == true ||
+             is_uint_type(t)    == true ||
+             is_real_type(t)    == true ||
+             is_imag_type(t)    == true ||
+             is_complex_type(t) == true ||
+             is_enum_type(t)    == true ||
+             t == dtAnyBool             ||
+             t == dtIntegral            ||
+             t == dtNumeric             ||
+             t == dtAnyEnumerated       ||
+             t == dtAnyReal             ||
+             t == dtAnyImag             ||
+             t == dtAnyComplex) {
+    retval = ARG_NUMERIC;
+
+  } else if (t == dtString || t == dtStringC) {
+    retval = ARG_STRING;
+
+  } else if (t == dtNil) {
+    // nil can be passed to a class, c_ptr or owned/shared formal
+    retval = (isActual == true) ? ARG_ANY : ARG_NIL;
+
+  } else if (t                                    == dtCVoidPtr ||
+             t->symbol->hasFlag(FLAG_C_PTR_CLASS) == true) {
+    retval = ARG_C_PTR;
+
+  } else if (isUnmanagedClassType(t) == true        ||
+             t                       == dtUnmanaged ||
+             t                       == dtBorrowed) {
+    retval = ARG_CLASS;
+
+  } else if (AggregateType* at = toAggregateType(t)) {
+    if (isActual == true &&
+        (typeUsesForwarding(at) == true ||
+         isManagedPtrType(at)   == true ||
+         isSyncType(at)         == true ||
+         isSingleType(at)       == true)) {
+      retval = ARG_ANY;
+
+    } else if (at->symbol->hasFlag(FLAG_EXTERN)          == true ||
+               at->symbol->hasFlag(FLAG_ITERATOR_CLASS)  == true ||
+               at->symbol->hasFlag(FLAG_ITERATOR_RECORD) == true) {
+      retval = ARG_ANY;
+
+    } else if (at->isClass() == true) {
+      retval = ARG_CLASS;
+
+    } else if (at->isRecord() == true) {
+      retval = ARG_RECORD;
+    }
+  }
+
+  return retval;
+}
+
+static ArgCategory actualCategory(Symbol* actual) {
+  ArgCategory retval = ARG_ANY;
+
+  if (actual->hasFlag(FLAG_TYPE_VARIABLE) == false) {
+    retval = typeCategory(actual->type, true);
+  }
+
+  return retval;
+}
+
+// Before the signature is resolved, and for formals like int(?w) that
+// normalize() reduces to their base type, the type is still in typeExpr
+static ArgCategory formalCategory(ArgSymbol* formal) {
+  ArgCategory retval = ARG_ANY;
+
+  if (formal->hasFlag(FLAG_TYPE_VARIABLE) == true ||
+      formal->variableExpr                != NULL) {
+    retval = ARG_ANY;
+
+  } else if (formal->type != dtUnknown) {
+    retval = typeCategory(formal->type, false);
+
+  } else if (formal->typeExpr != NULL) {
+    if (SymExpr* se = toSymExpr(formal->typeExpr->body.tail)) {
+      if (TypeSymbol* ts = toTypeSymbol(se->symbol())) {
+        retval = typeCategory(ts->type, false);
+      }
+    }
+  }
+
+  return retval;
+}
+
+static void findActualCategories(CallInfo& info, ArgCategories& cats) {
+  int  index    = 0;
+  bool hasNamed = false;
+
+  if (info.actuals.n > 0 && info.actuals.v[0]->type == dtMethodToken) {
+    index = 1;
+  }
+
+  for (int i = 0; i < info.actuals.n; i++) {
+    if (info.actualNames.v[i] != NULL) {
+      hasNamed = true;
+    }
+  }
+
+  cats.hasMethodToken = (index == 1) ? true : false;
+
+  for (int i = 0; i < 2; i++) {
+    cats.category[i] = ARG_ANY;
+
+    // Named actuals may be aligned with any formal
+    if (hasNamed == false && index + i < info.actuals.n) {
+      cats.category[i] = actualCategory(info.actuals.v[index + i]);
+    }
+  }
+}
+
+static void findFormalCategories(FnSymbol* fn, ArgCategories& cats) {
+  FormalCategoryIndex::iterator it = formalCategories.find(fn);
+
+  if (it != formalCategories.end()) {
+    cats = it->second;
+
+  } else {
+    int  index      = 0;
+    bool isFinal    = true;
+    bool hasVarArgs = false;
+
+    if (fn->numFormals() > 0 && fn->getFormal(1)->type == dtMethodToken) {
+      index = 1;
+    }
+
+    cats.hasMethodToken = (index == 1) ? true : false;
+
+    for (int i = 0; i < 2; i++) {
+      cats.category[i] = ARG_ANY;
+
+      if (index + i < fn->numFormals() && hasVarArgs == false) {
+        ArgSymbol* formal = fn->getFormal(index + i + 1);
+
+        cats.category[i] = formalCategory(formal);
+
+        // Later actuals may be gathered into a varargs formal
+        if (formal->variableExpr != NULL) {
+          hasVarArgs = true;
+        }
+
+        // ARG_ANY for a formal whose type is not resolved yet is not final
+        if (cats.category[i] == ARG_ANY && formal->type == dtUnknown) {
+          isFinal = false;
+        }
+      }
+    }
+
+    if (isFinal == true) {
+      formalCategories[fn] = cats;
+    }
+  }
+}
+
+static bool isCategoryCompatible(const ArgCategories& actualCats,
+                                 FnSymbol*            fn) {
+  bool retval = true;
+
+  if (actualCats.category[0] != ARG_ANY ||
+      actualCats.category[1] != ARG_ANY) {
+    ArgCategories formalCats;
+
+    findFormalCategories(fn, formalCats);
+
+    if (formalCats.hasMethodToken == actualCats.hasMethodToken) {
+      for (int i = 0; i < 2; i++) {
+        if (actualCats.category[i] != ARG_ANY &&
+            formalCats.category[i] != ARG_ANY &&
+            actualCats.category[i] != formalCats.category[i]) {
+          retval = false;
+          break;
+        }
+      }
+    }
+  }
+
+  return retval;
+}
+
 static const char* getForwardedMethodName(const char* calledName,
                                           ForwardingStmt* delegate) {
 
@@ -3355,13 +3751,62 @@ static int disambiguateByMatch(CallInfo&                  info,
 
   Vec<ResolutionCandidate*> ambiguous;
 
-  ResolutionCandidate*      best   = disambiguateByMatch(candidates,
-                                                         DC,
-                                                         true,
-                                                         ambiguous);
+  DisambiguationKey         key;
+
+  bool                      cache  = candidates.n > 1 && DC.explain == false;
+
+  ResolutionCandidate*      best   = NULL;
 
   int                       retval = 0;
 
+  if (cache == true) {
+    DisambiguationCache::iterator it;
+
+    key.scope = DC.scope;
+
+    forv_Vec(ResolutionCandidate*, candidate, candidates) {
+      key.fns.push_back(candidate->fn);
+    }
+
+    for (int i = 0; i < info.actuals.n; i++) {
+      Symbol* actual = info.actuals.v[i];
+
+      key.names.push_back(info.actualNames.v[i]);
+      key.types.push_back(actual->type);
+      key.values.push_back(getImmediate(actual) != NULL ? actual : NULL);
+    }
+
+    if (fReportResolutionCandidates == true) {
+      candidateStats.numDisambiguated = candidateStats.numDisambiguated + 1;
+    }
+
+    it = disambiguationCache.find(key);
+
+    if (it != disambiguationCache.end()) {
+      DisambiguationResult& result = it->second;
+
+      if (result.bestRef      >= 0) {
+        bestRef      = candidates.v[result.bestRef];
+      }
+
+      if (result.bestConstRef >= 0) {
+        bestConstRef = candidates.v[result.bestConstRef];
+      }
+
+      if (result.bestValue    >= 0) {
+        bestValue    = candidates.v[result.bestValue];
+      }
+
+      if (fReportResolutionCandidates == true) {
+        candidateStats.numCacheHits = candidateStats.numCacheHits + 1;
+      }
+
+      return result.numMatches;
+    }
+  }
+
+  best = disambiguateByMatch(candidates, DC, true, ambiguous);
+
   // The common case is that there is no ambiguity because the
   // return intent overload feature is not used.
   if (best != NULL) {
@@ -3495,6 +3940,17 @@ static int disambiguateByMatch(CallInfo&                  info,
     }
   }
 
+  if (cache == true) {
+    DisambiguationResult result;
+
+    result.numMatches   = retval;
+    result.bestRef      = candidates.index(bestRef);
+    result.bestConstRef = candidates.index(bestConstRef);
+    result.bestValue    = candidates.index(bestValue);
+
+    disambiguationCache[key] = result;
+  }
+
   return retval;
 }
 
@@ -7471,6 +7927,11 @@ void resolve() {
   if (fPrintUnusedFns || fPrintUnusedInternalFns)
     printUnusedFunctions();
 
+  // The functions that pruneResolvedTree() removes may be freed, and their
+  // addresses reused, before the next resolution
+  disambiguationCache.clear();
+  formalCategories.clear();
+
   pruneResolvedTree();
 
   resolveForallStmts2();
@@ -7480,6 +7941,25 @@ void resolve() {
   freeCache(genericsCache);
   freeCache(promotionsCache);
 
+  disambiguationCache.clear();
+  formalCategories.clear();
+
+  if (fReportResolutionCandidates == true) {
+    printf("RESOLUTION CANDIDATES: %ld calls\n", candidateStats.numCalls);
+    printf("\t%ld visible functions, at most %ld for one call\n",
+           candidateStats.numVisible,
+           candidateStats.maxVisible);
+    printf("\t%ld rejected by shape, %ld by argument category\n",
+           candidateStats.numFiltered,
+           candidateStats.numFilteredByCategory);
+    printf("\t%ld checked, %ld applicable\n",
+           candidateStats.numChecked,
+           candidateStats.numApplicable);
+    printf("\t%ld disambiguations, %ld from the cache\n",
+           candidateStats.numDisambiguated,
+           candidateStats.numCacheHits);
+  }
+
   visibleFunctionsClear();
 
   std::map<int, SymbolMap*>::iterator it;
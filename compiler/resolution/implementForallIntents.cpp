@@ -2039,7 +2039,7 @@ static void insertAndResolveInitialAccumulate(ForallStmt* fs, BlockStmt* hld,
   resolveFnForCall(initAccumOutcome, initAccum);
 }
 
-// Finalize the reduction:  outerVar = globalOp.generate()
+// Finalize the reduction:  outerVar = chpl__reduceGenerate(globalOp)
 static void insertFinalGenerate(Expr* ref, Symbol* fiVarSym, Symbol* globalOp) {
   Expr* next = ref->next; // nicer ordering of the following insertions
   INT_ASSERT(next);
@@ -2047,8 +2047,8 @@ static void insertFinalGenerate(Expr* ref, Symbol* fiVarSym, Symbol* globalOp) {
   // TODO: Should we try to free chpl_gentemp right after the assignment?
   genTemp->addFlag(FLAG_INSERT_AUTO_DESTROY);
   next->insertBefore(new DefExpr(genTemp));
-  next->insertBefore("'move'(%S, generate(%S,%S))",
-                     genTemp, gMethodToken, globalOp);
+  next->insertBefore("'move'(%S, chpl__reduceGenerate(%S))",
+                     genTemp, globalOp);
   next->insertBefore(new CallExpr("=", fiVarSym, genTemp));
 }
 
@@ -948,6 +948,64 @@ proc BlockCyclicArr.dsiSerialWrite(f) {
   }
 }
 
+// this = another distribution supporting bulk redistribution
+proc BlockCyclicArr.doiBulkTransferFromKnown(destDom, srcClass, srcDom) : bool
+where chpl__canBulkRedistribute(this, destDom, srcClass, srcDom) {
+  return bulkRedistribute(this, destDom, srcClass, srcDom);
+}
+
+proc BlockCyclicArr.doiCanBulkRedistribute() param return !stridable;
+
+proc LocBlockCyclicArr.redistChunksAreGlobal param return false;
+
+//
+// Yields the part of 'region' owned by this locale one block row at a
+// time.  'myElems' stores this locale's blocks densely in a flat index
+// space, so a row (along the last dimension) of a block is the largest
+// piece that is regular in both the global and the flat index space.
+//
+iter LocBlockCyclicArr.redistChunks(region) {
+  const globDims = indexDom.globDom.whole.dims();
+  for start in indexDom.myStarts {
+    const lo = chpl__tuplify(start);
+    var blockDims: rank*range(idxType);
+    for param d in 1..rank do
+      blockDims(d) = lo(d)..min(lo(d) + blocksize(d) - 1, globDims(d).high);
+
+    const block = {(...blockDims)},
+          inters = block[region];
+    if inters.numIndices == 0 then continue;
+
+    const lastDim = inters.dim(rank),
+          len = lastDim.length,
+          str = lastDim.stride:int;
+
+    if rank == 1 {
+      const flatLo = mdInd2FlatInd(lastDim.first);
+      yield (inters, {flatLo..flatLo + (len-1)*str by str});
+    } else {
+      var outerDims: (rank-1)*inters.dim(1).type;
+      for param d in 1..rank-1 do
+        outerDims(d) = inters.dim(d);
+
+      for coord in {(...outerDims)} {
+        const c = chpl__tuplify(coord);
+        var rowDims: rank*inters.dim(1).type;
+        var first: rank*idxType;
+        for param d in 1..rank-1 {
+          rowDims(d) = c(d)..c(d);
+          first(d) = c(d);
+        }
+        rowDims(rank) = lastDim;
+        first(rank) = lastDim.first;
+
+        const flatLo = mdInd2FlatInd(first);
+        yield ({(...rowDims)}, {flatLo..flatLo + (len-1)*str by str});
+      }
+    }
+  }
+}
+
 proc BlockCyclicArr.dsiTargetLocales() {
   return dom.dist.targetLocales;
 }
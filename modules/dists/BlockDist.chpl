@@ -1316,7 +1316,9 @@ private proc _canDoSimpleBlockTransfer(A, aView, B, bView) {
 // Block = this
 proc BlockArr.doiBulkTransferToKnown(srcDom, destClass:BlockArr, destDom) : bool
 where useBulkTransferDist {
-  if _canDoSimpleBlockTransfer(destClass, destDom, this, srcDom) {
+  if !destClass.dom.dist.dsiEqualDMaps(this.dom.dist) {
+    return bulkRedistribute(destClass, destDom, this, srcDom);
+  } else if _canDoSimpleBlockTransfer(destClass, destDom, this, srcDom) {
     _doSimpleBlockTransfer(destClass, destDom, this, srcDom);
     return true;
   } else {
@@ -1327,7 +1329,9 @@ where useBulkTransferDist {
 // this = Block
 proc BlockArr.doiBulkTransferFromKnown(destDom, srcClass:BlockArr, srcDom) : bool
 where useBulkTransferDist {
-  if _canDoSimpleBlockTransfer(this, destDom, srcClass, srcDom) {
+  if !this.dom.dist.dsiEqualDMaps(srcClass.dom.dist) {
+    return bulkRedistribute(this, destDom, srcClass, srcDom);
+  } else if _canDoSimpleBlockTransfer(this, destDom, srcClass, srcDom) {
     _doSimpleBlockTransfer(this, destDom, srcClass, srcDom);
     return true;
   } else {
@@ -1335,6 +1339,24 @@ where useBulkTransferDist {
   }
 }
 
+// this = another distribution supporting bulk redistribution
+proc BlockArr.doiBulkTransferFromKnown(destDom, srcClass, srcDom) : bool
+where chpl__canBulkRedistribute(this, destDom, srcClass, srcDom) {
+  return bulkRedistribute(this, destDom, srcClass, srcDom);
+}
+
+proc BlockArr.doiCanBulkRedistribute() param return true;
+
+proc LocBlockArr.redistChunksAreGlobal param return true;
+
+// Yields the part of 'region' owned by this locale, which is stored
+// in 'myElems' under its global indices.
+iter LocBlockArr.redistChunks(region) {
+  const inters = locDom.myBlock[region];
+  if inters.numIndices > 0 then
+    yield (inters, inters);
+}
+
 private proc _doSimpleBlockTransfer(Dest, destDom, Src, srcDom) {
   if debugBlockDistBulkTransfer then
     writeln("In BlockDist._doSimpleBlockTransfer");
@@ -1399,6 +1421,50 @@ private proc _doSimpleBlockTransfer(Dest, destDom, Src, srcDom) {
   if debugBlockDistBulkTransfer then writeln("Comms:",getCommDiagnostics());
 }
 
+//
+// Scan a 1-D Block array into a new array over the same domain.  Each
+// locale scans its own block in parallel, the locale totals are scanned
+// serially, and then each locale folds the total of the blocks before it
+// into its block, as the left operand.
+//
+proc BlockArr.doiScan(op, dom) where (rank == 1) {
+  type resType = op.generate().type;
+  var res: [dom] resType;
+  const resArr = res._value;
+  const targetLocDom = this.dom.dist.targetLocDom;
+  var locTotals: [targetLocDom] resType;
+
+  coforall locIdx in targetLocDom do
+    on this.dom.dist.targetLocales(locIdx) {
+      const myOp = op.clone();
+      locTotals[locIdx] =
+        locArr[locIdx].myElems._value.chpl__scanInto(myOp,
+                                                     resArr.locArr[locIdx].myElems);
+      delete myOp;
+    }
+
+  const firstLoc = targetLocDom.low;
+  for locIdx in firstLoc+1..targetLocDom.high {
+    var total = locTotals[locIdx-1];
+    op.accumulateOntoState(total, locTotals[locIdx]);
+    locTotals[locIdx] = total;
+  }
+
+  coforall locIdx in firstLoc+1..targetLocDom.high do
+    on this.dom.dist.targetLocales(locIdx) {
+      const myOp = op.clone();
+      const adjust = locTotals[locIdx-1];
+      forall r in resArr.locArr[locIdx].myElems {
+        var x = adjust;
+        myOp.accumulateOntoState(x, r);
+        r = x;
+      }
+      delete myOp;
+    }
+
+  return res;
+}
+
 proc BlockArr.dsiTargetLocales() {
   return dom.dist.targetLocales;
 }
@@ -1138,6 +1138,25 @@ where useBulkTransferDist {
   return true;
 }
 
+// this = another distribution supporting bulk redistribution
+proc CyclicArr.doiBulkTransferFromKnown(destDom, srcClass, srcDom) : bool
+where chpl__canBulkRedistribute(this, destDom, srcClass, srcDom) {
+  return bulkRedistribute(this, destDom, srcClass, srcDom);
+}
+
+proc CyclicArr.doiCanBulkRedistribute() param return true;
+
+proc LocCyclicArr.redistChunksAreGlobal param return true;
+
+// Yields the part of 'region' owned by this locale.  The intersection
+// with the locale's strided block is a strided domain, so each chunk
+// is a single strided transfer.
+iter LocCyclicArr.redistChunks(region) {
+  const inters = locDom.myBlock[region];
+  if inters.numIndices > 0 then
+    yield (inters, inters);
+}
+
 proc CyclicArr.dsiTargetLocales() {
   return dom.dist.targetLocs;
 }
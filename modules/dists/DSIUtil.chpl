@@ -19,6 +19,8 @@
 
 // Useful functions for implementing distributions
 
+config param debugBulkRedistribute = false;
+
 inline proc getDataParTasksPerLocale() {
   return dataParTasksPerLocale;
 }
@@ -508,3 +510,97 @@ proc bulkCommConvertCoordinate(ind, bView:domain, aView:domain)
   }
   return result;
 }
+
+//
+// Bulk redistribution between distributed rectangular arrays.
+//
+// Used for assignments where the source and destination are both
+// distributed but do not share a distribution, e.g. Block arrays with
+// different target locales or bounding boxes, or Block <-> Cyclic.
+//
+// Each participating array class provides:
+//
+//   proc doiCanBulkRedistribute() param : bool
+//     - true if its local array pieces support 'redistChunks'
+//
+// and each of its local array classes provides:
+//
+//   proc redistChunksAreGlobal param : bool
+//     - true if 'myElems' is indexed by the global indices it owns
+//   iter redistChunks(region)
+//     - yields (globalInds, localInds) domain pairs covering the indices
+//       of 'region' owned by the local piece, where 'localInds' indexes
+//       'myElems' and enumerates the same elements as 'globalInds'
+//
+// The planner intersects the owned regions of each pair of local pieces
+// once and issues one (possibly strided) bulk GET or PUT per resulting
+// chunk.  For Block and Cyclic this is one transfer per locale pair.
+// The transfer is driven from the side whose chunks are global
+// (pulling into the destination when possible), so only one of the two
+// arrays may use a non-global local layout.
+//
+proc chpl__canBulkRedistribute(Dest, destDom, Src, srcDom) param : bool {
+  use Reflection;
+  if Dest.rank != Src.rank then return false;
+  if !canResolveMethod(Dest, "doiCanBulkRedistribute") ||
+     !canResolveMethod(Src, "doiCanBulkRedistribute") then
+    return false;
+  else if !Dest.doiCanBulkRedistribute() || !Src.doiCanBulkRedistribute() then
+    return false;
+  return useBulkTransferDist;
+}
+
+proc bulkRedistribute(Dest, destDom, Src, srcDom) : bool {
+  param rank = Dest.rank;
+
+  if debugBulkRedistribute then
+    writeln("In DSIUtil.bulkRedistribute");
+
+  // Only views that are translations of one another are supported.
+  if chpl__tuplify(destDom.stride) != chpl__tuplify(srcDom.stride) then
+    return false;
+
+  const toSrc = chpl__tuplify(srcDom.low) - chpl__tuplify(destDom.low),
+        toDest = -toSrc;
+
+  param pull = Dest.locArr[Dest.locArr.domain.low].redistChunksAreGlobal;
+  param push = Src.locArr[Src.locArr.domain.low].redistChunksAreGlobal;
+
+  if pull {
+    coforall destLocArr in Dest.locArr do on destLocArr {
+      for (mine, _) in destLocArr.redistChunks(destDom) {
+        const wanted = mine.translate(toSrc);
+        for srcLocArr in Src.locArr {
+          for (theirs, theirLocal) in srcLocArr.redistChunks(wanted) {
+            if debugBulkRedistribute then
+              writeln(here, ": Dest[", theirs.translate(toDest),
+                      "] = Src[", theirs, "] from ", srcLocArr.locale);
+            chpl__bulkTransferArray(destLocArr.myElems._value,
+                                    theirs.translate(toDest),
+                                    srcLocArr.myElems._value, theirLocal);
+          }
+        }
+      }
+    }
+  } else if push {
+    coforall srcLocArr in Src.locArr do on srcLocArr {
+      for (mine, _) in srcLocArr.redistChunks(srcDom) {
+        const wanted = mine.translate(toDest);
+        for destLocArr in Dest.locArr {
+          for (theirs, theirLocal) in destLocArr.redistChunks(wanted) {
+            if debugBulkRedistribute then
+              writeln(here, ": Dest[", theirs, "] = Src[",
+                      theirs.translate(toSrc), "] to ", destLocArr.locale);
+            chpl__bulkTransferArray(destLocArr.myElems._value, theirLocal,
+                                    srcLocArr.myElems._value,
+                                    theirs.translate(toSrc));
+          }
+        }
+      }
+    }
+  } else {
+    return false;
+  }
+
+  return true;
+}
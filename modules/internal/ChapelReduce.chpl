@@ -30,6 +30,41 @@ module ChapelReduce {
     delete op;
   }
 
+  // A scan can be computed in parallel by the array implementation when it
+  // provides doiScan() and the operator can fold one scanned value onto
+  // another, which is how the scans of separate chunks are joined up.
+  // Scanned values are kept in the operator's state, so the state, the
+  // scanned values and the array's elements must all be of one type.
+  proc chpl__scanIsParallel(op, data) param {
+    use Reflection;
+
+    if !isArray(data) then
+      return false;
+    else if !canResolveMethod(op, "identity") then
+      return false;
+    else if op.generate().type != op.identity.type then
+      return false;
+    else if op.identity.type != data.eltType then
+      return false;
+    else if !canResolveMethod(op, "accumulateOntoState",
+                              op.identity, op.identity) then
+      return false;
+    else
+      return canResolveMethod(data._value, "doiScan", op, data.domain);
+  }
+
+  // Unlike the serial scan, this returns an array rather than an iterator
+  proc chpl__scan(op, data) where chpl__scanIsParallel(op, data) {
+    const result = data._value.doiScan(op, data.domain);
+    delete op;
+    return result;
+  }
+
+  pragma "fn returns iterator"
+  proc chpl__scan(op, data) where !chpl__scanIsParallel(op, data) {
+    return chpl__scanIterator(op, data);
+  }
+
   iter chpl__scanIterator(op, data) {
     for e in data {
       op.accumulate(e);
@@ -38,14 +73,187 @@ module ChapelReduce {
     delete op;
   }
 
+  //
+  // State for chpl__reduceCombine().  Each locale keeps a list of the ops
+  // it holds on behalf of parent ops on other locales.  Each parent op
+  // keeps a list of the locales holding such ops for it.
+  //
+  pragma "no doc"
+  class chpl__ReduceLocaleNode {
+    var parent: unmanaged ReduceScanOp;
+    var op: unmanaged ReduceScanOp;
+    var locId: int;
+    var next: unmanaged chpl__ReduceLocaleNode;
+  }
+
+  pragma "no doc"
+  pragma "locale private"
+  var chpl__reduceLocaleLock: chpl__processorAtomicType(bool);
+
+  pragma "no doc"
+  pragma "locale private"
+  var chpl__reduceLocaleOps: unmanaged chpl__ReduceLocaleNode;
+
+  //
+  // Combine a task's reduction op into the op of its parent.
+  //
+  // A task on the parent's locale combines directly under the parent's
+  // lock.  A remote task instead combines into an op kept on its own
+  // locale on behalf of the parent, so the tasks on each locale combine
+  // locally first.  The first task on a locale to create that op records
+  // its locale in the parent's list of child locales, which costs one
+  // on-statement per locale rather than one per task.  Once all of the
+  // parent's children are done, chpl__reduceCombineLocales() combines the
+  // per-locale ops across the recorded locales in a binary tree and folds
+  // the result into the parent.  This is done by the parent's own chpl__reduceCombine() for
+  // nested levels and by chpl__reduceGenerate() for the outermost op.
+  //
   proc chpl__reduceCombine(globalOp, localOp) {
-    on globalOp {
+    chpl__reduceCombineLocales(localOp);
+
+    if globalOp.locale.id == here.id {
       globalOp.lock();
       globalOp.combine(localOp);
       globalOp.unlock();
+    } else {
+      const (myOp, isNew) = chpl__reduceLocaleOp(globalOp, localOp);
+      myOp.lock();
+      myOp.combine(localOp);
+      myOp.unlock();
+
+      if isNew {
+        const locId = here.id;
+        on globalOp {
+          const node = new unmanaged chpl__ReduceLocaleNode(globalOp,
+                                                            nil, locId);
+          globalOp.lock();
+          node.next = globalOp.chpl__childLocales;
+          globalOp.chpl__childLocales = node;
+          globalOp.unlock();
+        }
+      }
     }
   }
 
+  proc chpl__reduceGenerate(globalOp) {
+    chpl__reduceCombineLocales(globalOp);
+    return globalOp.generate();
+  }
+
+  // Fold into op the ops that other locales hold on its behalf.  All of
+  // op's child tasks must be done, so its list of child locales is final
+  // and can be read without its lock.  The list is empty unless a child
+  // ran on another locale.
+  proc chpl__reduceCombineLocales(op) {
+    if op.chpl__childLocales == nil then
+      return;
+
+    on op {
+      var node = op.chpl__childLocales,
+          count = 0;
+
+      op.chpl__childLocales = nil;
+
+      var n = node;
+      while n != nil {
+        count += 1;
+        n = n.next;
+      }
+
+      var locIds: [0..#count] int;
+      for i in 0..#count {
+        const next = node.next;
+        locIds[i] = node.locId;
+        delete node;
+        node = next;
+      }
+
+      const otherOp = chpl__reduceCombineTree(op, locIds, 0, count-1);
+      op.combine(otherOp);
+      delete otherOp;
+    }
+  }
+
+  // Combine the ops held for parent on locales locIds[lo..hi]: the op on
+  // the first of them absorbs the ops of the two halves of the rest.  The
+  // combined op is returned; it lives on locale locIds[lo].
+  proc chpl__reduceCombineTree(parent, locIds, lo: int, hi: int): parent.type {
+    var result: parent.type = nil;
+
+    on Locales[locIds[lo]] {
+      const myOp = chpl__reduceTakeLocaleOp(parent),
+            mid = (lo + 1 + hi) / 2;
+      var left, right: parent.type = nil;
+
+      cobegin with (ref left, ref right) {
+        if lo + 1 <= mid then
+          left = chpl__reduceCombineTree(parent, locIds, lo + 1, mid);
+        if mid + 1 <= hi then
+          right = chpl__reduceCombineTree(parent, locIds, mid + 1, hi);
+      }
+
+      for childOp in (left, right) {
+        if childOp != nil {
+          myOp.combine(childOp);
+          delete childOp;
+        }
+      }
+      result = myOp;
+    }
+
+    return result;
+  }
+
+  proc chpl__reduceLockLocale() {
+    while chpl__reduceLocaleLock.testAndSet() do
+      chpl_task_yield();
+  }
+
+  proc chpl__reduceUnlockLocale() {
+    chpl__reduceLocaleLock.clear();
+  }
+
+  // Find or create the op this locale holds on behalf of globalOp.  Also
+  // return whether it was just created.
+  proc chpl__reduceLocaleOp(globalOp, localOp) {
+    var isNew = false;
+
+    chpl__reduceLockLocale();
+    var node = chpl__reduceLocaleOps;
+    while node != nil && node.parent != globalOp do
+      node = node.next;
+    if node == nil {
+      node = new unmanaged chpl__ReduceLocaleNode(globalOp, localOp.clone(),
+                                                  here.id,
+                                                  chpl__reduceLocaleOps);
+      chpl__reduceLocaleOps = node;
+      isNew = true;
+    }
+    chpl__reduceUnlockLocale();
+
+    return (node.op:localOp.type, isNew);
+  }
+
+  // Remove the op this locale holds on behalf of parent and return it.
+  proc chpl__reduceTakeLocaleOp(parent) {
+    chpl__reduceLockLocale();
+    var prev: unmanaged chpl__ReduceLocaleNode = nil,
+        node = chpl__reduceLocaleOps;
+    while node.parent != parent {
+      prev = node;
+      node = node.next;
+    }
+    if prev == nil then
+      chpl__reduceLocaleOps = node.next;
+    else
+      prev.next = node.next;
+    chpl__reduceUnlockLocale();
+
+    const op = node.op:parent.type;
+    delete node;
+    return op;
+  }
+
   inline proc chpl__cleanupLocalOp(globalOp, localOp) {
     // should this be part of chpl__reduceCombine ?
     delete localOp;
@@ -68,6 +276,8 @@ module ChapelReduce {
   pragma "ReduceScanOp"
   class ReduceScanOp {
     var l: chpl__processorAtomicType(bool); // only accessed locally
+    pragma "no doc"
+    var chpl__childLocales: unmanaged chpl__ReduceLocaleNode; // see chpl__reduceCombine
 
     proc lock() {
       var lockAttempts = 0,
@@ -54,6 +54,9 @@ module ChapelSyncvar {
   * associated with the underlying class while the class provides the         *
   * identity behavior required for the semantics of sync/single.              *
   *                                                                           *
+  * For simple value types the record instead wraps a compact record that     *
+  * holds the value and its full/empty state inline (see _compactsync).       *
+  *                                                                           *
   ************************************* | ************************************/
 
   //
@@ -84,15 +87,49 @@ module ChapelSyncvar {
   pragma "no doc"
   config param useNativeSyncVar = true;
 
-  // use native sync vars if they're enabled and supported for the valType
+  pragma "no doc"
+  config param useCompactSyncVar = true;
+
+  // The types that can be stored in a _compactsync.  These are the ones
+  // whose values can be moved by copying their bytes.
+  private proc supportsCompactSyncVar(type t) param
+    return isBoolType(t)     ||
+           isIntegralType(t) ||
+           isRealType(t)     ||
+           isImagType(t)     ||
+           isEnumType(t);
+
+  // Compact sync vars are only used with tasking layers whose runtime
+  // blocks waiters on a sync word (see CHPL_TASK_SYNC_WORD_WAIT_IMPL in
+  // runtime/src/chpl-sync-word.c).  Elsewhere waiters would spin, and
+  // under qthreads the native sync vars would be lost.
+  private proc tasksSupportCompactSyncVar() param
+    return CHPL_TASKS == "fifo";
+
+  private proc isCompactSyncType(type t) param
+    return useCompactSyncVar && tasksSupportCompactSyncVar() &&
+           supportsCompactSyncVar(t);
+
+  // use compact sync vars if they're enabled and supported for the valType,
+  // and otherwise native sync vars if those are
   private proc getSyncClassType(type valType) type {
-    if useNativeSyncVar && supportsNativeSyncVar(valType) {
+    if isCompactSyncType(valType) {
+      return _compactsync(valType, false);
+    } else if useNativeSyncVar && supportsNativeSyncVar(valType) {
       return _qthreads_synccls(valType);
     } else {
       return _synccls(valType);
     }
   }
 
+  private proc getSingleClassType(type valType) type {
+    if isCompactSyncType(valType) {
+      return _compactsync(valType, true);
+    } else {
+      return _singlecls(valType);
+    }
+  }
+
   pragma "no doc"
   proc chpl__readXX(x) return x;
 
@@ -108,13 +145,16 @@ module ChapelSyncvar {
   record _syncvar {
     type valType;                              // The compiler knows this name
 
-    var  wrapped : getSyncClassType(valType) = nil;
+    var  wrapped : getSyncClassType(valType);
     var  isOwned : bool                      = true;
 
     proc init(type valType) {
       ensureFEType(valType);
       this.valType = valType;
-      this.wrapped = new unmanaged (getSyncClassType(valType))(valType);
+      if isCompactSyncType(valType) then
+        this.wrapped = new _compactsync(valType, isSingle=false);
+      else
+        this.wrapped = new unmanaged (getSyncClassType(valType))(valType);
     }
 
     //
@@ -128,14 +168,20 @@ module ChapelSyncvar {
     //
     // ``a`` needs to be a ``valType``, not a sync.
     //
-    proc init(const other : _syncvar) {
+    // A compact state can't be shared by copying it, so a copy of one
+    // forwards to the original instead.
+    //
+    proc init(const ref other : _syncvar) {
       this.valType = other.valType;
-      this.wrapped = other.wrapped;
+      if isCompactSyncType(valType) then
+        this.wrapped = other.wrapped.makeAlias();
+      else
+        this.wrapped = other.wrapped;
       this.isOwned = false;
     }
 
     proc deinit() {
-      if isOwned == true then
+      if !isCompactSyncType(valType) && isOwned == true then
         delete _to_unmanaged(wrapped);
     }
 
@@ -311,7 +357,9 @@ module ChapelSyncvar {
 
   // This version has to be available to take precedence
   inline proc chpl__autoDestroy(x : _syncvar(?)) {
-    if x.isOwned == true then
+    if isCompactSyncType(x.valType) then
+      chpl__autoDestroy(x.wrapped);
+    else if x.isOwned == true then
       delete _to_unmanaged(x.wrapped);
   }
 
@@ -343,8 +391,7 @@ module ChapelSyncvar {
   *                                                                           *
   * Use of a class instance establishes the required identity property.       *
   *                                                                           *
-  * Potential future optimization: Some targets could rely on a class that    *
-  * omits the syncAux variable for sufficiently simple valType.               *
+  * Sufficiently simple valTypes use a _compactsync record instead.           *
   *                                                                           *
   ************************************* | ************************************/
 
@@ -611,6 +658,279 @@ module ChapelSyncvar {
     }
   }
 
+  /************************************ | *************************************
+  *                                                                           *
+  * A compact sync/single state for simple value types.                       *
+  *                                                                           *
+  * The value and a chpl_sync_word_t are stored inline, so a sync/single      *
+  * variable needs no allocation of its own and an array of them is a single  *
+  * contiguous block.  The word can be moved by copying its bytes, which the  *
+  * compiler relies on when it initializes array elements.                    *
+  *                                                                           *
+  * Identity comes from the address of the state.  A copy made through        *
+  * chpl__autoCopy (e.g. for a task's argument bundle) is an alias that       *
+  * records that address and the locale it's on, and forwards every           *
+  * operation to it.                                                          *
+  *                                                                           *
+  ************************************* | ************************************/
+
+  pragma "no doc"
+  record _compactsync {
+    type  valType;
+    param isSingle : bool;
+
+    var   value    : valType;
+    var   word     : chpl_sync_word_t;      // Full/empty, locking, waiting
+
+    var   home     : c_void_ptr;            // Set only for aliases
+    var   homeNode : chpl_nodeID.type;
+
+    proc init(type valType, param isSingle : bool) {
+      this.valType  = valType;
+      this.isSingle = isSingle;
+      this.complete();
+      chpl_sync_word_init(word);
+    }
+
+    proc deinit() {
+      chpl_sync_word_destroy(word);
+    }
+
+    proc const ref makeAlias() {
+      var ret = new _compactsync(valType, isSingle);
+
+      if home != nil {
+        ret.home     = home;
+        ret.homeNode = homeNode;
+      } else {
+        ret.home     = __primitive("_wide_get_addr", this);
+        ret.homeNode = __primitive("_wide_get_node", this);
+      }
+
+      return ret;
+    }
+
+    inline proc isAlias return home != nil;
+
+    inline proc const ref homeState() ref {
+      return (home : c_ptr(_compactsync(valType, isSingle))).deref();
+    }
+
+    //
+    // Like the class versions, the operations don't need a mutable 'this';
+    // the compiler applies readFE()/readFF() to const syncs and singles when
+    // it coerces them to their value type.  Inside 'on this' they make their
+    // changes through this local reference instead, under the word's lock.
+    //
+    inline proc const ref localState() ref {
+      return (__primitive("_wide_get_addr", this) :
+              c_ptr(_compactsync(valType, isSingle))).deref();
+    }
+
+    proc const ref readFE() : valType {
+      var ret : valType;
+
+      if isAlias {
+        on __primitive("chpl_on_locale_num",
+                       chpl_buildLocaleID(homeNode, c_sublocid_any)) {
+          ret = homeState().readFE();
+        }
+      } else {
+        on this {
+          ref state    = localState();
+          var localRet : valType;
+
+          chpl_rmem_consist_release();
+          chpl_sync_word_waitFullAndLock(state.word);
+
+          localRet = state.value;
+
+          chpl_sync_word_markAndSignalEmpty(state.word);
+          chpl_rmem_consist_acquire();
+
+          ret = localRet;
+        }
+      }
+
+      return ret;
+    }
+
+    proc const ref readFF() : valType {
+      var ret : valType;
+
+      if isAlias {
+        on __primitive("chpl_on_locale_num",
+                       chpl_buildLocaleID(homeNode, c_sublocid_any)) {
+          ret = homeState().readFF();
+        }
+      } else {
+        on this {
+          ref state    = localState();
+          var localRet : valType;
+
+          chpl_rmem_consist_release();
+
+          // A full single never changes again, so it can be read as is.
+          if isSingle && chpl_sync_word_isFull(state.word) then
+            localRet = state.value;
+          else {
+            chpl_sync_word_waitFullAndLock(state.word);
+            localRet = state.value;
+            chpl_sync_word_markAndSignalFull(state.word);
+          }
+
+          chpl_rmem_consist_acquire();
+
+          ret = localRet;
+        }
+      }
+
+      return ret;
+    }
+
+    proc const ref readXX() : valType {
+      var ret : valType;
+
+      if isAlias {
+        on __primitive("chpl_on_locale_num",
+                       chpl_buildLocaleID(homeNode, c_sublocid_any)) {
+          ret = homeState().readXX();
+        }
+      } else {
+        on this {
+          ref state    = localState();
+          var localRet : valType;
+
+          chpl_rmem_consist_release();
+          chpl_sync_word_lock(state.word);
+
+          localRet = state.value;
+
+          chpl_sync_word_unlock(state.word);
+          chpl_rmem_consist_acquire();
+
+          ret = localRet;
+        }
+      }
+
+      return ret;
+    }
+
+    proc const ref writeEF(val : valType) {
+      if isAlias {
+        on __primitive("chpl_on_locale_num",
+                       chpl_buildLocaleID(homeNode, c_sublocid_any)) {
+          homeState().writeEF(val);
+        }
+      } else {
+        on this {
+          ref state = localState();
+
+          chpl_rmem_consist_release();
+
+          if isSingle {
+            chpl_sync_word_lock(state.word);
+
+            if chpl_sync_word_isFull(state.word) then
+              halt("single var already defined");
+          } else {
+            chpl_sync_word_waitEmptyAndLock(state.word);
+          }
+
+          state.value = val;
+
+          chpl_sync_word_markAndSignalFull(state.word);
+          chpl_rmem_consist_acquire();
+        }
+      }
+    }
+
+    proc const ref writeFF(val : valType) {
+      if isAlias {
+        on __primitive("chpl_on_locale_num",
+                       chpl_buildLocaleID(homeNode, c_sublocid_any)) {
+          homeState().writeFF(val);
+        }
+      } else {
+        on this {
+          ref state = localState();
+
+          chpl_rmem_consist_release();
+          chpl_sync_word_waitFullAndLock(state.word);
+
+          state.value = val;
+
+          chpl_sync_word_markAndSignalFull(state.word);
+          chpl_rmem_consist_acquire();
+        }
+      }
+    }
+
+    proc const ref writeXF(val : valType) {
+      if isAlias {
+        on __primitive("chpl_on_locale_num",
+                       chpl_buildLocaleID(homeNode, c_sublocid_any)) {
+          homeState().writeXF(val);
+        }
+      } else {
+        on this {
+          ref state = localState();
+
+          chpl_rmem_consist_release();
+          chpl_sync_word_lock(state.word);
+
+          state.value = val;
+
+          chpl_sync_word_markAndSignalFull(state.word);
+          chpl_rmem_consist_acquire();
+        }
+      }
+    }
+
+    proc const ref reset() {
+      if isAlias {
+        on __primitive("chpl_on_locale_num",
+                       chpl_buildLocaleID(homeNode, c_sublocid_any)) {
+          homeState().reset();
+        }
+      } else {
+        on this {
+          ref   state        = localState();
+          const defaultValue : valType;
+
+          chpl_rmem_consist_release();
+          chpl_sync_word_lock(state.word);
+
+          state.value = defaultValue;
+
+          chpl_sync_word_markAndSignalEmpty(state.word);
+          chpl_rmem_consist_acquire();
+        }
+      }
+    }
+
+    proc const ref isFull : bool {
+      var b : bool;
+
+      if isAlias {
+        on __primitive("chpl_on_locale_num",
+                       chpl_buildLocaleID(homeNode, c_sublocid_any)) {
+          b = homeState().isFull;
+        }
+      } else {
+        on this {
+          ref state = localState();
+
+          chpl_rmem_consist_release();
+          b = chpl_sync_word_isFull(state.word);
+          chpl_rmem_consist_acquire();
+        }
+      }
+
+      return b;
+    }
+  }
+
   pragma "no doc"
   proc isSyncValue(x : sync) param  return true;
 
@@ -633,13 +953,16 @@ module ChapelSyncvar {
   record _singlevar {
     type valType;                              // The compiler knows this name
 
-    var  wrapped : _singlecls(valType) = nil;
+    var  wrapped : getSingleClassType(valType);
     var  isOwned : bool                = true;
 
     proc init(type valType) {
       ensureFEType(valType);
       this.valType = valType;
-      wrapped = new unmanaged _singlecls(valType);
+      if isCompactSyncType(valType) then
+        wrapped = new _compactsync(valType, isSingle=true);
+      else
+        wrapped = new unmanaged _singlecls(valType);
     }
 
     //
@@ -653,14 +976,17 @@ module ChapelSyncvar {
     //
     // ``a`` needs to be a ``valType``, not a single.
     //
-    proc init(const other : _singlevar) {
+    proc init(const ref other : _singlevar) {
       this.valType = other.valType;
-      wrapped = other.wrapped;
+      if isCompactSyncType(valType) then
+        wrapped = other.wrapped.makeAlias();
+      else
+        wrapped = other.wrapped;
       isOwned = false;
     }
 
     proc deinit() {
-      if isOwned == true then
+      if !isCompactSyncType(valType) && isOwned == true then
         delete _to_unmanaged(wrapped);
     }
 
@@ -754,7 +1080,9 @@ module ChapelSyncvar {
 
   // This version has to be available to take precedence
   inline proc chpl__autoDestroy(x : _singlevar(?)) {
-    if x.isOwned == true then
+    if isCompactSyncType(x.valType) then
+      chpl__autoDestroy(x.wrapped);
+    else if x.isOwned == true then
       delete _to_unmanaged(x.wrapped);
   }
 
@@ -765,8 +1093,7 @@ module ChapelSyncvar {
   *                                                                           *
   * Use of a class instance establishes the required identity property.       *
   *                                                                           *
-  * Potential future optimization: Some targets could rely on a class that    *
-  * omits the singleAux variable for sufficiently simple valType.             *
+  * Sufficiently simple valTypes use a _compactsync record instead.           *
   *                                                                           *
   ************************************* | ************************************/
 
@@ -904,6 +1231,31 @@ private module SyncVarRuntimeSupport {
                                  ref aux : chpl_sync_aux_t) : bool;
 
 
+  //
+  // Compact sync/single state externs
+  //
+
+  // Implementation is in the runtime and opaque to Chapel code
+  extern record chpl_sync_word_t { };
+
+  extern proc   chpl_sync_word_init(ref w : chpl_sync_word_t);
+  extern proc   chpl_sync_word_destroy(ref w : chpl_sync_word_t);
+
+  pragma "insert line file info"
+  extern proc   chpl_sync_word_waitEmptyAndLock(ref w : chpl_sync_word_t);
+
+  pragma "insert line file info"
+  extern proc   chpl_sync_word_waitFullAndLock (ref w : chpl_sync_word_t);
+
+  extern proc   chpl_sync_word_lock  (ref w : chpl_sync_word_t);
+  extern proc   chpl_sync_word_unlock(ref w : chpl_sync_word_t);
+
+  extern proc   chpl_sync_word_markAndSignalEmpty(ref w : chpl_sync_word_t);
+  extern proc   chpl_sync_word_markAndSignalFull (ref w : chpl_sync_word_t);
+
+  extern proc   chpl_sync_word_isFull(ref w : chpl_sync_word_t) : bool;
+
+
   //
   // Single var externs
   //
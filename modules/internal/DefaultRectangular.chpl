@@ -1022,6 +1022,12 @@ module DefaultRectangular {
     var dataAllocRange: range(idxType);
     //var numelm: int = -1; // for correctness checking
 
+    // If 'data' points into a mapping of a file (see file.mapArray() in
+    // IO), the start and length of the mapping.  The mapping is unmapped
+    // rather than freed when the elements go away.
+    var mappedBase: c_void_ptr;
+    var mappedLen: int(64);
+
     // end class definition here, then defined secondary methods below
 
     proc intIdxType type {
@@ -1047,6 +1053,19 @@ module DefaultRectangular {
     }
 
     override proc dsiDestroyArr() {
+      if mappedBase != c_nil {
+        extern proc sys_munmap(addr: c_void_ptr, length: size_t): c_int;
+
+        // Mapped elements are plain old data, so there is nothing to
+        // destroy.  This also runs when the array is reallocated, after
+        // which the elements are in ordinary memory.
+        if sys_munmap(mappedBase, mappedLen:size_t) != 0 then
+          halt("failed to unmap array data from file");
+        mappedBase = c_nil;
+        mappedLen = 0;
+        return;
+      }
+
       if dom.dsiNumIndices > 0 {
         param needsDestroy = __primitive("needs auto destroy",
                                          __primitive("deref", data[0]));
@@ -2209,4 +2228,66 @@ module DefaultRectangular {
     return blk(curDim-1) == nextIndex;
   }
 
+  proc DefaultRectangularArr.doiScan(op, dom) where rank == 1 {
+    type resType = op.generate().type;
+    var res: [dom] resType;
+
+    chpl__scanInto(op, res);
+
+    return res;
+  }
+
+  //
+  // Scan the elements of this 1-D array with op into res, an array over
+  // the same indices, and return the scan over all of them.
+  //
+  // Each task scans its own chunk of the elements, the chunk totals are
+  // scanned serially, and then each task folds the total of the chunks
+  // before it into the elements of its chunk.  The operator need not be
+  // commutative, so the earlier total is always the left operand.
+  //
+  proc DefaultRectangularArr.chpl__scanInto(op, ref res) where rank == 1 {
+    type resType = res.eltType;
+    const rng = dom.ranges(1);
+    const len = rng.length;
+    const numTasks = if __primitive("task_get_serial") then
+                     1 else _computeNumChunks(len);
+
+    if len == 0 then
+      return op.identity;
+
+    var state: [0..#numTasks] resType;
+
+    coforall tid in 0..#numTasks with (ref res) {
+      const (lo, hi) = _computeBlock(len, numTasks, tid, len-1);
+      const myOp = op.clone();
+      for ord in lo..hi {
+        const i = rng.orderToIndex(ord);
+        myOp.accumulate(dsiAccess(i));
+        res[i] = myOp.generate();
+      }
+      state[tid] = res[rng.orderToIndex(hi)];
+      delete myOp;
+    }
+
+    for tid in 1..numTasks-1 {
+      var total = state[tid-1];
+      op.accumulateOntoState(total, state[tid]);
+      state[tid] = total;
+    }
+
+    coforall tid in 1..numTasks-1 with (ref res) {
+      const (lo, hi) = _computeBlock(len, numTasks, tid, len-1);
+      const adjust = state[tid-1];
+      for ord in lo..hi {
+        const i = rng.orderToIndex(ord);
+        var r = adjust;
+        op.accumulateOntoState(r, res[i]);
+        res[i] = r;
+      }
+    }
+
+    return state[numTasks-1];
+  }
+
 }
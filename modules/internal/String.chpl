@@ -188,6 +188,12 @@ module String {
   pragma "no doc"
   extern proc chpl__getInPlaceBufferDataForWrite(ref data : chpl__inPlaceBuffer) : c_ptr(uint(8));
 
+  private extern proc chpl_string_hash(buf: bufferType, len: int): uint(64);
+  private extern proc chpl_string_find(haystack: bufferType, haystackLen: int,
+                                       needle: bufferType, needleLen: int): int;
+  private extern proc chpl_string_rfind(haystack: bufferType, haystackLen: int,
+                                        needle: bufferType, needleLen: int): int;
+
   private inline proc chpl_string_comm_get(dest: bufferType, src_loc_id: int(64),
                                            src_addr: bufferType, len: integral) {
     __primitive("chpl_comm_get", dest, src_loc_id, src_addr, len.safeCast(size_t));
@@ -823,8 +829,10 @@ module String {
 
 
     // Helper function that uses a param bool to toggle between count and find
-    //TODO: this could be a much better string search
-    //      (Boyer-Moore-Horspool|any thing other than brute force)
+    //
+    // Contiguous regions are searched by the runtime, which skips ahead with
+    // memchr() and switches to the Two-Way algorithm for long needles.
+    // Strided regions fall back to a brute force search.
     //
     pragma "no doc"
     inline proc _search_helper(needle: string, region: range(?),
@@ -864,27 +872,51 @@ module String {
           localRet = 0;
           const localNeedle: string = needle.localize();
 
-          // i *is not* an index into anything, it is the order of the element
-          // of view we are searching from.
-          const numPossible = thisLen - nLen + 1;
-          const searchSpace = if fromLeft
-              then 0..#(numPossible)
-              else 0..#(numPossible) by -1;
-          for i in searchSpace {
-            // j *is* the index into the localNeedle's buffer
-            for j in 0..#nLen {
-              const idx = view.orderToIndex(i+j); // 1s based idx
-              if this.buff[idx-1] != localNeedle.buff[j] then break;
-
-              if j == nLen-1 {
-                if count {
-                  localRet += 1;
-                } else { // find
-                  localRet = view.orderToIndex(i);
+          if view.stride == 1 {
+            const haystack = this.buff + (view.first:int - 1);
+            if count {
+              // matches may overlap, so resume just after each one
+              var from = 0;
+              while from <= thisLen - nLen {
+                const found = chpl_string_find(haystack + from,
+                                               thisLen - from,
+                                               localNeedle.buff, nLen);
+                if found == -1 then break;
+                localRet += 1;
+                from += found + 1;
+              }
+            } else {
+              const found = if fromLeft
+                then chpl_string_find(haystack, thisLen,
+                                      localNeedle.buff, nLen)
+                else chpl_string_rfind(haystack, thisLen,
+                                       localNeedle.buff, nLen);
+              if found != -1 then
+                localRet = view.orderToIndex(found);
+            }
+          } else {
+            // i *is not* an index into anything, it is the order of the element
+            // of view we are searching from.
+            const numPossible = thisLen - nLen + 1;
+            const searchSpace = if fromLeft
+                then 0..#(numPossible)
+                else 0..#(numPossible) by -1;
+            for i in searchSpace {
+              // j *is* the index into the localNeedle's buffer
+              for j in 0..#nLen {
+                const idx = view.orderToIndex(i+j); // 1s based idx
+                if this.buff[idx-1] != localNeedle.buff[j] then break;
+
+                if j == nLen-1 {
+                  if count {
+                    localRet += 1;
+                  } else { // find
+                    localRet = view.orderToIndex(i);
+                  }
                 }
               }
+              if !count && localRet != 0 then break;
             }
-            if !count && localRet != 0 then break;
           }
         }
         ret = localRet;
@@ -2133,17 +2165,13 @@ module String {
 
   pragma "no doc"
   inline proc chpl__defaultHash(x : string): uint {
-    var hash: int(64);
-    on __primitive("chpl_on_locale_num",
-                   chpl_buildLocaleID(x.locale_id, c_sublocid_any)) {
-      // Use djb2 (Dan Bernstein in comp.lang.c), XOR version
-      var locHash: int(64) = 5381;
-      for c in 0..#(x.length) {
-        locHash = ((locHash << 5) + locHash) ^ x.buff[c];
-      }
-      hash = locHash;
+    // Hash on this locale: fetching a remote string's bytes in one GET is
+    // cheaper than moving the computation to them.
+    if !_local && x.locale_id != chpl_nodeID {
+      const localX = x.localize();
+      return chpl_string_hash(localX.buff, localX.len);
     }
-    return hash:uint;
+    return chpl_string_hash(x.buff, x.len);
   }
 
   //
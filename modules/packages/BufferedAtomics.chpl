@@ -65,10 +65,12 @@
    updates to perform and the order of those operations doesn't matter.
 
    .. note::
-     Currently, these are only optimized for ``CHPL_NETWORK_ATOMICS=ugni``.
-     Processor atomics or any other implementation falls back to non-buffered
-     operations. Under ugni these operations are internally buffered. When the
-     buffers are flushed, the operations are performed all at once. Cray Linux
+     Currently, these are only optimized for ``CHPL_NETWORK_ATOMICS=ugni``
+     and ``CHPL_NETWORK_ATOMICS=ofi``. Processor atomics or any other
+     implementation falls back to non-buffered operations. Under ugni and ofi
+     these operations are internally buffered. When the buffers are flushed,
+     the operations are performed all at once. Under ofi, operations on types
+     the network provider cannot do natively are not buffered. Cray Linux
      Environment (CLE) 5.2.UP04 or newer is required for best performance. In
      our experience, buffered atomics can achieve up to a 5X performance
      improvement over non-buffered atomics for CLE 5.2UP04 or newer and up to a
@@ -22,6 +22,12 @@
   loop for a range or domain by dynamically splitting iterations between
   locales.
 
+  :iter:`distributedDynamic` and :iter:`distributedGuided` hand out work
+  from the locale that invokes them.  :iter:`distributedWorkStealing` gives
+  each locale its own share of the work up front and lets locales that run
+  out steal from others, which avoids a single point of contention when
+  many locales are involved.
+
   ..
     Part of a 2017 Cray summer intern project by Sean I. Geronimo Anderson
     (github.com/s-geronimoanderson) as mentored by Ben Harshbarger
@@ -580,6 +586,322 @@ where tag == iterKind.follower
   for i in current do yield i;
 }
 
+// Distributed Work-Stealing Iterator.
+/*
+  :arg c: The range (or domain) to iterate over. The range (domain) size must
+    be positive.
+  :type c: `range(?)` or `domain`
+
+  :arg chunkSize: The chunk size to yield to each task. Must be positive.
+    Defaults to 1.
+  :type chunkSize: `int`
+
+  :arg numTasks: The number of tasks to use on each locale. Must be
+    nonnegative. If this argument has value 0, the iterator will use the value
+    indicated by ``dataParTasksPerLocale``.
+  :type numTasks: int
+
+  :arg parDim: If ``c`` is a domain, then this specifies the dimension index
+    to parallelize across. Must be positive, and must be at most the rank of
+    the domain ``c``. Defaults to 1.
+  :type parDim: int
+
+  :arg coordinated: If true (and multi-locale), then disallow the locale
+    invoking the iterator from receiving work.
+  :type coordinated: bool
+
+  :arg workerLocales: An array of locales over which to distribute the work.
+    Defaults to ``Locales`` (all available locales).
+  :type workerLocales: [] locale
+
+  :yields: Indices in the range ``c``.
+
+  Given an input range (or domain) ``c``, each worker locale starts with an
+  equal, contiguous share of ``c`` in a queue of its own. The tasks on a
+  locale take chunks of size ``chunkSize`` from the front of the local queue
+  (or the remaining iterations if there are fewer than ``chunkSize``). When
+  a locale's queue is empty, one of its tasks steals the back half of the
+  queue of another worker locale, trying a randomly chosen victim first and
+  then the others in turn, and refills the local queue with it. A locale
+  stops when a steal attempt finds every other queue empty.
+
+  Handing out chunks only involves the local queue, so unlike
+  :iter:`distributedDynamic` and :iter:`distributedGuided` there is no
+  locale that every chunk request goes to.
+
+  With ``timeDistributedIters`` set, the number of successful steals by
+  each locale is reported along with the time statistics.
+
+  Available for serial and zippered contexts.
+*/
+// Serial version.
+iter distributedWorkStealing(c,
+                             chunkSize:int=1,
+                             numTasks:int=0,
+                             parDim:int=1,
+                             coordinated:bool=false,
+                             workerLocales=Locales)
+{
+  compilerAssert(isDomain(c) || isRange(c),
+                 ("DistributedIters: Work-stealing iterator (serial): must "
+                  + "use a valid domain or range"),
+                 1);
+  if debugDistributedIters
+  then writeln("DistributedIters: Work-stealing iterator (serial): working ",
+               "with ", (if isDomain(c) then "domain " else "range "), c);
+  for i in c do yield i;
+}
+
+// Zippered leader.
+pragma "no doc"
+iter distributedWorkStealing(param tag:iterKind,
+                             c,
+                             chunkSize:int=1,
+                             numTasks:int=0,
+                             parDim:int=1,
+                             coordinated:bool=false,
+                             workerLocales=Locales)
+where tag == iterKind.leader
+{
+  compilerAssert(isDomain(c) || isRange(c),
+                 ("DistributedIters: Work-stealing iterator (leader): must "
+                  + "use a valid domain or range"),
+                 1);
+  assert(chunkSize > 0,
+         ("DistributedIters: Work-stealing iterator (leader): "
+          + "chunkSize must be a positive integer"));
+
+  type cType = c.type;
+
+  if isDomain(c) then
+  {
+    assert(c.rank > 0, ("DistributedIters: Work-stealing iterator (leader): "
+                        + "Must use a valid domain"));
+    assert(parDim > 0, ("DistributedIters: Work-stealing iterator (leader): "
+                        + "parDim must be a positive integer"));
+    assert(parDim <= c.rank,
+           ("DistributedIters: Work-stealing iterator (leader): "
+            + "parDim must be a dimension of the domain"));
+    var parDimDim = c.dim(parDim);
+    for t in distributedWorkStealing(tag=iterKind.leader,
+                                     c=parDimDim,
+                                     chunkSize=chunkSize,
+                                     numTasks=numTasks,
+                                     parDim=1,
+                                     coordinated=coordinated,
+                                     workerLocales=workerLocales)
+    {
+      // Set the new range based on the tuple the 1-D iterator yields.
+      var newRange = t(1);
+
+      // See distributedDynamic() for why this does not use densify.
+      var tempDom : cType = computeZeroBasedDomain(c);
+
+      // Rank-change slice the domain along parDim
+      var tempTup = tempDom.dims();
+      // Change the value of the parDim elem of the tuple to the new range
+      tempTup(parDim) = newRange;
+
+      yield tempTup;
+    }
+  }
+  else // c is a range.
+  {
+    const iterCount = c.length;
+
+    if iterCount == 0 then halt("DistributedIters: Work-stealing iterator ",
+                                "(leader): the range is empty");
+
+    const denseRange:cType = densify(c,c);
+
+    if iterCount == 1
+       || numTasks == 1 && numLocales == 1
+    then
+    {
+      if debugDistributedIters
+      then writeln("DistributedIters: Work-stealing iterator (leader): ",
+                   "serial execution due to insufficient work or compute ",
+                   "resources");
+      yield (denseRange,);
+    }
+    else
+    {
+      const numWorkerLocales = workerLocales.size;
+      const masterLocale = here.locale;
+
+      const potentialWorkerLocales =
+        [L in workerLocales] if numLocales == 1
+                                || !coordinated
+                                || L != masterLocale
+                             then L;
+      // It's not sensible to use a single locale besides masterLocale, so use
+      // potentialWorkerLocales only if it's larger than one locale.
+      const actualWorkerLocales = if potentialWorkerLocales.size > 1
+                                  then potentialWorkerLocales
+                                  else [masterLocale];
+      const nWorkers = actualWorkerLocales.size;
+
+      if infoDistributedIters then
+      {
+        const actualWorkerLocaleIds = [L in actualWorkerLocales] L.id:string;
+        const actualWorkerLocaleIdsSorted = actualWorkerLocaleIds.sorted();
+        writeln("DistributedIters: distributedWorkStealing:");
+        writeln("  coordinated = ", coordinated);
+        writeln("  numLocales = ", numLocales);
+        writeln("  numWorkerLocales = ", numWorkerLocales);
+        writeln("  actualWorkerLocales.size = ", nWorkers);
+        writeln("  masterLocale.id = ", masterLocale.id);
+        writeln("  actualWorkerLocaleIds = [ ",
+                ", ".join(actualWorkerLocaleIdsSorted),
+                " ]");
+      }
+
+      // Give each worker locale a queue holding its share of the work.
+      const denseLow:int = denseRange.low;
+      var queues:[0..#nWorkers] unmanaged WorkStealingQueue;
+      coforall (L, w) in zip(actualWorkerLocales, 0..)
+      with (ref queues)
+      do on L
+      {
+        const (low, high) = workerShare(denseLow, iterCount, nWorkers, w);
+        queues[w] = new unmanaged WorkStealingQueue(low, high);
+      }
+
+      var localeTimes:[0..#numLocales]real;
+      var localeSteals:[0..#numLocales]int;
+      var totalTime:Timer;
+      if timeDistributedIters then totalTime.start();
+
+      coforall (L, w) in zip(actualWorkerLocales, 0..)
+      with (ref localeTimes, ref localeSteals)
+      do on L
+      {
+        var localeTime:Timer;
+        if timeDistributedIters then localeTime.start();
+
+        const localQueues = queues;
+        const myQueue = localQueues[w];
+        const nTasks = if numTasks > 0 then numTasks
+                       else if dataParTasksPerLocale > 0
+                       then dataParTasksPerLocale
+                       else here.maxTaskPar;
+
+        // Only one task per locale steals at a time, and it is the only
+        // one that refills the local queue, so the queue is still empty
+        // when it does.
+        var stealing:atomic bool;
+        var done:atomic bool;
+        var steals:atomic int;
+
+        coforall tid in 0..#nTasks
+        with (ref stealing, ref done, ref steals)
+        {
+          var rngState = ((w * nTasks + tid + 1):uint) * 0x9E3779B97F4A7C15;
+
+          while true
+          {
+            const taskRange = myQueue.take(chunkSize);
+            if taskRange.low <= taskRange.high then
+            {
+              const yieldRange:cType = taskRange;
+              if debugDistributedIters
+              then writeln("DistributedIters: Work-stealing iterator ",
+                           "(leader): ", here.locale, ": yielding ",
+                           unDensify(yieldRange,c), " as ", yieldRange);
+              yield (yieldRange,);
+              continue;
+            }
+
+            if done.read() then break;
+
+            if stealing.testAndSet() then
+            {
+              // Another task is stealing for this locale; wait for it.
+              while stealing.read() do chpl_task_yield();
+              continue;
+            }
+
+            var stolen = 1..0;
+            if nWorkers > 1 then
+            {
+              rngState = rngState * 6364136223846793005 + 1442695040888963407;
+              const first = ((rngState >> 33) % (nWorkers - 1):uint):int;
+              for k in 0..#(nWorkers - 1)
+              {
+                // Visit every other worker, starting with a random one.
+                var victim = (first + k) % (nWorkers - 1);
+                if victim >= w then victim += 1;
+                const victimQueue = localQueues[victim];
+                on victimQueue do stolen = victimQueue.stealHalf();
+                if stolen.low <= stolen.high then break;
+              }
+            }
+
+            if stolen.low <= stolen.high then
+            {
+              if debugDistributedIters
+              then writeln("DistributedIters: Work-stealing iterator ",
+                           "(leader): ", here.locale, ": stole ", stolen);
+              myQueue.refill(stolen);
+              steals.add(1);
+            }
+            else done.write(true);
+
+            stealing.clear();
+          }
+        }
+
+        if timeDistributedIters then
+        {
+          localeTime.stop();
+          localeTimes[here.id] = localeTime.elapsed();
+          localeSteals[here.id] = steals.read();
+        }
+      }
+
+      coforall q in queues do on q do delete q;
+
+      if timeDistributedIters then
+      {
+        totalTime.stop();
+        writeTimeStatistics(totalTime.elapsed(), localeTimes, coordinated);
+        writeStealStatistics(localeSteals, coordinated);
+      }
+    }
+  }
+}
+
+// Zippered follower.
+pragma "no doc"
+iter distributedWorkStealing(param tag:iterKind,
+                             c,
+                             chunkSize:int,
+                             numTasks:int,
+                             parDim:int,
+                             coordinated:bool,
+                             workerLocales=Locales,
+                             followThis)
+where tag == iterKind.follower
+{
+  compilerAssert(isDomain(c) || isRange(c),
+                 ("DistributedIters: Work-stealing iterator (follower): must "
+                  + "use a valid domain or range"),
+                 1);
+  const current = if isDomain(c)
+                  then c._value.these(tag=iterKind.follower,
+                                      followThis=followThis)
+                  else unDensify(followThis(1), c);
+
+  if debugDistributedIters
+  then writeln("DistributedIters: Work-stealing iterator (follower): ",
+               here.locale, ": received ",
+               if isDomain(c) then "domain " else "range ",
+               followThis, " (", current.size,
+               "/", c.size, "); shifting to ", current);
+
+  for i in current do yield i;
+}
+
 /*
   Helpers.
 */
@@ -663,6 +985,60 @@ private proc guidedSubrange(c:range(?),
   return subrange;
 }
 
+// Work-stealing queue.
+/*
+  The part of the (dense) iteration space still to be done by one locale.
+  Its own tasks take chunks from the front and other locales steal from the
+  back. Every method runs on the locale the queue lives on.
+*/
+pragma "no doc"
+class WorkStealingQueue
+{
+  var low:int;
+  var high:int;
+  var lock:vlock;
+
+  proc take(chunkSize:int)
+  {
+    lock.lock();
+    const r = low..min(high, low + chunkSize - 1);
+    if r.low <= r.high then low = r.high + 1;
+    lock.unlock();
+    return r;
+  }
+
+  proc stealHalf()
+  {
+    lock.lock();
+    const count = high - low + 1;
+    const r = if count > 0 then (high - (count + 1) / 2 + 1)..high else 1..0;
+    if r.low <= r.high then high = r.low - 1;
+    lock.unlock();
+    return r;
+  }
+
+  proc refill(r:range)
+  {
+    lock.lock();
+    low = r.low;
+    high = r.high;
+    lock.unlock();
+  }
+}
+
+// Initial work-stealing shares.
+/*
+  :returns: The bounds of worker ``w``'s share of ``count`` dense indices
+    starting at ``low``, when split as evenly as possible among ``nWorkers``.
+*/
+private proc workerShare(low:int, count:int, nWorkers:int, w:int)
+{
+  const (q, r) = (count / nWorkers, count % nWorkers);
+  const shareLow = low + w * q + min(w, r);
+  const shareHigh = shareLow + q - 1 + (if w < r then 1 else 0);
+  return (shareLow, shareHigh);
+}
+
 // Per-locale time statistics.
 /*
   :arg wallTime: The wall time statistic.
@@ -715,4 +1091,41 @@ private proc writeTimeStatistics(wallTime:real,
           localeStdDev, ").");
 }
 
+// Per-locale steal statistics.
+/*
+  :arg localeSteals: Number of successful steals per locale.
+  :type localeSteals: `[]int`
+
+  :arg coordinated: Whether the statistics are from coordinated mode.
+  :type coordinated: `bool`
+
+  This function writes out the number of successful steals by each locale
+  and their total, in the same format as :proc:`writeTimeStatistics`.
+*/
+private proc writeStealStatistics(localeSteals:[]int,
+                                  coordinated:bool)
+{
+  const low:int = if coordinated && (numLocales > 1)
+                  then 1
+                  else 0;
+  const nLocales:int = if coordinated && (numLocales > 1)
+                       then (numLocales - 1)
+                       else numLocales;
+  var localeStealsFormatted:string;
+  var totalSteals:int;
+
+  const localeRange:range = low..#nLocales;
+  for i in localeRange
+  {
+    totalSteals += localeSteals[i];
+    localeStealsFormatted += (i + ": " + localeSteals[i]);
+    localeStealsFormatted += if i == localeRange.high
+                             then ""
+                             else ", ";
+  }
+
+  writeln("DistributedIters: steals by locale: ", localeStealsFormatted);
+  writeln("DistributedIters: total steals: ", totalSteals);
+}
+
 } // End of module.
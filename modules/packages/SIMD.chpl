@@ -0,0 +1,545 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+   The `SIMD` module provides fixed-width vector types for writing explicitly
+   vectorized kernels, for the cases where the back-end compiler does not
+   vectorize a loop on its own (gathers, horizontal reductions, masked loop
+   tails and the like).
+
+   A :record:`vec` holds ``width`` elements of type ``eltType``:
+
+   .. code-block:: chapel
+
+     use SIMD;
+
+     var A, B: [0..#n] real;
+     var acc: vec(real, 4);               // all lanes are zero
+     for i in 0..#n by 4 {
+       var a, b: vec(real, 4);
+       a.load(A, i);
+       b.load(B, i);
+       acc += a * b;
+     }
+     const dot = reduceAdd(acc);
+
+   The supported element types are ``int(32)``, ``int(64)``, ``real(32)`` and
+   ``real(64)``, with 16, 32 or 64 bytes worth of lanes, so ``vec(real, 2)``,
+   ``vec(real, 4)``, ``vec(real, 8)``, ``vec(int(32), 4)``, ...,
+   ``vec(real(32), 16)``.
+
+   Vectors are implemented with the C compiler's generic vector extensions
+   (available with GCC, clang and Intel compilers) and, when compiling with
+   ``CHPL_LLVM``, with LLVM vector types. Using a vector with any other
+   ``CHPL_TARGET_COMPILER``, such as ``pgi`` or ``cray-prgenv-cray``, is a
+   compile-time error. The C compiler picks the best
+   instructions that the target supports, so a vector wider than the target's
+   vector registers is still correct, just split across several registers.
+
+   Comparisons produce a *mask*: a vector of signed integers of the same lane
+   size with each lane either all ones (``-1``) or zero. Masks can be combined
+   with ``&``, ``|``, ``^`` and ``~``, used with :proc:`blend`, and reduced
+   with :proc:`any` and :proc:`all`.
+
+   Loads and stores move ``width`` consecutive elements of a non-strided
+   rectangular array along its last dimension. They are a single vector
+   load or store for a local default rectangular array; views and
+   distributed or remote arrays are accessed one lane at a time. Gathers
+   and scatters take a vector of indices and have no such restriction.
+ */
+module SIMD {
+
+  /*
+     A vector of ``width`` elements of type ``eltType``. Default initialized
+     vectors have all lanes set to zero.
+   */
+  record vec {
+    /* The type of the vector's elements */
+    type eltType;
+    /* The number of elements (lanes) in the vector */
+    param width: int;
+
+    pragma "no doc"
+    var v: chpl__simdType(eltType, width);
+
+    pragma "no doc"
+    proc init(type eltType, param width: int) {
+      this.eltType = eltType;
+      this.width = width;
+      this.complete();
+      chpl_simd_splat(v, 0:eltType);
+    }
+
+    /* Create a vector with every lane set to ``x`` */
+    proc init(type eltType, param width: int, x: eltType) {
+      this.eltType = eltType;
+      this.width = width;
+      this.complete();
+      chpl_simd_splat(v, x);
+    }
+
+    /* Create a vector from a tuple holding a value for each lane */
+    proc init(type eltType, param width: int, lanes: width*eltType) {
+      this.eltType = eltType;
+      this.width = width;
+      this.complete();
+      for param i in 1..width do
+        chpl_simd_set(v, i-1, lanes(i));
+    }
+
+    /* Returns the value of lane ``i``, where ``0 <= i < width`` */
+    inline proc this(i: integral): eltType {
+      if boundsChecking then
+        if i < 0 || i >= width then
+          halt("SIMD lane ", i, " out of bounds for a vector of width ", width);
+      return chpl_simd_get(v, i);
+    }
+
+    /* Sets lane ``i`` to ``x``, where ``0 <= i < width`` */
+    inline proc ref set(i: integral, x: eltType) {
+      if boundsChecking then
+        if i < 0 || i >= width then
+          halt("SIMD lane ", i, " out of bounds for a vector of width ", width);
+      chpl_simd_set(v, i, x);
+    }
+
+    /* Loads ``width`` consecutive elements starting at ``p`` */
+    inline proc ref load(p: c_ptr(eltType)) {
+      chpl_simd_load(v, p.deref());
+    }
+
+    /* Stores the lanes to ``width`` consecutive elements starting at ``p`` */
+    inline proc store(p: c_ptr(eltType)) {
+      chpl_simd_store(p.deref(), v);
+    }
+
+    /*
+       Loads the ``width`` elements of ``A`` starting at ``idx`` and moving
+       along the last dimension.
+     */
+    inline proc ref load(const ref A: [] eltType, idx) {
+      chpl__checkContiguous(A, idx, width);
+      if chpl__isLocalContiguous(A) {
+        chpl_simd_load(v, A[idx]);
+      } else {
+        for param i in 0..width-1 do
+          chpl_simd_set(v, i, A[chpl__laneIndex(A, idx, i)]);
+      }
+    }
+
+    /*
+       Stores the lanes to the ``width`` elements of ``A`` starting at ``idx``
+       and moving along the last dimension.
+     */
+    inline proc store(ref A: [] eltType, idx) {
+      chpl__checkContiguous(A, idx, width);
+      if chpl__isLocalContiguous(A) {
+        chpl_simd_store(A[idx], v);
+      } else {
+        for param i in 0..width-1 do
+          A[chpl__laneIndex(A, idx, i)] = chpl_simd_get(v, i);
+      }
+    }
+
+    /* Sets lane ``i`` to ``A[idx[i]]`` for each lane */
+    inline proc ref gather(const ref A: [] eltType, idx: vec(?, width)) {
+      for param i in 0..width-1 do
+        chpl_simd_set(v, i, A[chpl_simd_get(idx.v, i)]);
+    }
+
+    /* Stores lane ``i`` to ``A[idx[i]]`` for each lane */
+    inline proc scatter(ref A: [] eltType, idx: vec(?, width)) {
+      for param i in 0..width-1 do
+        A[chpl_simd_get(idx.v, i)] = chpl_simd_get(v, i);
+    }
+
+    pragma "no doc"
+    proc writeThis(f) {
+      f <~> "<";
+      for param i in 0..width-1 {
+        if i > 0 then f <~> ", ";
+        f <~> chpl_simd_get(v, i);
+      }
+      f <~> ">";
+    }
+  }
+
+  pragma "no doc"
+  inline proc chpl__checkContiguous(const ref A: [], idx, param width: int) {
+    if !isRectangularArr(A) || A.domain.stridable then
+      compilerError("SIMD loads and stores require a non-strided rectangular array", 2);
+    if boundsChecking {
+      if A.rank == 1 {
+        if !A.domain.contains(idx) || !A.domain.contains(idx+width-1) then
+          halt("SIMD access of ", width, " elements at ", idx,
+               " is out of bounds for array with domain ", A.domain);
+      } else {
+        var last = idx;
+        last(A.rank) += width-1;
+        if !A.domain.contains(idx) || !A.domain.contains(last) then
+          halt("SIMD access of ", width, " elements at ", idx,
+               " is out of bounds for array with domain ", A.domain);
+      }
+    }
+  }
+
+  // Are the elements of A stored in one block of memory on this locale?
+  // Views (slices, rank changes, reindexings) and distributed arrays are
+  // not, even when their domain is a non-strided rectangle.
+  pragma "no doc"
+  inline proc chpl__isLocalContiguous(const ref A: []) {
+    if A._value.isDefaultRectangular() && !chpl__isArrayView(A._value) then
+      return A._value.locale == here;
+    else
+      return false;
+  }
+
+  // The index of lane i of an access at idx, along the last dimension
+  pragma "no doc"
+  inline proc chpl__laneIndex(const ref A: [], idx, param i: int) {
+    if A.rank == 1 {
+      return idx + i;
+    } else {
+      var lane = idx;
+      lane(A.rank) += i;
+      return lane;
+    }
+  }
+
+  pragma "no doc"
+  inline proc chpl__simdResult(type eltType, param width: int, v) {
+    var r: vec(eltType, width);
+    r.v = v;
+    return r;
+  }
+
+  pragma "no doc"
+  inline proc chpl__simdMask(a: vec, v) {
+    return chpl__simdResult(chpl__simdMaskEltType(a.eltType), a.width, v);
+  }
+
+  //
+  // Arithmetic
+  //
+
+  pragma "no doc"
+  inline proc +(a: vec(?t, ?w), b: vec(t, w)) return chpl__simdResult(t, w, chpl_simd_add(a.v, b.v));
+  pragma "no doc"
+  inline proc -(a: vec(?t, ?w), b: vec(t, w)) return chpl__simdResult(t, w, chpl_simd_sub(a.v, b.v));
+  pragma "no doc"
+  inline proc *(a: vec(?t, ?w), b: vec(t, w)) return chpl__simdResult(t, w, chpl_simd_mul(a.v, b.v));
+  pragma "no doc"
+  inline proc /(a: vec(?t, ?w), b: vec(t, w)) return chpl__simdResult(t, w, chpl_simd_div(a.v, b.v));
+  pragma "no doc"
+  inline proc -(a: vec(?t, ?w)) return chpl__simdResult(t, w, chpl_simd_neg(a.v));
+
+  pragma "no doc"
+  inline proc +(a: vec(?t, ?w), b: t) return a + new vec(t, w, b);
+  pragma "no doc"
+  inline proc -(a: vec(?t, ?w), b: t) return a - new vec(t, w, b);
+  pragma "no doc"
+  inline proc *(a: vec(?t, ?w), b: t) return a * new vec(t, w, b);
+  pragma "no doc"
+  inline proc /(a: vec(?t, ?w), b: t) return a / new vec(t, w, b);
+  pragma "no doc"
+  inline proc +(a: ?t, b: vec(t, ?w)) return new vec(t, w, a) + b;
+  pragma "no doc"
+  inline proc -(a: ?t, b: vec(t, ?w)) return new vec(t, w, a) - b;
+  pragma "no doc"
+  inline proc *(a: ?t, b: vec(t, ?w)) return new vec(t, w, a) * b;
+  pragma "no doc"
+  inline proc /(a: ?t, b: vec(t, ?w)) return new vec(t, w, a) / b;
+
+  pragma "no doc"
+  inline proc +=(ref a: vec(?t, ?w), b) { a = a + b; }
+  pragma "no doc"
+  inline proc -=(ref a: vec(?t, ?w), b) { a = a - b; }
+  pragma "no doc"
+  inline proc *=(ref a: vec(?t, ?w), b) { a = a * b; }
+  pragma "no doc"
+  inline proc /=(ref a: vec(?t, ?w), b) { a = a / b; }
+
+  //
+  // Bitwise operations, on integer vectors and masks
+  //
+
+  pragma "no doc"
+  inline proc &(a: vec(?t, ?w), b: vec(t, w)) where isIntType(t)
+    return chpl__simdResult(t, w, chpl_simd_and(a.v, b.v));
+  pragma "no doc"
+  inline proc |(a: vec(?t, ?w), b: vec(t, w)) where isIntType(t)
+    return chpl__simdResult(t, w, chpl_simd_or(a.v, b.v));
+  pragma "no doc"
+  inline proc ^(a: vec(?t, ?w), b: vec(t, w)) where isIntType(t)
+    return chpl__simdResult(t, w, chpl_simd_xor(a.v, b.v));
+  pragma "no doc"
+  inline proc ~(a: vec(?t, ?w)) where isIntType(t)
+    return chpl__simdResult(t, w, chpl_simd_not(a.v));
+
+  //
+  // Comparisons, producing masks
+  //
+
+  pragma "no doc"
+  inline proc ==(a: vec(?t, ?w), b: vec(t, w)) return chpl__simdMask(a, chpl_simd_eq(a.v, b.v));
+  pragma "no doc"
+  inline proc !=(a: vec(?t, ?w), b: vec(t, w)) return chpl__simdMask(a, chpl_simd_ne(a.v, b.v));
+  pragma "no doc"
+  inline proc <(a: vec(?t, ?w), b: vec(t, w)) return chpl__simdMask(a, chpl_simd_lt(a.v, b.v));
+  pragma "no doc"
+  inline proc <=(a: vec(?t, ?w), b: vec(t, w)) return chpl__simdMask(a, chpl_simd_le(a.v, b.v));
+  pragma "no doc"
+  inline proc >(a: vec(?t, ?w), b: vec(t, w)) return chpl__simdMask(a, chpl_simd_gt(a.v, b.v));
+  pragma "no doc"
+  inline proc >=(a: vec(?t, ?w), b: vec(t, w)) return chpl__simdMask(a, chpl_simd_ge(a.v, b.v));
+
+  /*
+     Returns a vector holding ``a[i]`` in the lanes where ``mask[i]`` is set
+     and ``b[i]`` in the others. ``mask`` is usually the result of a
+     comparison.
+   */
+  inline proc blend(mask: vec(?mt, ?w), a: vec(?t, w), b: vec(t, w)) {
+    if mt != chpl__simdMaskEltType(t) then
+      compilerError("blend() requires a mask with lanes the size of ", t:string, 2);
+    return chpl__simdResult(t, w, chpl_simd_select(mask.v, a.v, b.v));
+  }
+
+  //
+  // Horizontal reductions
+  //
+
+  /* Returns the sum of the lanes of ``a`` */
+  inline proc reduceAdd(a: vec(?t, ?w)): t {
+    var r = chpl_simd_get(a.v, 0);
+    for param i in 1..w-1 do
+      r += chpl_simd_get(a.v, i);
+    return r;
+  }
+
+  /* Returns the product of the lanes of ``a`` */
+  inline proc reduceMul(a: vec(?t, ?w)): t {
+    var r = chpl_simd_get(a.v, 0);
+    for param i in 1..w-1 do
+      r *= chpl_simd_get(a.v, i);
+    return r;
+  }
+
+  /* Returns the smallest lane of ``a`` */
+  inline proc reduceMin(a: vec(?t, ?w)): t {
+    var r = chpl_simd_get(a.v, 0);
+    for param i in 1..w-1 do
+      r = min(r, chpl_simd_get(a.v, i));
+    return r;
+  }
+
+  /* Returns the largest lane of ``a`` */
+  inline proc reduceMax(a: vec(?t, ?w)): t {
+    var r = chpl_simd_get(a.v, 0);
+    for param i in 1..w-1 do
+      r = max(r, chpl_simd_get(a.v, i));
+    return r;
+  }
+
+  /* Returns true if any lane of the mask ``m`` is set */
+  inline proc any(m: vec(?t, ?w)): bool where isIntType(t) {
+    var r = chpl_simd_get(m.v, 0);
+    for param i in 1..w-1 do
+      r |= chpl_simd_get(m.v, i);
+    return r != 0;
+  }
+
+  /* Returns true if every lane of the mask ``m`` is set */
+  inline proc all(m: vec(?t, ?w)): bool where isIntType(t) {
+    var r = chpl_simd_get(m.v, 0);
+    for param i in 1..w-1 do
+      r &= chpl_simd_get(m.v, i);
+    return r != 0;
+  }
+
+  //
+  // Implementation: the vector types and operations from chpl-simd.h
+  //
+
+  pragma "no doc"
+  extern type chpl_simd_int32x4_t;
+  pragma "no doc"
+  extern type chpl_simd_int32x8_t;
+  pragma "no doc"
+  extern type chpl_simd_int32x16_t;
+  pragma "no doc"
+  extern type chpl_simd_int64x2_t;
+  pragma "no doc"
+  extern type chpl_simd_int64x4_t;
+  pragma "no doc"
+  extern type chpl_simd_int64x8_t;
+  pragma "no doc"
+  extern type chpl_simd_real32x4_t;
+  pragma "no doc"
+  extern type chpl_simd_real32x8_t;
+  pragma "no doc"
+  extern type chpl_simd_real32x16_t;
+  pragma "no doc"
+  extern type chpl_simd_real64x2_t;
+  pragma "no doc"
+  extern type chpl_simd_real64x4_t;
+  pragma "no doc"
+  extern type chpl_simd_real64x8_t;
+
+  // The target compilers that chpl-simd.h defines the vector types for
+  pragma "no doc"
+  proc chpl__simdCompilerSupported() param {
+    return CHPL_TARGET_COMPILER == "gnu" ||
+           CHPL_TARGET_COMPILER == "clang" ||
+           CHPL_TARGET_COMPILER == "clang-included" ||
+           CHPL_TARGET_COMPILER == "intel" ||
+           CHPL_TARGET_COMPILER == "mpi-gnu" ||
+           CHPL_TARGET_COMPILER == "cray-prgenv-gnu" ||
+           CHPL_TARGET_COMPILER == "cray-prgenv-intel";
+  }
+
+  // The C vector type holding 'width' elements of type 'eltType'
+  pragma "no doc"
+  proc chpl__simdType(type eltType, param width: int) type {
+    if !chpl__simdCompilerSupported() then
+      compilerError("SIMD vectors require GCC, clang or Intel vector ",
+                    "extensions, not CHPL_TARGET_COMPILER=",
+                    CHPL_TARGET_COMPILER);
+
+    if eltType == int(32) {
+      if width == 4 then return chpl_simd_int32x4_t;
+      else if width == 8 then return chpl_simd_int32x8_t;
+      else if width == 16 then return chpl_simd_int32x16_t;
+      else chpl__simdWidthError(eltType, width);
+    } else if eltType == int(64) {
+      if width == 2 then return chpl_simd_int64x2_t;
+      else if width == 4 then return chpl_simd_int64x4_t;
+      else if width == 8 then return chpl_simd_int64x8_t;
+      else chpl__simdWidthError(eltType, width);
+    } else if eltType == real(32) {
+      if width == 4 then return chpl_simd_real32x4_t;
+      else if width == 8 then return chpl_simd_real32x8_t;
+      else if width == 16 then return chpl_simd_real32x16_t;
+      else chpl__simdWidthError(eltType, width);
+    } else if eltType == real(64) {
+      if width == 2 then return chpl_simd_real64x2_t;
+      else if width == 4 then return chpl_simd_real64x4_t;
+      else if width == 8 then return chpl_simd_real64x8_t;
+      else chpl__simdWidthError(eltType, width);
+    } else {
+      compilerError("SIMD vectors of ", eltType:string, " are not supported");
+    }
+  }
+
+  pragma "no doc"
+  proc chpl__simdWidthError(type eltType, param width: int) {
+    compilerError("SIMD vectors of ", width:string, " ", eltType:string,
+                  " elements are not supported");
+  }
+
+  // The element type of the C vector type 'vt'
+  pragma "no doc"
+  proc chpl__simdEltType(type vt) type {
+    if vt == chpl_simd_int32x4_t || vt == chpl_simd_int32x8_t ||
+       vt == chpl_simd_int32x16_t then
+      return int(32);
+    else if vt == chpl_simd_int64x2_t || vt == chpl_simd_int64x4_t ||
+            vt == chpl_simd_int64x8_t then
+      return int(64);
+    else if vt == chpl_simd_real32x4_t || vt == chpl_simd_real32x8_t ||
+            vt == chpl_simd_real32x16_t then
+      return real(32);
+    else
+      return real(64);
+  }
+
+  // The number of lanes in the C vector type 'vt'
+  pragma "no doc"
+  proc chpl__simdWidth(type vt) param {
+    if vt == chpl_simd_int64x2_t || vt == chpl_simd_real64x2_t then
+      return 2;
+    else if vt == chpl_simd_int32x4_t || vt == chpl_simd_int64x4_t ||
+            vt == chpl_simd_real32x4_t || vt == chpl_simd_real64x4_t then
+      return 4;
+    else if vt == chpl_simd_int32x8_t || vt == chpl_simd_int64x8_t ||
+            vt == chpl_simd_real32x8_t || vt == chpl_simd_real64x8_t then
+      return 8;
+    else
+      return 16;
+  }
+
+  // The element type of masks for vectors of 'eltType'
+  pragma "no doc"
+  proc chpl__simdMaskEltType(type eltType) type {
+    return int(numBits(eltType));
+  }
+
+  // The C vector type that comparing two 'vt' vectors produces
+  pragma "no doc"
+  proc chpl__simdMaskType(type vt) type {
+    return chpl__simdType(chpl__simdMaskEltType(chpl__simdEltType(vt)),
+                          chpl__simdWidth(vt));
+  }
+
+  pragma "no doc"
+  extern proc chpl_simd_add(a: ?t, b: t): t;
+  pragma "no doc"
+  extern proc chpl_simd_sub(a: ?t, b: t): t;
+  pragma "no doc"
+  extern proc chpl_simd_mul(a: ?t, b: t): t;
+  pragma "no doc"
+  extern proc chpl_simd_div(a: ?t, b: t): t;
+  pragma "no doc"
+  extern proc chpl_simd_neg(a: ?t): t;
+
+  pragma "no doc"
+  extern proc chpl_simd_and(a: ?t, b: t): t;
+  pragma "no doc"
+  extern proc chpl_simd_or(a: ?t, b: t): t;
+  pragma "no doc"
+  extern proc chpl_simd_xor(a: ?t, b: t): t;
+  pragma "no doc"
+  extern proc chpl_simd_not(a: ?t): t;
+
+  pragma "no doc"
+  extern proc chpl_simd_eq(a: ?t, b: t): chpl__simdMaskType(t);
+  pragma "no doc"
+  extern proc chpl_simd_ne(a: ?t, b: t): chpl__simdMaskType(t);
+  pragma "no doc"
+  extern proc chpl_simd_lt(a: ?t, b: t): chpl__simdMaskType(t);
+  pragma "no doc"
+  extern proc chpl_simd_le(a: ?t, b: t): chpl__simdMaskType(t);
+  pragma "no doc"
+  extern proc chpl_simd_gt(a: ?t, b: t): chpl__simdMaskType(t);
+  pragma "no doc"
+  extern proc chpl_simd_ge(a: ?t, b: t): chpl__simdMaskType(t);
+
+  pragma "no doc"
+  extern proc chpl_simd_select(m, a: ?t, b: t): t;
+
+  pragma "no doc"
+  extern proc chpl_simd_splat(ref v: ?t, x: chpl__simdEltType(t));
+  pragma "no doc"
+  extern proc chpl_simd_get(a: ?t, i: int): chpl__simdEltType(t);
+  pragma "no doc"
+  extern proc chpl_simd_set(ref v: ?t, i: int, x: chpl__simdEltType(t));
+  pragma "no doc"
+  extern proc chpl_simd_load(ref v, const ref elt);
+  pragma "no doc"
+  extern proc chpl_simd_store(ref elt, const ref v);
+}
@@ -215,6 +215,11 @@ module CommDiagnostics
       non-blocking remote executions
      */
     var execute_on_nb: uint(64);
+    /*
+      remote executions, blocking or not, whose arguments were too large
+      to send with the request and were partly fetched by the target locale
+     */
+    var execute_on_large: uint(64);
 
     proc writeThis(c) {
       use Reflection;
@@ -47,6 +47,9 @@ record vlock {
 */
 config param debugDynamicIters:bool=false;
 
+// The largest number of units that adaptive() packs into a work word.
+private param maxUnits=0xffffffff:uint;
+
 //************************* Dynamic iterator
 
 /*
@@ -110,31 +113,23 @@ where tag == iterKind.leader
       writeln("Dynamic Iterator: serial execution because there is not enough work");
     yield (remain,);
   } else {
-    var moreWork : atomic bool;
-    moreWork.write(true);
+    // Each chunk is claimed with a single fetch-add. Once curIndex is past
+    // the end, every task's next fetch-add sees that and it stops, so there
+    // is no separate termination flag for the tasks to poll.
     var curIndex : atomic remain.low.type;
     curIndex.write(remain.low);
 
     coforall tid in 0..#nTasks with (const in remain) {
-      while moreWork.read() {
-        // There is local work in remain
+      while true {
         const low = curIndex.fetchAdd(chunkSize);
-        var high = low + chunkSize-1;
-
-        if low > remain.high {
-          break;
-        } else if high > remain.high {
-          high = remain.high;
-          moreWork.write(false);
-        }
+        if low > remain.high then break;
+        const high = min(low + chunkSize-1, remain.high);
 
         const current:rType = remain(low .. high);
 
-        if high >= low then {
-          if debugDynamicIters then
-            writeln("Parallel dynamic Iterator. Working at tid ", tid, " with range ", unDensify(current,c), " yielded as ", current);
-          yield (current,);
-        }
+        if debugDynamicIters then
+          writeln("Parallel dynamic Iterator. Working at tid ", tid, " with range ", unDensify(current,c), " yielded as ", current);
+        yield (current,);
       }
     }
   }
@@ -287,20 +282,24 @@ where tag == iterKind.leader
   }
 
   else {
-    var undone : atomic bool;
-    undone.write(true);
-    const factor=nTasks;
-    var lock : vlock;
-
-    coforall tid in 0..#nTasks with (ref remain, ref undone, ref lock) do {
-      while undone.read() do {
-        // There is local work in remain(tid)
-        const current:rType=adaptSplit(remain, factor, undone, lock);
-        if current.length !=0 then {
+    type idxType=remain.low.type;
+    const factor=nTasks:idxType;
+    // The next unassigned index. A task claims a chunk by moving it forward
+    // with a compare-and-swap, retrying if another task got there first.
+    var curIndex : atomic idxType;
+    curIndex.write(remain.low);
+
+    coforall tid in 0..#nTasks with (const in remain) do {
+      var low = curIndex.read();
+      while low <= remain.high do {
+        const size=max((remain.high-low+1)/factor, 1:idxType);
+        if curIndex.compareExchangeWeak(low, low+size) then {
+          const current:rType=remain(low..#size);
           if debugDynamicIters then
             writeln("Parallel guided Iterator. Working at tid ", tid, " with range ", unDensify(current,c), " yielded as ", current);
           yield (current,);
         }
+        low = curIndex.read();
       }
     }
   }
@@ -425,9 +424,10 @@ where tag == iterKind.follower
   When a task exhausts its local iterations, it steals and splits from the
   range of another task (the victim). The splitting method on the local range
   and on the victim range is binary: i.e. the size of each chunk is computed as
-  the number of unassigned iterations divided by 2. There are three stealing
-  strategies that can be selected at compile time using the config param
-  :param:`methodStealing`.
+  the number of unassigned iterations divided by 2. Both kinds of splitting
+  are done with a compare-and-swap on the range being split, without locking.
+  There are three stealing strategies that can be selected at compile time
+  using the config param :param:`methodStealing`.
 
   This iterator can be called in serial and zippered contexts.
 */
@@ -493,106 +493,83 @@ where tag == iterKind.leader
   }
   else {
     const r:rType=densify(c,c);
-    const SpaceThreads:domain(1)=0..#nTasks;
-    var localWork:[SpaceThreads] rType; // The remaining range to split on each Thread
-    var moreLocalWork:[SpaceThreads] bool=true; // bool var to signal there is still work on each local range
-    var locks:[SpaceThreads] vlock; // sync var to control the splitting on each Thread
-    const factor:int=2;
 
-    const factorSteal:int=2;
-    var moreWork : atomic bool; // A global var to control the termination
-    moreWork.write(true);
+    // The remaining work of each task is a pair of 32-bit bounds packed into
+    // one atomic word (see packUnits()), so that the owner and thieves can
+    // split it with a single compare-and-swap. Ranges with more iterations
+    // than fit in 32 bits are handled in units of several iterations.
+    const nIters=r.length:uint;
+    const unitSize=(nIters-1)/maxUnits + 1;
+    const nUnits=(nIters-1)/unitSize + 1;
+    var localWork:[0..#nTasks] atomic uint;
+
+    // Step 1: Initial range per Task
+    for tid in 0..#nTasks {
+      const (q, rem) = (nUnits/nTasks:uint, nUnits%nTasks:uint);
+      const t=tid:uint;
+      const low=t*q + min(t, rem);
+      const high=low + q + (if t < rem then 1:uint else 0:uint);
+      localWork[tid].write(packUnits(low, high));
+      if debugDynamicIters then
+        writeln("Parallel adaptive work-stealing Iterator. Initial units at tid ", tid, ": ", low..high-1);
+    }
 
-    // Variables to put a barrier to ensure the initial range is computed on each Thread
-    var barrier : atomic int;
+    // Converts the units [low, high) into the iterations they stand for.
+    proc unitsToRange(low:uint, high:uint):rType {
+      const first=low*unitSize;
+      const last=min(high*unitSize, nIters);
+      return r((r.low+first:r.idxType)..#(last-first):r.idxType);
+    }
 
     // Start the parallel work
     coforall tid in 0..#nTasks with (const in r) {
 
-      // Step 1: Initial range per Thread/Task
-
-      // Initial Local range in localWork[tid]
-      const chunkSize = c.length/nTasks;
-      localWork[tid]=
-      if tid==nTasks-1 then
-        r#(chunkSize*(nTasks-1)-r.length)
-      else
-        (r+tid*chunkSize)#chunkSize;
-      barrier.add(1);
-
-      if debugDynamicIters then
-        writeln("Parallel adaptive work-stealing Iterator. Working at tid ", tid, " with initial range ", localWork[tid]);
-
-      // A barrier waiting for each thread to finish the initial assignment
-      barrier.waitFor(nTasks);
-
       // Step 2: While there is work at tid, do splitting
 
-      while moreLocalWork[tid] do {
-        // There is local work
-        // The current range we get after splitting locally
-        const zeroBasedIters:rType=adaptSplit(localWork[tid], factorSteal, moreLocalWork[tid], locks[tid]);
-        if zeroBasedIters.length !=0 then {
-          if debugDynamicIters then
-            writeln("Parallel adaptive Iterator. Working locally at tid ", tid, " with range yielded as ", zeroBasedIters);
-          yield (zeroBasedIters,);
-        }
+      while true {
+        const (low, high)=splitUnits(localWork[tid], fromTail=false);
+        if low >= high then break;
+        const zeroBasedIters:rType=unitsToRange(low, high);
+        if debugDynamicIters then
+          writeln("Parallel adaptive Iterator. Working locally at tid ", tid, " with range yielded as ", zeroBasedIters);
+        yield (zeroBasedIters,);
       }
 
-      // Step3: Task tid finished its work, so it will try to steal from a neighbor
+      // Step 3: Task tid finished its work, so it will try to steal from
+      // the others. Stolen work is yielded directly rather than added to
+      // localWork[tid], so a range that is found empty stays empty and one
+      // sweep over the other tasks without a successful steal means that
+      // all the work has been handed out.
 
-      var nVisitedVictims:int=0;
       var victim=(tid+1) % nTasks;
-      var stealFailed:bool=false;
+      var nFailedVictims=0;
 
-      while moreWork.read() do {
+      while nFailedVictims < nTasks-1 do {
         if debugDynamicIters then
           writeln("Entering at Stealing phase in tid ", tid," with victim ", victim, " using method of Stealing ", methodStealing);
 
-        // Perform the splitting at the victim remaining range
-
-        if methodStealing == Method.RoundRobin {
-          if moreLocalWork[victim] then {
-            // There is work in victim
-            const zeroBasedIters2:rType=adaptSplit(localWork[victim], factorSteal, moreLocalWork[victim], locks[victim]);
-            if zeroBasedIters2.length !=0 then {
-              if debugDynamicIters then
-                writeln("Range stolen at victim ", victim," yielded as ", zeroBasedIters2," by tid ", tid);
-              yield (zeroBasedIters2,);
-            }
-          } else {
-            stealFailed=true;
-          }
-        } else {
-          while moreLocalWork[victim] do {
-            // There is work in victim
-            const zeroBasedIters2:rType=adaptSplit(localWork[victim], factorSteal, moreLocalWork[victim], locks[victim], methodStealing==Method.WholeTail);
-                                          //after splitting from a victim range
-            if zeroBasedIters2.length !=0 then {
-              if debugDynamicIters then
-                writeln("Range stolen at victim ", victim," yielded as ", zeroBasedIters2," by tid ", tid);
-              yield (zeroBasedIters2,);
-            }
-          }
-        }
-
-        // If here, then it can have failed the stealing intent at the victim (method 1),
-        // or we have exhausted the victim range (methods 0, 2)
-
-        if (methodStealing==Method.Whole || methodStealing==Method.WholeTail || (methodStealing==Method.RoundRobin && stealFailed)) then {
-          nVisitedVictims += 1; // Signal that there is no more work in victim
-          stealFailed=false;
+        var stole=false;
+        do {
+          const (low, high)=splitUnits(localWork[victim],
+                                       fromTail=methodStealing==Method.WholeTail);
+          if low >= high then break;
+          stole=true;
+          const zeroBasedIters2:rType=unitsToRange(low, high);
           if debugDynamicIters then
-            writeln("Failed Stealing intent at tid ", tid," with victim ", victim, " and total no. of visited victims ", nVisitedVictims);
-        }
-        // Check if there is no more work
-        if nVisitedVictims >= nTasks-1 then
-          moreWork.write(false); // Signal that there is no more work in any victim
-        else {  // There can be still work in other victim
-          victim=(victim+1) % nTasks; // New victim to steal
-          if methodStealing==Method.RoundRobin && victim==tid then
-            victim=(victim+1) % nTasks;
+            writeln("Range stolen at victim ", victim," yielded as ", zeroBasedIters2," by tid ", tid);
+          yield (zeroBasedIters2,);
+        } while methodStealing != Method.RoundRobin;
+
+        if methodStealing == Method.RoundRobin && stole then
+          nFailedVictims=0;
+        else {
+          nFailedVictims += 1;
+          if debugDynamicIters then
+            writeln("Failed Stealing intent at tid ", tid," with victim ", victim, " and total no. of visited victims ", nFailedVictims);
         }
+
+        victim=(victim+1) % nTasks;
+        if victim == tid then victim=(victim+1) % nTasks;
       }
     }
   }
@@ -711,26 +688,33 @@ private proc defaultNumTasks(nTasks:int)
   return dnTasks;
 }
 
-private proc adaptSplit(ref rangeToSplit:range(?), splitFactor:int, ref itLeft, ref lock : vlock, splitTail:bool=false)
+// Packs the units [low, high) into a single word.
+private inline proc packUnits(low:uint, high:uint):uint
 {
-  type rType=rangeToSplit.type;
-  type lenType=rangeToSplit.length.type;
-  var totLen, size:lenType;
-  const profThreshold=1;
-
-  lock.lock();
-  totLen=rangeToSplit.length;
-  if totLen > profThreshold then
-    size=max(totLen/splitFactor, profThreshold);
-  else {
-    size=totLen;
-    if isAtomic(itLeft) then itLeft.write(false); else itLeft=false;
+  return (low << 32) | high;
+}
+
+/*
+  Removes half of the units from the front, or from the tail if ``fromTail``
+  is set, of the work packed in ``work``, and returns them as the pair
+  (low, high). A single remaining unit is taken whole. Returns an empty pair
+  if there is no work left.
+*/
+private proc splitUnits(ref work:atomic uint, fromTail:bool)
+{
+  var cur=work.read();
+  var low=cur >> 32, high=cur & maxUnits;
+  while low < high {
+    const size=max((high-low)/2, 1:uint);
+    const next=if fromTail then packUnits(low, high-size)
+                           else packUnits(low+size, high);
+    if work.compareExchangeWeak(cur, next) then
+      return if fromTail then (high-size, high) else (low, low+size);
+    cur=work.read();
+    low=cur >> 32;
+    high=cur & maxUnits;
   }
-  const direction = if splitTail then -1 else 1;
-  const firstRange:rType=rangeToSplit#(direction*size);
-  rangeToSplit=rangeToSplit#(direction*(size-totLen));
-  lock.unlock();
-  return firstRange;
+  return (0:uint, 0:uint);
 }
 
 }
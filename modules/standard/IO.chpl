@@ -887,6 +887,8 @@ private extern proc qio_file_sync(f:qio_file_ptr_t):syserr;
 private extern proc qio_channel_end_offset_unlocked(ch:qio_channel_ptr_t):int(64);
 private extern proc qio_file_get_style(f:qio_file_ptr_t, ref style:iostyle);
 private extern proc qio_file_length(f:qio_file_ptr_t, ref len:int(64)):syserr;
+private extern proc qio_file_map_region(f:qio_file_ptr_t, offset:int(64), len:int(64), copy_on_write:bool, ref base_out:c_void_ptr, ref base_len_out:int(64), ref data_out:c_void_ptr):syserr;
+private extern proc qio_file_pwrite_direct(f:qio_file_ptr_t, ptr:c_void_ptr, len:int(64), offset:int(64)):syserr;
 
 pragma "no prototype" // FIXME
 private extern proc qio_channel_create(ref ch:qio_channel_ptr_t, file:qio_file_ptr_t, hints:c_int, readable:c_int, writeable:c_int, start:int(64), end:int(64), const ref style:iostyle):syserr;
@@ -1514,6 +1516,146 @@ proc file.length():int(64) throws {
   return len;
 }
 
+/*
+
+Map a region of this file into memory and return an array that uses the
+mapped region as its element storage. Reading the array reads the file
+directly, with no copy through a channel's buffers, and the operating
+system only loads each page of the file when it is first touched.
+
+The file must contain the elements as raw binary data in native byte order,
+in the array's row-major storage order, starting ``offset`` bytes into the
+file.
+
+By default the array is read-only. The program must not modify its
+elements, and a write typically crashes it with a segmentation fault. With
+``copyOnWrite=true`` the elements can be modified. Each modified page is
+copied privately, and changes are never written back to the file. Resizing
+the array's domain copies the elements into ordinary memory.
+
+This function must be called on the locale the file was opened on, and
+the file must be backed by a file descriptor (not, for example, opened with
+:proc:`openmem`).
+
+A SystemError will be thrown if the region could not be mapped, including
+when it extends past the end of the file.
+
+:arg eltType: the element type, which must be a plain-old-data type
+:arg dom: a local, non-strided rectangular domain for the array
+:arg offset: the file offset (starting from 0) of the first element. It
+             should be a multiple of the size of `eltType` so that the
+             elements are aligned.
+:arg copyOnWrite: whether the array can be modified
+:returns: an array over `dom` whose elements are stored in the file
+
+*/
+pragma "no copy return"
+proc file.mapArray(type eltType, dom: domain, offset:int(64) = 0,
+                   copyOnWrite:bool = false) throws {
+  if !isPODType(eltType) then
+    compilerError("file.mapArray() requires a plain-old-data element type");
+  if !isRectangularDom(dom) || !dom._value.isDefaultRectangular() ||
+     dom.stridable then
+    compilerError("file.mapArray() requires a local, non-strided " +
+                  "rectangular domain");
+
+  try check();
+
+  if this.home != here then
+    throw SystemError.fromSyserr(EINVAL, "in file.mapArray: file is on " +
+                                 "another locale");
+
+  if dom.size == 0 then
+    return dom.buildArray(eltType);
+
+  const len = dom.size:int(64) * c_sizeof(eltType):int(64);
+  var base: c_void_ptr;
+  var baseLen: int(64);
+  var data: c_void_ptr;
+
+  var err = qio_file_map_region(_file_internal, offset, len, copyOnWrite,
+                                base, baseLen, data);
+  if err then try ioerror(err, "in file.mapArray", this.tryGetPath(), offset);
+
+  var arr = dom._value.dsiBuildArrayWith(eltType, data:_ddata(eltType),
+                                         dom.size);
+  arr.mappedBase = base;
+  arr.mappedLen = baseLen;
+  dom._value.add_arr(arr);
+
+  return _newArray(arr);
+}
+
+/*
+  :proc:`file.writeArray` does not split a write into parts smaller than
+  this many bytes.
+*/
+config const writeArrayMinBytesPerTask: int(64) = 1 << 20;
+
+/*
+
+Write the elements of an array to this file as raw binary data in native
+byte order, starting ``offset`` bytes into the file and extending the file
+as needed. The data is written straight from the array's memory with
+``pwritev``, rather than being copied through a channel's buffers. A large
+array is split into contiguous parts that are written by parallel tasks.
+
+The data is not flushed to the device. Call :proc:`file.fsync` for that.
+
+This function must be called on the locale the file was opened on, and the
+array must be stored on that locale as well.
+
+A SystemError will be thrown if the data could not be written.
+
+:arg A: a local, non-strided rectangular array with plain-old-data elements
+:arg offset: the file offset (starting from 0) at which to write the first
+             element
+
+*/
+proc file.writeArray(const ref A: [], offset:int(64) = 0) throws {
+  if !isPODType(A.eltType) then
+    compilerError("file.writeArray() requires a plain-old-data element type");
+  if !isRectangularArr(A) || !A._value.isDefaultRectangular() ||
+     A.domain.stridable then
+    compilerError("file.writeArray() requires a local, non-strided " +
+                  "rectangular array");
+
+  try check();
+
+  if this.home != here then
+    throw SystemError.fromSyserr(EINVAL, "in file.writeArray: file is on " +
+                                 "another locale");
+  if A._value.locale != here then
+    throw SystemError.fromSyserr(EINVAL, "in file.writeArray: array is on " +
+                                 "another locale");
+
+  if A.size == 0 then
+    return;
+
+  const eltSize = c_sizeof(A.eltType):int(64);
+  const numElts = A.size:int(64);
+  // The elements are contiguous, starting at the low index.
+  const data = c_ptrTo(A._value.data[0]):c_ptr(uint(8));
+  const maxTasks = if dataParTasksPerLocale > 0 then dataParTasksPerLocale
+                   else here.maxTaskPar;
+  const numTasks = max(1, min(maxTasks,
+                              numElts * eltSize /
+                                writeArrayMinBytesPerTask)):int;
+  var errs: [0..#numTasks] syserr;
+
+  coforall tid in 0..#numTasks with (ref errs) {
+    const lo = numElts * tid / numTasks * eltSize;
+    const hi = numElts * (tid + 1) / numTasks * eltSize;
+
+    errs[tid] = qio_file_pwrite_direct(_file_internal, data + lo, hi - lo,
+                                       offset + lo);
+  }
+
+  for err in errs do
+    if err then try ioerror(err, "in file.writeArray", this.tryGetPath(),
+                            offset);
+}
+
 // these strings are here (vs in _modestring)
 // in an attempt to avoid string copies, leaks,
 // and unnecessary allocations.
@@ -18,7 +18,13 @@
  */
 
 /*
-  This module provides a simple singly linked list.
+  This module provides a list whose elements are stored contiguously in a
+  buffer that grows as needed.
+
+  Appending or prepending an element, and removing the first or last
+  element, take amortized constant time.  Elements can be accessed by their
+  1-based position in constant time, and the list can be iterated over in
+  parallel.
 
   .. note::
 
@@ -26,59 +32,63 @@
  */
 module List {
 
-pragma "no doc"
-class listNode {
-  type eltType;
-  var data: eltType;
-  var next: unmanaged listNode(eltType);
-}
-
-
   pragma "no doc"
   proc =(ref l1: list(?t), const ref l2: list(?t2)) {
     l1.destroy();
+    l1.reserve(l2.length);
     for i in l2 do
       l1.append(i);
   }
 
 
 /*
-  A singly linked list.
+  A list of elements stored in a contiguous, growable buffer.
 
   .. note::
 
-      :proc:`~list.destroy` must be called to reclaim any memory used by the list.
-
+      If `parSafe` is ``true``, the methods that add or remove elements can be
+      called concurrently.  Iterating over or indexing into the list must
+      still not overlap with them.
  */
 record list {
   /*
-    The type of the data stored in every node.
+    The type of the elements stored in the list.
    */
   type eltType;
+  /*
+    If ``true``, adding and removing elements is protected by a lock.
+   */
+  param parSafe = false;
+
+  // The elements are _data[_start.._start+length-1].  Leaving room before
+  // the first element lets prepend and pop_front run in constant time.
+  pragma "no doc"
+  var _data: _ddata(eltType) = nil;
   pragma "no doc"
-  pragma "owned"
-  var first: unmanaged listNode(eltType);
+  var _start: int;
   pragma "no doc"
-  pragma "owned"
-  var last: unmanaged listNode(eltType);
+  var _capacity: int;
+  pragma "no doc"
+  var _lock: if parSafe then chpl__processorAtomicType(bool) else void;
   /*
-    The number of nodes in the list.
+    The number of elements in the list.
    */
   var length: int;
 
   pragma "no doc"
-  proc init(type eltType, first : unmanaged listNode(eltType) = nil, last : unmanaged listNode(eltType) = nil) {
+  proc init(type eltType, param parSafe = false) {
     this.eltType = eltType;
-    this.first = first;
-    this.last = last;
+    this.parSafe = parSafe;
   }
 
   pragma "no doc"
-  proc init(l : list(?t)) {
+  proc init(l : list(?t, ?p)) {
     this.eltType = t;
+    this.parSafe = p;
     this.complete();
+    _reserve(l.length);
     for i in l do
-      this.append(i);
+      _append(i);
   }
 
   /*
@@ -88,31 +98,137 @@ record list {
     return length;
   }
 
+  /*
+    The number of elements the list can hold before it has to grow.
+   */
+  proc capacity {
+    return _capacity - _start;
+  }
+
+  pragma "no doc"
+  inline proc _enter() {
+    if parSafe then
+      while _lock.testAndSet() do chpl_task_yield();
+  }
+
+  pragma "no doc"
+  inline proc _leave() {
+    if parSafe then
+      _lock.clear();
+  }
+
+  // Move the elements into a new buffer of newCapacity elements, starting
+  // at offset newStart.
+  pragma "no doc"
+  proc ref _reallocate(newCapacity: int, newStart: int) {
+    var newData: _ddata(eltType) = nil;
+    if newCapacity > 0 {
+      var callAgain: bool;
+      __primitive("array_alloc", newData, newCapacity, c_sublocid_none,
+                  c_ptrTo(callAgain), c_nil);
+      if callAgain then
+        __primitive("array_alloc", newData, newCapacity, c_sublocid_none,
+                    c_nil, newData);
+    }
+    for i in 0..#length {
+      // this is a move, transferring ownership
+      __primitive("=", newData[newStart+i], _data[_start+i]);
+    }
+    if _data != nil then
+      _ddata_free(_data, _capacity);
+    _data = newData;
+    _start = newStart;
+    _capacity = newCapacity;
+  }
+
+  // The capacity to grow to when the list has to hold n elements.
+  pragma "no doc"
+  proc _grownCapacity(n: int) {
+    var cap = max(_capacity, 8);
+    while cap < n do
+      cap *= 2;
+    return cap;
+  }
+
+  pragma "no doc"
+  proc ref _reserve(n: int) {
+    if _start + n > _capacity then
+      _reallocate(if n <= _capacity then _capacity else _grownCapacity(n), 0);
+  }
+
+  pragma "no doc"
+  proc ref _append(e: eltType) {
+    if _start + length == _capacity then
+      _reserve(length + 1);
+    pragma "no auto destroy"
+    pragma "no copy"
+    var eltCopy = chpl__initCopy(e);
+    __primitive("=", _data[_start+length], eltCopy);
+    length += 1;
+  }
+
+  /*
+    Make sure that the list can hold at least `n` elements without growing.
+   */
+  proc ref reserve(n: int) {
+    _enter();
+    _reserve(n);
+    _leave();
+  }
+
+  /*
+    Release any buffer space that is not holding elements.
+   */
+  proc ref shrink() {
+    _enter();
+    if _start != 0 || _capacity != length then
+      _reallocate(length, 0);
+    _leave();
+  }
+
+  /*
+    Access the element at position `i`, which must be in `1..length`.
+   */
+  pragma "reference to const when const this"
+  proc ref this(i: int) ref {
+    if boundsChecking && (i < 1 || i > length) then
+      HaltWrappers.boundsCheckHalt("list index " + i:string +
+                                   " out of bounds 1.." + length:string);
+    return _data[_start+i-1];
+  }
+
   /*
     Iterate over the list, yielding each element.
 
     :ytype: eltType
    */
-  iter these() {
-    var tmp = first;
-    while tmp != nil {
-      yield tmp.data;
-      tmp = tmp.next;
-    }
+  pragma "reference to const when const this"
+  iter these() ref {
+    for i in 0..#length do
+      yield _data[_start+i];
+  }
+
+  pragma "no doc"
+  iter these(param tag: iterKind) where tag == iterKind.leader {
+    for followThis in (0..#length).these(tag) do
+      yield followThis;
+  }
+
+  pragma "no doc"
+  pragma "reference to const when const this"
+  iter these(param tag: iterKind, followThis) ref
+    where tag == iterKind.follower {
+    for i in followThis(1) do
+      yield _data[_start+i];
   }
 
   /*
     Append `e` to the list.
    */
   proc ref append(e : eltType) {
-    if last {
-      last.next = new unmanaged listNode(eltType, e);
-      last = last.next;
-    } else {
-      first = new unmanaged listNode(eltType, e);
-      last = first;
-    }
-    length += 1;
+    _enter();
+    _append(e);
+    _leave();
   }
   /*
      Synonym for append.
@@ -124,21 +240,43 @@ record list {
   /*
     Append all of the supplied arguments to the list.
    */
-  //TODO: merge the append overloads
   proc append(e: eltType, es: eltType ...?k) {
-    append(e);
+    _enter();
+    _reserve(length + 1 + k);
+    _append(e);
     for param i in 1..k do
-      append(es(i));
+      _append(es(i));
+    _leave();
+  }
+
+  /*
+    Append all of the elements of the array `a` to the list.
+   */
+  proc ref append(a: [] eltType) {
+    _enter();
+    _reserve(length + a.size);
+    for e in a do
+      _append(e);
+    _leave();
   }
 
   /*
     Prepend `e` to the list.
    */
-  proc prepend(e : eltType) {
-    first = new unmanaged listNode(eltType, e, first);
-    if last == nil then
-      last = first;
+  proc ref prepend(e : eltType) {
+    _enter();
+    if _start == 0 {
+      // Leave room in front of the elements for further prepends.
+      const newCapacity = _grownCapacity(length + 1);
+      _reallocate(newCapacity, newCapacity - length - (newCapacity - length)/2);
+    }
+    pragma "no auto destroy"
+    pragma "no copy"
+    var eltCopy = chpl__initCopy(e);
+    _start -= 1;
+    __primitive("=", _data[_start], eltCopy);
     length += 1;
+    _leave();
   }
 
   /*
@@ -150,11 +288,15 @@ record list {
 
 
   /*
-    Append all the elements in `l` to the end of the list.
+    Append all the elements in `l` to the end of the list.  `l` need not
+    have the same `parSafe` setting as this list.
    */
-  proc concat(l: list(eltType)) {
+  proc concat(l: list(eltType, ?)) {
+    _enter();
+    _reserve(length + l.length);
     for e in l do
-      append(e);
+      _append(e);
+    _leave();
   }
 
   /*
@@ -162,22 +304,19 @@ record list {
     Does nothing if `x` is not present in the list.
    */
   proc ref remove(x: eltType) {
-    var tmp = first,
-        prev: first.type = nil;
-    while tmp != nil && tmp.data != x {
-      prev = tmp;
-      tmp = tmp.next;
-    }
-    if tmp != nil {
-      if prev != nil then
-        prev.next = tmp.next;
-      if first == tmp then
-        first = tmp.next;
-      if last == tmp then
-        last = prev;
-      delete tmp;
-      length -= 1;
+    _enter();
+    for i in 0..#length {
+      if _data[_start+i] == x {
+        chpl__autoDestroy(_data[_start+i]);
+        for j in i..length-2 {
+          // this is a move, transferring ownership
+          __primitive("=", _data[_start+j], _data[_start+j+1]);
+        }
+        length -= 1;
+        break;
+      }
     }
+    _leave();
   }
 
   /*
@@ -185,32 +324,50 @@ record list {
      It is an error to call this function on an empty list.
    */
    proc pop_front():eltType {
+     _enter();
      if boundsChecking && length < 1 {
+       _leave();
        HaltWrappers.boundsCheckHalt("pop_front on empty list");
      }
-     var oldfirst = first;
-     var newfirst = first.next;
-     var ret = oldfirst.data;
-     first = newfirst;
-     if last == oldfirst then last = newfirst;
+     var ret = _data[_start];
+     chpl__autoDestroy(_data[_start]);
+     _start += 1;
      length -= 1;
-     delete oldfirst;
+     _leave();
      return ret;
    }
 
   /*
-    Delete every node in the list.
+     Remove the last element from the list and return it.
+     It is an error to call this function on an empty list.
+   */
+   proc pop_back():eltType {
+     _enter();
+     if boundsChecking && length < 1 {
+       _leave();
+       HaltWrappers.boundsCheckHalt("pop_back on empty list");
+     }
+     var ret = _data[_start+length-1];
+     chpl__autoDestroy(_data[_start+length-1]);
+     length -= 1;
+     _leave();
+     return ret;
+   }
+
+  /*
+    Delete every element in the list and release its buffer.
    */
   proc destroy() {
-    var current = first;
-    while (current != nil) {
-      var next = current.next;
-      delete current;
-      current = next;
-    }
-    first = nil;
-    last = nil;
+    _enter();
+    for i in 0..#length do
+      chpl__autoDestroy(_data[_start+i]);
+    if _data != nil then
+      _ddata_free(_data, _capacity);
+    _data = nil;
+    _start = 0;
+    _capacity = 0;
     length = 0;
+    _leave();
   }
 
   /*
@@ -345,6 +502,7 @@ record list {
 // TODO: could just be an initializer?
 proc makeList(x ...?k) {
   var s: list(x(1).type);
+  s.reserve(k);
   for param i in 1..k do
     s.append(x(i));
   return s;
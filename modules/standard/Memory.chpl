@@ -19,13 +19,14 @@
 
 /*
   The :mod:`Memory` module provides procedures which report information
-  about memory usage.  With one exception, to use these procedures you
-  must enable memory tracking.  Do this by setting one or more of the
+  about memory usage, and a :class:`MemoryRegion` class for allocating
+  short-lived memory quickly.  With the exception of
+  :proc:`locale.physicalMemory` and :class:`MemoryRegion`, to use these
+  procedures you must enable memory tracking.  Do this by setting one or more of the
   config vars below, using appropriate ``--configVarName=value`` or
   ``-sconfigVarName=value`` command line options when you run the
-  program.  If memory tracking is not enabled, calling any procedure
-  described here, other than :proc:`locale.physicalMemory`, will cause
-  the program to halt with an error message.
+  program.  If memory tracking is not enabled, calling any of those
+  procedures will cause the program to halt with an error message.
 
   ``memTrack``: `bool`:
     Enable memory tracking.  This causes memory allocations and
@@ -244,4 +245,116 @@ proc stopVerboseMemHere() {
   chpl_stopVerboseMemHere();
 }
 
+
+pragma "no doc"
+extern type chpl_mem_region_t;
+
+pragma "no doc"
+extern const CHPL_RT_MD_MEM_REGION: chpl_mem_descInt_t;
+
+pragma "insert line file info"
+private extern proc chpl_mem_region_create(chunkSize: size_t,
+                                           description: chpl_mem_descInt_t
+                                          ): chpl_mem_region_t;
+pragma "insert line file info"
+private extern proc chpl_mem_region_alloc(region: chpl_mem_region_t,
+                                          size: size_t): c_void_ptr;
+pragma "insert line file info"
+private extern proc chpl_mem_region_reset(region: chpl_mem_region_t);
+pragma "insert line file info"
+private extern proc chpl_mem_region_destroy(region: chpl_mem_region_t);
+private extern proc chpl_mem_region_used(region: chpl_mem_region_t): size_t;
+private extern proc chpl_mem_region_reserved(region: chpl_mem_region_t): size_t;
+
+/*
+  A region (or arena) of memory on the locale where it was created.
+
+  Allocating from a region just advances a pointer through large chunks
+  of memory, and there is no way to free an individual allocation.
+  Instead, everything allocated from the region is freed at once by
+  :proc:`reset` or when the region is deleted.  This suits phases of a
+  computation that allocate many short-lived buffers.
+
+  Tasks running on the region's locale may allocate from it concurrently.
+  Resetting or deleting the region must not overlap with allocating from
+  it, and no memory allocated from it may be used afterwards.
+
+  The chunks backing a region are ordinary Chapel allocations, so they
+  are included in :proc:`memoryUsed` and the other memory tracking
+  reports, with the description "memory region chunk".  Using a region
+  does not require memory tracking to be enabled.
+
+  .. code-block:: chapel
+
+    var region = new owned MemoryRegion();
+    forall i in 1..n {
+      var buf = region.alloc(real, 100);
+      ...
+    }
+    region.reset();
+ */
+class MemoryRegion {
+  pragma "no doc"
+  var _region: chpl_mem_region_t;
+
+  /*
+    Create a region.
+
+    :arg chunkSize: The size in bytes of the chunks the region obtains
+      memory in.  Requests larger than a quarter of this get a chunk of
+      their own.  If 0, a default size is used.
+   */
+  proc init(chunkSize: integral = 0) {
+    _region = chpl_mem_region_create(chunkSize.safeCast(size_t),
+                                     CHPL_RT_MD_MEM_REGION);
+  }
+
+  pragma "no doc"
+  proc deinit() {
+    on this do chpl_mem_region_destroy(_region);
+  }
+
+  /*
+    Allocate space for `n` elements of type `eltType` from the region.
+    The memory is not initialized.  This must be called on the locale
+    where the region was created.
+
+    :returns: a pointer to the first element
+   */
+  inline proc alloc(type eltType, n: integral = 1): c_ptr(eltType) {
+    if boundsChecking && this.locale != here then
+      halt("MemoryRegion.alloc() called on a locale other than the region's");
+    const size = n.safeCast(size_t) * c_sizeof(eltType);
+    return chpl_mem_region_alloc(_region, size): c_ptr(eltType);
+  }
+
+  /*
+    Free everything allocated from the region, which can then be used
+    again.
+   */
+  proc reset() {
+    on this do chpl_mem_region_reset(_region);
+  }
+
+  /*
+    The number of bytes allocated from the region since it was created
+    or last reset.
+   */
+  proc used(): int {
+    var ret: int;
+    on this do ret = chpl_mem_region_used(_region): int;
+    return ret;
+  }
+
+  /*
+    The number of bytes of memory the region holds, including space
+    that has not been allocated from yet.
+   */
+  proc reserved(): int {
+    var ret: int;
+    on this do ret = chpl_mem_region_reserved(_region): int;
+    return ret;
+  }
+}
+
 }
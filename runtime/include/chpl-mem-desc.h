@@ -59,6 +59,8 @@
   m(COMM_PRV_OBJ_ARRAY,   "comm layer private objects array",         false), \
   m(COMM_PRV_BCAST_DATA,  "comm layer private broadcast data",        false), \
   m(MEM_HEAP_SPACE,       "mem layer heap expansion space",           false), \
+  m(MEM_REGION,           "memory region chunk",                      true ), \
+  m(MEM_REGION_DESC,      "memory region descriptor",                 true ), \
   m(GLOM_STRINGS_DATA,    "glom strings data",                        true ), \
   m(STR_COPY_DATA,        "string copy data",                         true ), \
   m(STR_COPY_REMOTE,      "remote string copy",                       true ), \
@@ -170,6 +170,35 @@ void chpl_rt_free_c_string(c_string *s, int32_t lineno, int32_t filename)  {
   *s = NULL;
 }
 
+//
+// Memory regions (arenas).
+//
+// A region hands out memory by bumping a pointer through large chunks
+// obtained from chpl_mem_alloc(), and releases all of it at once when it
+// is reset or destroyed; there is no way to free a single allocation.
+// Any task on the locale that created a region may allocate from it
+// concurrently, but resetting or destroying the region must not overlap
+// with allocating from it.  The chunks are allocated with the region's
+// memory descriptor, so they appear in --memTrack reports under it.
+//
+typedef struct chpl_mem_region_s* chpl_mem_region_t;
+
+chpl_mem_region_t chpl_mem_region_create(size_t chunkSize,
+                                         chpl_mem_descInt_t description,
+                                         int32_t lineno, int32_t filename);
+void* chpl_mem_region_alloc(chpl_mem_region_t region, size_t size,
+                            int32_t lineno, int32_t filename);
+void chpl_mem_region_reset(chpl_mem_region_t region,
+                           int32_t lineno, int32_t filename);
+void chpl_mem_region_destroy(chpl_mem_region_t region,
+                             int32_t lineno, int32_t filename);
+
+// The number of bytes handed out by a region since it was created or
+// last reset, and the number of bytes it has obtained to do so.  The
+// first is only exact when no allocations are in progress.
+size_t chpl_mem_region_used(chpl_mem_region_t region);
+size_t chpl_mem_region_reserved(chpl_mem_region_t region);
+
 void chpl_mem_layerInit(void);
 void chpl_mem_layerExit(void);
 void* chpl_mem_layerAlloc(size_t, int32_t lineno, int32_t filename);
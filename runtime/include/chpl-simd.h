@@ -0,0 +1,107 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _chpl_simd_h_
+#define _chpl_simd_h_
+
+#include "chpl-comp-detect-macros.h"
+
+#include <stdint.h>
+#include <string.h>
+
+//
+// Fixed-width vector types for the SIMD package module.
+//
+// These are the generic vector extensions provided by GCC and clang (and by
+// the compilers that emulate them). The C compiler maps them onto whatever
+// vector registers the target has, splitting wide vectors as needed, and when
+// generating code with LLVM the clang-parsed types become LLVM vector types.
+//
+// Vectors are named chpl_simd_<elt>x<lanes>_t. Every vector has a size of 16,
+// 32 or 64 bytes. Comparisons produce the signed integer vector with the same
+// lane size and count, with each lane either all ones or all zeros.
+//
+#if (RT_COMP_CC & (RT_COMP_GCC | RT_COMP_CLANG | RT_COMP_INTEL))
+
+#define CHPL_SIMD_VECTOR_EXTENSIONS 1
+
+// Only element alignment is required so that vectors stored in records and
+// arrays allocated by the runtime are always safe to access.
+#define CHPL_SIMD_DEFINE_VECTOR(eltType, name, bytes) \
+  typedef eltType name __attribute__((vector_size(bytes), aligned(sizeof(eltType))))
+
+CHPL_SIMD_DEFINE_VECTOR(int32_t, chpl_simd_int32x4_t,   16);
+CHPL_SIMD_DEFINE_VECTOR(int32_t, chpl_simd_int32x8_t,   32);
+CHPL_SIMD_DEFINE_VECTOR(int32_t, chpl_simd_int32x16_t,  64);
+CHPL_SIMD_DEFINE_VECTOR(int64_t, chpl_simd_int64x2_t,   16);
+CHPL_SIMD_DEFINE_VECTOR(int64_t, chpl_simd_int64x4_t,   32);
+CHPL_SIMD_DEFINE_VECTOR(int64_t, chpl_simd_int64x8_t,   64);
+CHPL_SIMD_DEFINE_VECTOR(float,   chpl_simd_real32x4_t,  16);
+CHPL_SIMD_DEFINE_VECTOR(float,   chpl_simd_real32x8_t,  32);
+CHPL_SIMD_DEFINE_VECTOR(float,   chpl_simd_real32x16_t, 64);
+CHPL_SIMD_DEFINE_VECTOR(double,  chpl_simd_real64x2_t,  16);
+CHPL_SIMD_DEFINE_VECTOR(double,  chpl_simd_real64x4_t,  32);
+CHPL_SIMD_DEFINE_VECTOR(double,  chpl_simd_real64x8_t,  64);
+
+#undef CHPL_SIMD_DEFINE_VECTOR
+
+//
+// The operations are macros so that one definition serves every vector
+// type. Vectors are read and written by value except where noted; the
+// load, store and lane update forms take a pointer to the vector.
+//
+#define chpl_simd_add(a, b) ((a) + (b))
+#define chpl_simd_sub(a, b) ((a) - (b))
+#define chpl_simd_mul(a, b) ((a) * (b))
+#define chpl_simd_div(a, b) ((a) / (b))
+#define chpl_simd_neg(a)    (-(a))
+
+#define chpl_simd_and(a, b) ((a) & (b))
+#define chpl_simd_or(a, b)  ((a) | (b))
+#define chpl_simd_xor(a, b) ((a) ^ (b))
+#define chpl_simd_not(a)    (~(a))
+
+#define chpl_simd_eq(a, b) ((a) == (b))
+#define chpl_simd_ne(a, b) ((a) != (b))
+#define chpl_simd_lt(a, b) ((a) < (b))
+#define chpl_simd_le(a, b) ((a) <= (b))
+#define chpl_simd_gt(a, b) ((a) > (b))
+#define chpl_simd_ge(a, b) ((a) >= (b))
+
+// Lanes where the mask is set come from a, the rest from b. The vector casts
+// reinterpret the bits, so this works for floating point vectors as well.
+#define chpl_simd_select(m, a, b)                          \
+  ((__typeof__(a))(((m) & (__typeof__(m))(a)) |          \
+                   (~(m) & (__typeof__(m))(b))))
+
+#define chpl_simd_splat(v, x) \
+  (*(v) = ((__typeof__(*(v))){0}) + (x))
+
+#define chpl_simd_get(a, i)    ((a)[(i)])
+#define chpl_simd_set(v, i, x) ((*(v))[(i)] = (x))
+
+// Unaligned loads and stores of a whole vector, from or to the elements
+// starting at the one that p points to. memcpy() of a constant size becomes
+// a single vector move.
+#define chpl_simd_load(v, p)  memcpy((v), (p), sizeof(*(v)))
+#define chpl_simd_store(p, v) memcpy((p), (v), sizeof(*(v)))
+
+#endif // vector extensions; SIMD.chpl rejects other target compilers
+
+#endif // _chpl_simd_h_
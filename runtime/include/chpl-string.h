@@ -44,4 +44,20 @@ typedef struct chpl__inPlaceBuffer_t {
 uint8_t* chpl__getInPlaceBufferData(chpl__inPlaceBuffer* buf);
 uint8_t* chpl__getInPlaceBufferDataForWrite(chpl__inPlaceBuffer* buf);
 
+//
+// Hashing and searching of string byte buffers.  Neither buffer needs to
+// be NUL-terminated.
+//
+
+// A wyhash-style 64-bit hash of len bytes.
+uint64_t chpl_string_hash(const uint8_t* buf, int64_t len);
+
+// The 0-based offset of the first (or last) occurrence of the needle in
+// the haystack, or -1 if there is none.  An empty needle is found at the
+// start (or end) of the haystack.
+int64_t chpl_string_find(const uint8_t* haystack, int64_t haystackLen,
+                         const uint8_t* needle, int64_t needleLen);
+int64_t chpl_string_rfind(const uint8_t* haystack, int64_t haystackLen,
+                          const uint8_t* needle, int64_t needleLen);
+
 #endif
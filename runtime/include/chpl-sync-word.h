@@ -0,0 +1,139 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _chpl_sync_word_h_
+#define _chpl_sync_word_h_
+
+#include "chpltypes.h"
+#include "chpl-atomics.h"
+
+#include <stdint.h>
+
+//
+// Compact full/empty state for sync and single variables.
+//
+// A sync word is a single 32-bit atomic holding the full/empty bit, a
+// lock bit, and a bit saying that some task may be sleeping on the word.
+// Unlike chpl_sync_aux_t it needs no initialization beyond zeroing and
+// no destruction beyond what the atomics implementation requires, and
+// when nothing is waiting on it a sync word can be moved by copying its
+// bytes, so it can be stored directly in a record or array element.
+//
+// The operations mirror the chpl_sync_*() tasking layer interface. The
+// uncontended cases are inline here; waiting and waking are done by
+// chpl_sync_word_wait() and chpl_sync_word_wake(), which the tasking
+// layer may provide (see chpl-sync-word.c).
+//
+typedef struct {
+  atomic_uint_least32_t state;
+} chpl_sync_word_t;
+
+#define CHPL_SYNC_WORD_FULL    ((uint_least32_t) 0x1)
+#define CHPL_SYNC_WORD_LOCKED  ((uint_least32_t) 0x2)
+#define CHPL_SYNC_WORD_WAITERS ((uint_least32_t) 0x4)
+
+// What a waiter wants the full/empty bit to be before it takes the lock.
+#define CHPL_SYNC_WORD_WANT_EMPTY ((uint_least32_t) 0x0)
+#define CHPL_SYNC_WORD_WANT_FULL  CHPL_SYNC_WORD_FULL
+#define CHPL_SYNC_WORD_WANT_ANY   ((uint_least32_t) 0x2)
+
+void chpl_sync_word_wait(chpl_sync_word_t* w, uint_least32_t want,
+                         int32_t lineno, int32_t filename);
+void chpl_sync_word_wake(chpl_sync_word_t* w);
+
+static inline
+void chpl_sync_word_init(chpl_sync_word_t* w) {
+  atomic_init_uint_least32_t(&w->state, 0);
+}
+
+static inline
+void chpl_sync_word_destroy(chpl_sync_word_t* w) {
+  atomic_destroy_uint_least32_t(&w->state);
+}
+
+static inline
+chpl_bool chpl_sync_word_tryLock(chpl_sync_word_t* w, uint_least32_t want) {
+  uint_least32_t s = atomic_load_uint_least32_t(&w->state);
+
+  if ((s & CHPL_SYNC_WORD_LOCKED) != 0
+      || (want != CHPL_SYNC_WORD_WANT_ANY
+          && (s & CHPL_SYNC_WORD_FULL) != want)) {
+    return false;
+  }
+
+  return atomic_compare_exchange_strong_uint_least32_t(&w->state, s,
+                                                       s | CHPL_SYNC_WORD_LOCKED);
+}
+
+static inline
+void chpl_sync_word_waitFullAndLock(chpl_sync_word_t* w,
+                                    int32_t lineno, int32_t filename) {
+  if (!chpl_sync_word_tryLock(w, CHPL_SYNC_WORD_WANT_FULL))
+    chpl_sync_word_wait(w, CHPL_SYNC_WORD_WANT_FULL, lineno, filename);
+}
+
+static inline
+void chpl_sync_word_waitEmptyAndLock(chpl_sync_word_t* w,
+                                     int32_t lineno, int32_t filename) {
+  if (!chpl_sync_word_tryLock(w, CHPL_SYNC_WORD_WANT_EMPTY))
+    chpl_sync_word_wait(w, CHPL_SYNC_WORD_WANT_EMPTY, lineno, filename);
+}
+
+static inline
+void chpl_sync_word_lock(chpl_sync_word_t* w) {
+  if (!chpl_sync_word_tryLock(w, CHPL_SYNC_WORD_WANT_ANY))
+    chpl_sync_word_wait(w, CHPL_SYNC_WORD_WANT_ANY, 0, 0);
+}
+
+//
+// Releasing the lock also clears the waiters bit, so if it was set we
+// have to wake everyone sleeping on the word. Any of them that still
+// can't proceed will set it again before going back to sleep.
+//
+static inline
+void chpl_sync_word_release(chpl_sync_word_t* w, uint_least32_t full) {
+  if ((atomic_exchange_uint_least32_t(&w->state, full)
+       & CHPL_SYNC_WORD_WAITERS) != 0) {
+    chpl_sync_word_wake(w);
+  }
+}
+
+static inline
+void chpl_sync_word_unlock(chpl_sync_word_t* w) {
+  // While we hold the lock no one else can change the full/empty bit.
+  chpl_sync_word_release(w, (atomic_load_uint_least32_t(&w->state)
+                             & CHPL_SYNC_WORD_FULL));
+}
+
+static inline
+void chpl_sync_word_markAndSignalFull(chpl_sync_word_t* w) {
+  chpl_sync_word_release(w, CHPL_SYNC_WORD_FULL);
+}
+
+static inline
+void chpl_sync_word_markAndSignalEmpty(chpl_sync_word_t* w) {
+  chpl_sync_word_release(w, 0);
+}
+
+static inline
+chpl_bool chpl_sync_word_isFull(chpl_sync_word_t* w) {
+  return (atomic_load_uint_least32_t(&w->state) & CHPL_SYNC_WORD_FULL) != 0;
+}
+
+#endif // _chpl_sync_word_h_
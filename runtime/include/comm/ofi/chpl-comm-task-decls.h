@@ -29,8 +29,12 @@
 
 #include "chpltypes.h"
 
+// The type of task private data.
+#include "chpl-cache-task-decls.h"
+#define HAS_CHPL_CACHE_FNS
+
 typedef struct {
-  int dummy;    // structs must be nonempty
+  chpl_cache_taskPrvData_t cache_data;
 } chpl_comm_taskPrvData_t;
 
 //
@@ -638,6 +638,21 @@ void qio_file_get_style(qio_file_t* f, qio_style_t* style)
 // Calls fflush on a FILE* first.
 qioerr qio_file_length(qio_file_t* f, int64_t *len_out);
 
+// Map len bytes of a file starting at offset into memory, read-only, or
+// if copy_on_write is set, writable with the changes kept private to this
+// process.  The mapping starts at the page containing offset; *data_out
+// points to offset within it, and *base_out and *base_len_out describe the
+// whole mapping, to be released with sys_munmap.  The region must lie
+// within the file, and the file must have a file descriptor.
+qioerr qio_file_map_region(qio_file_t* f, int64_t offset, int64_t len,
+                           qio_bool copy_on_write,
+                           void** base_out, int64_t* base_len_out,
+                           void** data_out);
+
+// Write len bytes from ptr to a file at offset with pwritev, without
+// buffering them.  Tasks can write disjoint regions concurrently.
+qioerr qio_file_pwrite_direct(qio_file_t* f, const void* ptr, int64_t len, int64_t offset);
+
 /* CHANNELS ..... */
 
 /* A Read and Write Buffered channels support:
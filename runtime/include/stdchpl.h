@@ -57,7 +57,9 @@
 #include "chplmemtrack.h"
 #include "chpl-prefetch.h"
 #include "chpl-privatization.h"
+#include "chpl-simd.h"
 #include "chpl-string.h"
+#include "chpl-sync-word.h"
 #include "chplsys.h"
 #include "chpl-tasks.h"
 #include "chpltimers.h"
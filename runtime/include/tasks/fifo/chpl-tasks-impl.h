@@ -127,6 +127,14 @@ c_sublocid_t chpl_task_getRequestedSubloc(void) {
 }
 
 
+//
+// The fifo tasking layer does its own waiting on compact sync words (see
+// chpl-sync-word.h), so that waiters take part in deadlock detection and
+// can sleep instead of spinning.
+//
+#define CHPL_TASK_SYNC_WORD_WAIT_IMPL 1
+
+
 #ifdef CHPL_TASK_SUPPORTS_REMOTE_CACHE_IMPL_DECL
 #error "CHPL_TASK_SUPPORTS_REMOTE_CACHE_IMPL_DECL is already defined!"
 #else
@@ -22,7 +22,9 @@
 //
 #include "chplrt.h"
 
+#include "chpl-atomics.h"
 #include "chpl-mem.h"
+#include "chpl-tasks.h"
 #include "chpltypes.h"
 #include "error.h"
 #include "chplsys.h"
@@ -106,3 +108,164 @@ void* chpl_pvalloc(size_t size)
 }
 
 
+
+
+//
+// Memory regions
+//
+// Each chunk starts with a header, followed by its data.  Allocations are
+// made from the current chunk by atomically advancing its 'used' count;
+// a task that pushes 'used' past the end of the chunk takes the region's
+// lock and installs a new current chunk.  Requests that are large compared
+// to the chunk size get a chunk of their own, which is linked into the
+// list but never becomes current, so the rest of the current chunk is not
+// wasted.
+//
+#define REGION_ALIGN 16
+#define REGION_ROUND(n) (((n) + REGION_ALIGN - 1) & ~((size_t) REGION_ALIGN - 1))
+#define REGION_DEFAULT_CHUNK_SIZE ((size_t) 64 * 1024)
+
+typedef struct region_chunk_s {
+  struct region_chunk_s* next;
+  size_t size;                      // bytes of data in the chunk
+  atomic_uint_least64_t used;       // bytes claimed, may exceed size
+  size_t end;                       // bytes handed out, once overflowed;
+                                    // set under the region's lock
+} region_chunk_t;
+
+#define REGION_CHUNK_HDR REGION_ROUND(sizeof(region_chunk_t))
+#define REGION_CHUNK_DATA(c) ((char*) (c) + REGION_CHUNK_HDR)
+
+struct chpl_mem_region_s {
+  size_t chunkSize;
+  chpl_mem_descInt_t description;
+  atomic_uintptr_t current;         // region_chunk_t*, or 0 when empty
+  atomic_bool lock;                 // protects the chunk list
+  region_chunk_t* chunks;
+  size_t reserved;                  // data bytes in all chunks
+};
+
+
+static inline void region_lock(chpl_mem_region_t r) {
+  while (atomic_exchange_bool(&r->lock, true))
+    chpl_task_yield();
+}
+
+
+static inline void region_unlock(chpl_mem_region_t r) {
+  atomic_store_bool(&r->lock, false);
+}
+
+
+static region_chunk_t* region_new_chunk(chpl_mem_region_t r, size_t size,
+                                        int32_t lineno, int32_t filename) {
+  region_chunk_t* c = chpl_mem_alloc(REGION_CHUNK_HDR + size,
+                                     r->description, lineno, filename);
+  c->size = size;
+  c->end = size;
+  atomic_init_uint_least64_t(&c->used, 0);
+  c->next = r->chunks;
+  r->chunks = c;
+  r->reserved += size;
+  return c;
+}
+
+
+chpl_mem_region_t chpl_mem_region_create(size_t chunkSize,
+                                         chpl_mem_descInt_t description,
+                                         int32_t lineno, int32_t filename) {
+  chpl_mem_region_t r = chpl_mem_alloc(sizeof(*r), CHPL_RT_MD_MEM_REGION_DESC,
+                                       lineno, filename);
+  r->chunkSize = REGION_ROUND(chunkSize == 0 ? REGION_DEFAULT_CHUNK_SIZE
+                                             : chunkSize);
+  r->description = description;
+  atomic_init_uintptr_t(&r->current, 0);
+  atomic_init_bool(&r->lock, false);
+  r->chunks = NULL;
+  r->reserved = 0;
+  return r;
+}
+
+
+void* chpl_mem_region_alloc(chpl_mem_region_t r, size_t size,
+                            int32_t lineno, int32_t filename) {
+  size = REGION_ROUND(size == 0 ? 1 : size);
+
+  if (size > r->chunkSize / 4) {
+    // Too big to share a chunk.  It is fully used as soon as it exists.
+    region_chunk_t* fresh;
+    region_lock(r);
+    fresh = region_new_chunk(r, size, lineno, filename);
+    atomic_store_uint_least64_t(&fresh->used, size);
+    region_unlock(r);
+    return REGION_CHUNK_DATA(fresh);
+  }
+
+  while (true) {
+    region_chunk_t* c = (region_chunk_t*) atomic_load_uintptr_t(&r->current);
+    size_t off = 0;
+
+    if (c != NULL) {
+      off = atomic_fetch_add_uint_least64_t(&c->used, size);
+      if (off + size <= c->size)
+        return REGION_CHUNK_DATA(c) + off;
+    }
+
+    region_lock(r);
+
+    // Only the first request to overflow the chunk starts inside it,
+    // and where it starts is exactly how much of the chunk was used.
+    if (c != NULL && off <= c->size)
+      c->end = off;
+
+    // Another task may already have replaced the chunk we overflowed.
+    if (atomic_load_uintptr_t(&r->current) == (uintptr_t) c) {
+      region_chunk_t* fresh = region_new_chunk(r, r->chunkSize,
+                                               lineno, filename);
+      atomic_store_uintptr_t(&r->current, (uintptr_t) fresh);
+    }
+
+    region_unlock(r);
+  }
+}
+
+
+void chpl_mem_region_reset(chpl_mem_region_t r,
+                           int32_t lineno, int32_t filename) {
+  region_chunk_t* c = r->chunks;
+  while (c != NULL) {
+    region_chunk_t* next = c->next;
+    chpl_mem_free(c, lineno, filename);
+    c = next;
+  }
+  r->chunks = NULL;
+  atomic_store_uintptr_t(&r->current, 0);
+  r->reserved = 0;
+}
+
+
+void chpl_mem_region_destroy(chpl_mem_region_t r,
+                             int32_t lineno, int32_t filename) {
+  chpl_mem_region_reset(r, lineno, filename);
+  atomic_destroy_uintptr_t(&r->current);
+  atomic_destroy_bool(&r->lock);
+  chpl_mem_free(r, lineno, filename);
+}
+
+
+size_t chpl_mem_region_used(chpl_mem_region_t r) {
+  region_chunk_t* c;
+  size_t used = 0;
+  region_lock(r);
+  for (c = r->chunks; c != NULL; c = c->next) {
+    size_t cUsed = atomic_load_uint_least64_t(&c->used);
+    used += cUsed < c->end ? cUsed : c->end;
+  }
+  region_unlock(r);
+  return used;
+}
+
+
+size_t chpl_mem_region_reserved(chpl_mem_region_t r) {
+  return r->reserved;
+}
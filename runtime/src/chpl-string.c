@@ -21,6 +21,9 @@
 #include "chpl-string.h"
 #include "chpl-gen-includes.h"
 
+#include <stdint.h>
+#include <string.h>
+
 struct chpl_chpl____wide_chpl_string_s {
   chpl_localeID_t locale;
   chpl_string addr;
@@ -126,3 +129,274 @@ uint8_t* chpl__getInPlaceBufferData(chpl__inPlaceBuffer* buf) {
 uint8_t* chpl__getInPlaceBufferDataForWrite(chpl__inPlaceBuffer* buf) {
   return chpl__getInPlaceBufferData(buf);
 }
+
+
+//
+// String hashing
+//
+// This is wyhash (final version 3, by Wang Yi), which reads its input 8 or
+// 4 bytes at a time and mixes with a 64x64->128 bit multiply.  It is much
+// faster than a byte-at-a-time hash for all but the shortest strings, and
+// its quality is good enough for the power-of-two tables of associative
+// domains.  The hash depends on the byte order, which is fine because it
+// is only ever compared with other hashes computed by the same program.
+//
+static const uint64_t wyhash_secret[4] = {
+  0xa0761d6478bd642full, 0xe7037ed1a0b428dbull,
+  0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull
+};
+
+static inline uint64_t wyhash_mix(uint64_t a, uint64_t b) {
+#ifdef __SIZEOF_INT128__
+  __uint128_t r = (__uint128_t) a * b;
+  return (uint64_t) (r >> 64) ^ (uint64_t) r;
+#else
+  uint64_t ha = a >> 32, hb = b >> 32;
+  uint64_t la = (uint32_t) a, lb = (uint32_t) b;
+  uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+  uint64_t t = rl + (rm0 << 32);
+  uint64_t c = t < rl;
+  uint64_t lo = t + (rm1 << 32);
+  c += lo < t;
+  return (rh + (rm0 >> 32) + (rm1 >> 32) + c) ^ lo;
+#endif
+}
+
+static inline uint64_t wyhash_read8(const uint8_t* p) {
+  uint64_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline uint64_t wyhash_read4(const uint8_t* p) {
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline uint64_t wyhash_read3(const uint8_t* p, size_t k) {
+  return (((uint64_t) p[0]) << 16) | (((uint64_t) p[k >> 1]) << 8) | p[k - 1];
+}
+
+uint64_t chpl_string_hash(const uint8_t* buf, int64_t len) {
+  const uint8_t* p = buf;
+  const uint64_t* s = wyhash_secret;
+  uint64_t seed = s[0];
+  uint64_t a, b;
+
+  if (len <= 16) {
+    if (len >= 4) {
+      a = (wyhash_read4(p) << 32) | wyhash_read4(p + ((len >> 3) << 2));
+      b = (wyhash_read4(p + len - 4) << 32) |
+          wyhash_read4(p + len - 4 - ((len >> 3) << 2));
+    } else if (len > 0) {
+      a = wyhash_read3(p, len);
+      b = 0;
+    } else {
+      a = b = 0;
+    }
+  } else {
+    int64_t i = len;
+    if (i > 48) {
+      uint64_t see1 = seed, see2 = seed;
+      do {
+        seed = wyhash_mix(wyhash_read8(p) ^ s[1], wyhash_read8(p + 8) ^ seed);
+        see1 = wyhash_mix(wyhash_read8(p + 16) ^ s[2],
+                          wyhash_read8(p + 24) ^ see1);
+        see2 = wyhash_mix(wyhash_read8(p + 32) ^ s[3],
+                          wyhash_read8(p + 40) ^ see2);
+        p += 48;
+        i -= 48;
+      } while (i > 48);
+      seed ^= see1 ^ see2;
+    }
+    while (i > 16) {
+      seed = wyhash_mix(wyhash_read8(p) ^ s[1], wyhash_read8(p + 8) ^ seed);
+      i -= 16;
+      p += 16;
+    }
+    a = wyhash_read8(p + i - 16);
+    b = wyhash_read8(p + i - 8);
+  }
+
+  return wyhash_mix(s[1] ^ (uint64_t) len,
+                    wyhash_mix(a ^ s[1], b ^ seed));
+}
+
+
+//
+// Substring search
+//
+// Short needles are found by letting memchr() (which the C library
+// vectorizes) skip to each occurrence of the needle's first byte and
+// then comparing the rest with memcmp().  That is quick unless the first
+// byte is common in the haystack, which matters more the longer the
+// needle is, so needles of CHPL_STRING_TWO_WAY_MIN bytes or more use the
+// Two-Way algorithm (Crochemore and Perrin), which runs in linear time
+// and constant space whatever the input.
+//
+#define CHPL_STRING_TWO_WAY_MIN 32
+
+// Compute the critical factorization of the needle, returning the
+// position of the split and setting *period to the period of the
+// right half.
+static size_t two_way_factorization(const uint8_t* n, size_t nlen,
+                                    size_t* period) {
+  size_t max_suffix, max_suffix_rev, j, k, p;
+  uint8_t a, b;
+
+  // The maximal suffix for the byte ordering.  max_suffix starts at -1,
+  // so max_suffix + k is the index k - 1 until it is first set.
+  max_suffix = SIZE_MAX;
+  j = 0;
+  k = p = 1;
+  while (j + k < nlen) {
+    a = n[j + k];
+    b = n[max_suffix + k];
+    if (a < b) {
+      j += k;
+      k = 1;
+      p = j - max_suffix;
+    } else if (a == b) {
+      if (k != p) {
+        ++k;
+      } else {
+        j += p;
+        k = 1;
+      }
+    } else {
+      max_suffix = j++;
+      k = p = 1;
+    }
+  }
+  *period = p;
+
+  // The maximal suffix for the reverse ordering.
+  max_suffix_rev = SIZE_MAX;
+  j = 0;
+  k = p = 1;
+  while (j + k < nlen) {
+    a = n[j + k];
+    b = n[max_suffix_rev + k];
+    if (b < a) {
+      j += k;
+      k = 1;
+      p = j - max_suffix_rev;
+    } else if (a == b) {
+      if (k != p) {
+        ++k;
+      } else {
+        j += p;
+        k = 1;
+      }
+    } else {
+      max_suffix_rev = j++;
+      k = p = 1;
+    }
+  }
+
+  // The critical factorization is the later of the two.
+  if (max_suffix_rev + 1 < max_suffix + 1)
+    return max_suffix + 1;
+  *period = p;
+  return max_suffix_rev + 1;
+}
+
+static int64_t two_way_find(const uint8_t* h, size_t hlen,
+                            const uint8_t* n, size_t nlen) {
+  size_t i, j, period, suffix;
+
+  suffix = two_way_factorization(n, nlen, &period);
+
+  if (memcmp(n, n + period, suffix) == 0) {
+    // The needle is periodic: remember how much of the left half is known
+    // to match after a shift by the period.
+    size_t memory = 0;
+    j = 0;
+    while (j <= hlen - nlen) {
+      i = suffix < memory ? memory : suffix;
+      while (i < nlen && n[i] == h[i + j])
+        ++i;
+      if (nlen <= i) {
+        i = suffix - 1;
+        while (memory < i + 1 && n[i] == h[i + j])
+          --i;
+        if (i + 1 < memory + 1)
+          return (int64_t) j;
+        j += period;
+        memory = nlen - period;
+      } else {
+        j += i - suffix + 1;
+        memory = 0;
+      }
+    }
+  } else {
+    // The two halves are distinct, so any mismatch allows a large shift.
+    period = (suffix < nlen - suffix ? nlen - suffix : suffix) + 1;
+    j = 0;
+    while (j <= hlen - nlen) {
+      i = suffix;
+      while (i < nlen && n[i] == h[i + j])
+        ++i;
+      if (nlen <= i) {
+        i = suffix - 1;
+        while (i != SIZE_MAX && n[i] == h[i + j])
+          --i;
+        if (i == SIZE_MAX)
+          return (int64_t) j;
+        j += period;
+      } else {
+        j += i - suffix + 1;
+      }
+    }
+  }
+
+  return -1;
+}
+
+int64_t chpl_string_find(const uint8_t* haystack, int64_t haystackLen,
+                         const uint8_t* needle, int64_t needleLen) {
+  const uint8_t* p;
+  const uint8_t* last;
+
+  if (needleLen == 0)
+    return 0;
+  if (needleLen > haystackLen)
+    return -1;
+
+  if (needleLen >= CHPL_STRING_TWO_WAY_MIN)
+    return two_way_find(haystack, haystackLen, needle, needleLen);
+
+  p = haystack;
+  last = haystack + (haystackLen - needleLen);
+  while (p <= last) {
+    p = memchr(p, needle[0], last - p + 1);
+    if (p == NULL)
+      return -1;
+    if (memcmp(p + 1, needle + 1, needleLen - 1) == 0)
+      return p - haystack;
+    p++;
+  }
+
+  return -1;
+}
+
+int64_t chpl_string_rfind(const uint8_t* haystack, int64_t haystackLen,
+                          const uint8_t* needle, int64_t needleLen) {
+  int64_t i;
+
+  if (needleLen == 0)
+    return haystackLen;
+  if (needleLen > haystackLen)
+    return -1;
+
+  // There is no portable memrchr(), so check the first byte inline
+  // before comparing the rest.
+  for (i = haystackLen - needleLen; i >= 0; i--) {
+    if (haystack[i] == needle[0] &&
+        memcmp(haystack + i + 1, needle + 1, needleLen - 1) == 0)
+      return i;
+  }
+
+  return -1;
+}
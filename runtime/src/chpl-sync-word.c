@@ -0,0 +1,47 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Waiting and waking for compact sync words (see chpl-sync-word.h).
+//
+// This is the version for tasking layers that multiplex tasks onto
+// threads, where a waiter must not block its thread and just yields
+// until the word is ready.  A tasking layer that can do better defines
+// CHPL_TASK_SYNC_WORD_WAIT_IMPL in its chpl-tasks-impl.h and provides
+// these functions itself.
+//
+
+#include "chplrt.h"
+#include "chpl-sync-word.h"
+#include "chpl-tasks.h"
+
+#ifndef CHPL_TASK_SYNC_WORD_WAIT_IMPL
+
+void chpl_sync_word_wait(chpl_sync_word_t* w, uint_least32_t want,
+                         int32_t lineno, int32_t filename) {
+  while (!chpl_sync_word_tryLock(w, want))
+    chpl_task_yield();
+}
+
+
+void chpl_sync_word_wake(chpl_sync_word_t* w) {
+  // Waiters never sleep, so there is nothing to do.
+}
+
+#endif
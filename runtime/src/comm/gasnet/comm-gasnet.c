@@ -177,10 +177,17 @@ typedef struct {
   chpl_task_ChapelData_t state;
 } small_fork_hdr_t;
 
+//
+// A large fork carries as much of the argument bundle as fits in a medium
+// AM after the header.  The handler copies that prefix into a bundle buffer
+// on the target, and the task it starts GETs only the rest of the bundle.
+//
 typedef struct {
-  small_fork_hdr_t hdr;
-  void*            arg;
-  size_t           arg_size;
+  small_fork_hdr_t       hdr;
+  void*                  arg;          // bundle on the caller
+  size_t                 arg_size;
+  chpl_comm_on_bundle_t* local_arg;    // bundle buffer on the target
+  size_t                 prefix_size;  // bytes of the bundle sent in the AM
 } large_fork_t;
 
 #define MAX_SMALL_FORK_SIZE 128
@@ -228,6 +235,96 @@ typedef struct {
 } xfer_info_t;
 
 
+//
+// Pool of buffers for argument bundles that are too large to be sent in a
+// single active message.  Both the non-blocking caller's copy of the bundle
+// and the target's received bundle come from here, as does the message
+// used to send a large fork, so a program doing many large on-statements
+// does not go through the memory layer for each one.  The pool is small and
+// only holds buffers up to a modest size; anything else is allocated and
+// freed as before.  A GASNet handler-safe lock protects it, because the
+// FREE handler returns buffers to it.
+//
+#define FORK_BUNDLE_POOL_SIZE      16
+#define FORK_BUNDLE_POOL_MAX_BYTES (1024 * 1024)
+
+typedef union fork_bundle_buf {
+  struct {
+    union fork_bundle_buf* next;
+    size_t                 capacity;
+  } hdr;
+  long double align;    // keep the bundle that follows suitably aligned
+} fork_bundle_buf_t;
+
+static fork_bundle_buf_t* fork_bundle_pool = NULL;
+static int fork_bundle_pool_count = 0;
+static gasnet_hsl_t fork_bundle_pool_lock = GASNET_HSL_INITIALIZER;
+
+static
+void* fork_bundle_alloc(size_t size, chpl_mem_descInt_t description) {
+  fork_bundle_buf_t* buf = NULL;
+
+  if (size <= FORK_BUNDLE_POOL_MAX_BYTES) {
+    fork_bundle_buf_t** prev;
+
+    gasnet_hsl_lock(&fork_bundle_pool_lock);
+    for (prev = &fork_bundle_pool; *prev != NULL; prev = &(*prev)->hdr.next) {
+      if ((*prev)->hdr.capacity >= size) {
+        buf = *prev;
+        *prev = buf->hdr.next;
+        fork_bundle_pool_count--;
+        break;
+      }
+    }
+    gasnet_hsl_unlock(&fork_bundle_pool_lock);
+  }
+
+  if (buf == NULL) {
+    buf = chpl_mem_allocMany(1, sizeof(fork_bundle_buf_t) + size,
+                             description, 0, 0);
+    buf->hdr.capacity = size;
+  }
+
+  return buf + 1;
+}
+
+static
+void fork_bundle_free(void* p) {
+  fork_bundle_buf_t* buf = (fork_bundle_buf_t*) p - 1;
+
+  if (buf->hdr.capacity <= FORK_BUNDLE_POOL_MAX_BYTES) {
+    gasnet_hsl_lock(&fork_bundle_pool_lock);
+    if (fork_bundle_pool_count < FORK_BUNDLE_POOL_SIZE) {
+      buf->hdr.next = fork_bundle_pool;
+      fork_bundle_pool = buf;
+      fork_bundle_pool_count++;
+      buf = NULL;
+    }
+    gasnet_hsl_unlock(&fork_bundle_pool_lock);
+  }
+
+  if (buf != NULL)
+    chpl_mem_free(buf, 0, 0);
+}
+
+static
+void fork_bundle_pool_free_all(void) {
+  fork_bundle_buf_t* buf;
+
+  gasnet_hsl_lock(&fork_bundle_pool_lock);
+  buf = fork_bundle_pool;
+  fork_bundle_pool = NULL;
+  fork_bundle_pool_count = 0;
+  gasnet_hsl_unlock(&fork_bundle_pool_lock);
+
+  while (buf != NULL) {
+    fork_bundle_buf_t* next = buf->hdr.next;
+    chpl_mem_free(buf, 0, 0);
+    buf = next;
+  }
+}
+
+
 //
 // AM functions
 //
@@ -300,6 +397,12 @@ size_t setup_large_fork_task(large_fork_task_t* dst, large_fork_t* f, size_t nby
   // Copy the large fork info into the task bundle
   dst->large = *f;
 
+  // Start the bundle with the part of it that came in the message, so
+  // the task only has to GET the rest.
+  dst->large.local_arg = fork_bundle_alloc(f->arg_size,
+                                           CHPL_RT_MD_COMM_FRK_RCV_ARG);
+  memcpy(dst->large.local_arg, f + 1, f->prefix_size);
+
   return sizeof(large_fork_task_t);
 }
 
@@ -367,14 +470,12 @@ static void fork_large_wrapper(large_fork_task_t* f) {
   arg_on_caller = lg->arg;
   ack = lg->hdr.ack;
   fid = lg->hdr.fid;
+  arg = lg->local_arg;
 
-  // Allocate the bundle
-  arg = chpl_mem_allocMany(1, bundle_size_on_caller,
-                           CHPL_RT_MD_COMM_FRK_RCV_ARG, 0, 0);
-
-  // GET the bundle data
-  // TODO: This could get only the payload
-  chpl_comm_get(arg, caller, arg_on_caller, bundle_size_on_caller,
+  // GET the part of the bundle that didn't fit in the message
+  chpl_comm_get((char*) arg + lg->prefix_size, caller,
+                (char*) arg_on_caller + lg->prefix_size,
+                bundle_size_on_caller - lg->prefix_size,
                 -1 /*typeIndex: unused*/, CHPL_COMM_UNKNOWN_ID, 0, CHPL_FILE_IDX_FORK_LARGE);
 
   // Call the on body function
@@ -383,13 +484,11 @@ static void fork_large_wrapper(large_fork_task_t* f) {
   // Signal completion
   GASNET_Safe(gasnet_AMRequestShort2(caller, SIGNAL, Arg0(ack), Arg1(ack)));
 
-  // Free the bundle we just allocated.
-  chpl_mem_free(arg, 0, 0);
+  // Return the bundle buffer to the pool
+  fork_bundle_free(arg);
 }
 
-////GASNET - can we send as much of user data as possible initially
-////           hide data copy by making get non-blocking
-////GASNET - can we allocate f big enough so as not to need malloc in wrapper
+////GASNET - hide data copy by making get non-blocking
 static void AM_fork_large(gasnet_token_t token, void* buf, size_t nbytes) {
   large_fork_t *f = buf;
   large_fork_task_t task;
@@ -448,13 +547,12 @@ static void fork_nb_large_wrapper(large_fork_task_t* f) {
   bundle_size_on_caller = lg->arg_size;
   arg_on_caller = lg->arg;
   fid = lg->hdr.fid;
+  arg = lg->local_arg;
 
-  // Allocate the bundle
-  arg = chpl_mem_allocMany(1, bundle_size_on_caller,
-                           CHPL_RT_MD_COMM_FRK_RCV_ARG, 0, 0);
-
-  // GET the bundle data
-  chpl_comm_get(arg, caller, arg_on_caller, bundle_size_on_caller,
+  // GET the part of the bundle that didn't fit in the message
+  chpl_comm_get((char*) arg + lg->prefix_size, caller,
+                (char*) arg_on_caller + lg->prefix_size,
+                bundle_size_on_caller - lg->prefix_size,
                 -1 /*typeIndex: unused*/, CHPL_COMM_UNKNOWN_ID, 0, CHPL_FILE_IDX_FORK_LARGE);
 
   // Signal that the allocated region can be freed
@@ -465,8 +563,8 @@ static void fork_nb_large_wrapper(large_fork_task_t* f) {
   // Call the user function
   chpl_ftable_call(fid, arg);
 
-  // Free the bundle we just allocated
-  chpl_mem_free(arg, 0, 0);
+  // Return the bundle buffer to the pool
+  fork_bundle_free(arg);
 }
 
 static void AM_fork_nb_large(gasnet_token_t token, void* buf, size_t nbytes) {
@@ -522,8 +620,10 @@ static void AM_priv_bcast_large(gasnet_token_t token, void* buf, size_t nbytes)
 
 static void AM_free(gasnet_token_t token, gasnet_handlerarg_t a0, gasnet_handlerarg_t a1) {
   void* to_free = get_ptr_from_args(a0, a1);
-  
-  chpl_mem_free(to_free, 0, 0);
+
+  // Only the caller's copies of non-blocking large fork bundles are
+  // freed this way, and those come from the bundle pool.
+  fork_bundle_free(to_free);
 }
 
 // this is currently unused; it's intended to be used to implement
@@ -1045,6 +1145,9 @@ void chpl_comm_pre_task_exit(int all) {
     while (pollingRunning) {
       sched_yield();
     }
+
+    // No more forks can arrive, so the bundle buffers can go.
+    fork_bundle_pool_free_all();
   }
 }
 
@@ -1467,9 +1570,12 @@ void  execute_on_common(c_nodeid_t node, c_sublocid_t subloc,
       // Send the AM
       GASNET_Safe(gasnet_AMRequestMedium0(node, op, f, small_msg_size));
     } else {
-      // Setup a small message pointing to arg
-      // so the other side can GET from it
-      large_fork_t *f = &tmp.large;
+      // Setup a message pointing to arg so the other side can GET
+      // from it, and fill the rest of the message with the start of
+      // the bundle so the GET only has to fetch what is left.
+      size_t msg_size = gasnet_AMMaxMedium();
+      large_fork_t *f = fork_bundle_alloc(msg_size,
+                                          CHPL_RT_MD_COMM_FRK_SND_ARG);
       chpl_comm_on_bundle_t* use_arg;
 
       if (blocking)
@@ -1480,8 +1586,7 @@ void  execute_on_common(c_nodeid_t node, c_sublocid_t subloc,
         // to copy the argument if it is large.
         // An AM back to us will free it.
 
-        use_arg = chpl_mem_allocMany(1, arg_size,
-                                     CHPL_RT_MD_COMM_FRK_SND_ARG, 0, 0);
+        use_arg = fork_bundle_alloc(arg_size, CHPL_RT_MD_COMM_FRK_SND_ARG);
         chpl_memcpy(use_arg, arg, arg_size);
       }
 
@@ -1489,11 +1594,21 @@ void  execute_on_common(c_nodeid_t node, c_sublocid_t subloc,
       f->hdr = hdr;
 
       // Set the pointer to GET with
-      f->arg      = use_arg;
-      f->arg_size = arg_size;
+      f->arg         = use_arg;
+      f->arg_size    = arg_size;
+      f->local_arg   = NULL;
+      f->prefix_size = msg_size - sizeof(large_fork_t);
 
-      // Send the AM
-      GASNET_Safe(gasnet_AMRequestMedium0(node, op, f, sizeof(large_fork_t)));
+      // Copy in the start of the bundle
+      memcpy(f + 1, arg, f->prefix_size);
+
+      // Send the AM.  The payload of a medium AM has been copied out
+      // once the request returns, so the message can be reused then.
+      GASNET_Safe(gasnet_AMRequestMedium0(node, op, f, msg_size));
+
+      fork_bundle_free(f);
+
+      chpl_comm_diags_incr(execute_on_large);
     }
   } else {
     // Neither small nor large
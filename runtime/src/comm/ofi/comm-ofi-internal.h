@@ -57,6 +57,7 @@ FILE* chpl_comm_ofi_dbg_file;
 #define DBG_RMA               0x10000UL
 #define DBG_RMAWRITE          0x20000UL
 #define DBG_RMAREAD           0x40000UL
+#define DBG_AMO               0x80000UL
 #define DBG_ACK              0x100000UL
 #define DBG_COMMPROGRESS     0x200000UL
 #define DBG_MR              0x1000000UL
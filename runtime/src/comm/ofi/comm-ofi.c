@@ -24,7 +24,8 @@
 #include "chplrt.h"
 #include "chpl-env-gen.h"
 
-// #include "chpl-cache.h"
+#include "chpl-atomics.h"
+#include "chpl-cache.h"
 #include "chpl-comm.h"
 #include "chpl-comm-callbacks.h"
 #include "chpl-comm-callbacks-internal.h"
@@ -63,6 +64,7 @@
 #include <rdma/fi_endpoint.h>
 #include <rdma/fi_errno.h>
 #include <rdma/fi_rma.h>
+#include <rdma/fi_atomic.h>
 
 
 ////////////////////////////////////////
@@ -74,29 +76,98 @@ typedef enum {
   am_opFree = 0,                        // descriptor is free in table
   am_opNil,                             // no-op
   am_opWhatever,                        // whatever
+  am_opExecOn,                          // executeOn, arg in the request
+  am_opExecOnLrg,                       // executeOn, target GETs the arg
+  am_opFreeArg,                         // free a large executeOn arg copy
+  am_opAMO,                             // AMO the provider can't do
 } am_op_t;
 
-struct am_req_info {
+//
+// An operand or result of a network atomic operation.
+//
+typedef union {
+  int32_t i32;
+  uint32_t u32;
+  int64_t i64;
+  uint64_t u64;
+  _real32 r32;
+  _real64 r64;
+} chpl_amo_datum_t;
+
+struct amRequest_base {
   am_op_t op;
-  int id;
-  int nodeID;
-  int* finVal;
+  c_nodeid_t node;                      // initiator's node
+};
+
+struct amRequest_execOn {
+  struct amRequest_base b;
+  chpl_fn_int_t fid;                    // ftable[] index of the on body
+  c_sublocid_t subloc;                  // target sublocale
+  chpl_bool32 fast;                     // run the body in the AM handler
+  chpl_bool32* pDone;                   // 'done' flag on initiator, or NULL
+  size_t argSize;                       // size of hdr plus payload
+  chpl_comm_on_bundle_t hdr;            // must be last; payload follows
+};
+
+struct amRequest_execOnLrg {
+  struct amRequest_base b;
+  chpl_fn_int_t fid;                    // ftable[] index of the on body
+  c_sublocid_t subloc;                  // target sublocale
+  chpl_bool32* pDone;                   // 'done' flag on initiator, or NULL
+  chpl_task_ChapelData_t state;         // initiator's task state
+  void* pArg;                           // arg (bundle) on initiator
+  size_t argSize;                       // arg size
+};
+
+struct amRequest_freeArg {
+  struct amRequest_base b;
+  void* pArg;                           // arg copy on target
 };
 
+struct amRequest_AMO {
+  struct amRequest_base b;
+  enum fi_op ofiOp;                     // FI_ATOMIC_READ, FI_SUM, etc.
+  enum fi_datatype ofiType;             // FI_INT32, FI_DOUBLE, etc.
+  size_t size;                          // object size
+  void* obj;                            // object address on target
+  chpl_amo_datum_t opnd;                // operand, if any
+  chpl_amo_datum_t cmpr;                // FI_CSWAP comparand
+  void* result;                         // result address on initiator
+  chpl_bool32* pDone;                   // 'done' flag on initiator
+};
+
+//
+// All AM requests fit in one of these.  An executeOn whose argument
+// bundle has a payload bigger than AM_MAX_EXEC_ON_PAYLOAD sends the
+// target the address of the bundle instead, and the target GETs it.
+//
+#define AM_MAX_EXEC_ON_PAYLOAD 64
+
+typedef union {
+  struct amRequest_base b;
+  struct amRequest_execOn xo;
+  struct amRequest_execOnLrg xol;
+  struct amRequest_freeArg fa;
+  struct amRequest_AMO amo;
+  char space[sizeof(struct amRequest_execOn) + AM_MAX_EXEC_ON_PAYLOAD];
+} amRequest_t;
+
 static struct fi_info* ofi_info;        // fabric interface info
 static struct fid_fabric* ofi_fabric;   // fabric domain
 static struct fid_domain* ofi_domain;   // fabric access domain
 static struct fid_ep* ofi_txEp;         // scalable transmit endpoint
-static struct fid_ep* ofi_rxEp;         // AM req receive endpoint
-static struct fid_cq* ofi_rxCQ;         // receive endpoint CQ
+static struct fid_ep* ofi_rxEp;         // scalable AM req receive endpoint
 static struct fid_av* ofi_av;           // address vector, table style
 static fi_addr_t* ofi_rxAddrs;          // remote receive addrs
 
 static int txCQSize;                    // txCQ size
 
-static int numTxCtxs;
+static int numTxCtxs;                   // #worker tx contexts
 
-static int numAmLZs;                    // #AM landing zones per node
+static int numAmHandlers;               // #AM handlers, each with rx ctx
+static int rxCtxBits;                   // AV rx_ctx_bits
+
+static int numAmLZs;                    // #AM landing zones per handler
 
 struct perTxCtxInfo_t {
   int inited;
@@ -105,7 +176,6 @@ struct perTxCtxInfo_t {
   int isAmHandler;
   struct fid_ep* txCtx;
   struct fid_cq* txCQ;
-  struct fid_cntr* txCntr;
   int mrSetIdx;
   int tbIdx;
   int numAmReqsTxed;
@@ -113,6 +183,9 @@ struct perTxCtxInfo_t {
   int numReadsTxed;
   int numWritesTxed;
   int numTxsOut;
+  struct amoBuffEntry* amoBuff;         // buffered AMOs, see amoBuffFlush()
+  int amoBuffLen;
+  atomic_bool amoBuffLock;
 };
 
 static int ptiTabLen;
@@ -120,11 +193,35 @@ static struct perTxCtxInfo_t* ptiTab;
 static pthread_mutex_t pti_mutex = PTHREAD_MUTEX_INITIALIZER;
 static int ptiTabIdx = 0;
 
-static struct iovec ofi_iov_reqs;
-static struct fi_msg ofi_msg_reqs;
-static struct am_req_info* comm_amReqLZs;
+//
+// Each AM handler has its own receive context, with its own CQ and
+// multi-receive buffer of request landing zones, and its own transmit
+// context (in ptiTab[]) for the responses it sends.  Initiators spread
+// their requests over the handlers by tx context.
+//
+struct amHandlerInfo_t {
+  int idx;
+  struct fid_ep* rxCtx;
+  struct fid_cq* rxCQ;
+  amRequest_t* reqLZs;
+  struct iovec iovReqs;
+  struct fi_msg msgReqs;
+  struct perTxCtxInfo_t* tcip;
+
+  //
+  // Statistics, reported with DBG_STATS at exit.  The queue depth is
+  // the number of requests found in the CQ on a poll that found any.
+  //
+  uint64_t numPolls;                    // polls that found requests
+  uint64_t numReqs;                     // requests handled
+  uint64_t numFast;                     // executeOn bodies run in handler
+  uint64_t numQueued;                   // executeOn bodies run by tasks
+  int maxDepth;                         // deepest queue seen
+};
+
+static struct amHandlerInfo_t* amhTab;
 
-static struct am_req_info* comm_amReqs;
+static amRequest_t* comm_amReqs;
 
 static int comm_amFinFlagsSize;
 static int* comm_amFinFlags;
@@ -154,6 +251,18 @@ static memTab_t* memTabMap;
 
 static void time_init(void);
 
+static inline chpl_comm_nb_handle_t ofi_put(void*, c_nodeid_t, void*, size_t,
+                                            chpl_bool);
+static inline chpl_comm_nb_handle_t ofi_get(void*, c_nodeid_t, void*, size_t,
+                                            chpl_bool);
+
+static struct perTxCtxInfo_t* getTxCtxInfo(void);
+static void setTxCtxInfo(struct perTxCtxInfo_t*);
+static void releaseTxCtxInfo(struct perTxCtxInfo_t*);
+
+static void* allocBounceBuf(size_t);
+static void freeBounceBuf(void*);
+
 
 ////////////////////////////////////////
 //
@@ -219,6 +328,7 @@ const char* getProviderName(void) {
 static void init_ofi(void);
 static void init_ofiFabricDomain(void);
 static int compute_comm_concurrency(void);
+static int compute_num_am_handlers(void);
 static void init_ofiEp(void);
 static void init_ofiExchangeAvInfo(void);
 static void init_ofiForAms(void);
@@ -255,7 +365,7 @@ void chpl_comm_post_task_init(void) {
   init_am_handler();
 
   // Initialize the caching layer, if it is active.
-  // chpl_cache_init();
+  chpl_cache_init();
 
 }
 
@@ -283,7 +393,8 @@ void init_ofiFabricDomain(void) {
 
   hints->caps = FI_MSG | FI_SEND | FI_RECV | FI_MULTI_RECV
                 | FI_RMA | FI_READ | FI_WRITE
-                | FI_REMOTE_READ | FI_REMOTE_WRITE;
+                | FI_REMOTE_READ | FI_REMOTE_WRITE
+                | FI_ATOMIC;
 
   hints->mode = 0; // TODO: may need ~0 here and handle modes for good gni perf
 
@@ -312,8 +423,15 @@ void init_ofiFabricDomain(void) {
   // node 0; the other nodes should all have the same result and there's
   // no point in repeating everything numNodes times.
   //
+  // If nothing can do atomics, settle for a provider that can't.  We
+  // do network atomics using AMs in that case.
+  //
   int ret;
   ret = fi_getinfo(FI_VERSION(1,5), NULL, NULL, 0, hints, &ofi_info);
+  if (ret == -FI_ENODATA) {
+    hints->caps &= ~FI_ATOMIC;
+    ret = fi_getinfo(FI_VERSION(1,5), NULL, NULL, 0, hints, &ofi_info);
+  }
   if (chpl_nodeID == 0) {
     if (ret == -FI_ENODATA) {
       if (DBG_TEST_MASK(DBG_FABFAIL)) {
@@ -368,24 +486,30 @@ void init_ofiFabricDomain(void) {
 
   //
   // Compute numbers of outbound and inbound contexts and then create
-  // our scalable endpoint.  Each worker thread should get its own
-  // transmit context, plus the AM handler needs one to send 'finished'
-  // indicators on.  We only need 1 receive context, for requests sent
-  // to our our AM handler.
+  // our scalable endpoints.  Each worker thread should get its own
+  // transmit context, plus each AM handler needs one to send responses
+  // on.  Each AM handler also needs its own receive context, for the
+  // requests sent to it.
   //
   numTxCtxs = compute_comm_concurrency();
+  numAmHandlers = compute_num_am_handlers();
 
   {
     const struct fi_domain_attr* dom_attr = ofi_info->domain_attr;
-    if (numTxCtxs + 1 > dom_attr->max_ep_tx_ctx)
-      numTxCtxs = dom_attr->max_ep_tx_ctx - 1;
-    CHK_TRUE(numTxCtxs > 0);
-    ofi_info->ep_attr->tx_ctx_cnt = numTxCtxs + 1;
+    if (numAmHandlers > dom_attr->max_ep_rx_ctx)
+      numAmHandlers = dom_attr->max_ep_rx_ctx;
+    CHK_TRUE(numAmHandlers > 0);
+    ofi_info->ep_attr->rx_ctx_cnt = numAmHandlers;
 
-    CHK_TRUE(dom_attr->max_ep_rx_ctx >= 1);
-    ofi_info->ep_attr->rx_ctx_cnt = 1;
+    if (numTxCtxs + numAmHandlers > dom_attr->max_ep_tx_ctx)
+      numTxCtxs = dom_attr->max_ep_tx_ctx - numAmHandlers;
+    CHK_TRUE(numTxCtxs > 0);
+    ofi_info->ep_attr->tx_ctx_cnt = numTxCtxs + numAmHandlers;
   }
 
+  for (rxCtxBits = 0; (1 << rxCtxBits) < numAmHandlers; rxCtxBits++)
+    ;
+
   //
   // Create address vectors for each thread.
   //
@@ -393,7 +517,7 @@ void init_ofiFabricDomain(void) {
   ofi_avAttr.type = FI_AV_TABLE;
   ofi_avAttr.count = chpl_numNodes;
   ofi_avAttr.name = NULL;
-  ofi_avAttr.rx_ctx_bits = 0;
+  ofi_avAttr.rx_ctx_bits = rxCtxBits;
 
   OFI_CHK(fi_av_open(ofi_domain, &ofi_avAttr, &ofi_av, NULL));
 }
@@ -429,10 +553,24 @@ int compute_comm_concurrency(void) {
 }
 
 
+static
+int compute_num_am_handlers(void) {
+  int val;
+
+  if ((val = chpl_env_rt_get_int("COMM_OFI_NUM_AM_HANDLERS", 1)) > 0) {
+    return val;
+  }
+
+  chpl_warning("CHPL_RT_COMM_OFI_NUM_AM_HANDLERS < 1, using 1", 0, 0);
+  return 1;
+}
+
+
 static
 void init_ofiEp(void) {
-  ptiTabLen = numTxCtxs + 1;
+  ptiTabLen = numTxCtxs + numAmHandlers;
   CHPL_CALLOC(ptiTab, ptiTabLen);
+  CHPL_CALLOC(amhTab, numAmHandlers);
 
   //
   // Transmit.
@@ -453,41 +591,54 @@ void init_ofiEp(void) {
   txCqAttr.size = txCQSize;
   txCqAttr.wait_obj = FI_WAIT_NONE;
 
-  struct fi_cntr_attr txCntrAttr = { 0 };
-  txCntrAttr.events = FI_CNTR_EVENTS_COMP;
-  txCntrAttr.wait_obj = FI_WAIT_NONE;
-
   //
-  // Worker TX contexts use CQs; AM handler just needs a counter.
+  // The worker tx contexts come first, then the AM handlers' ones.  The
+  // handlers do RMA (and run "fast" executeOn bodies that may do their
+  // own), so theirs use CQs just like the workers' do.
   //
   for (int i = 0; i < ptiTabLen; i++) {
+    ptiTab[i].idx = i;
+    ptiTab[i].isAmHandler = (i >= numTxCtxs);
     OFI_CHK(fi_tx_context(ofi_txEp, i, NULL, &ptiTab[i].txCtx, NULL));
-    if (i < ptiTabLen - 1) {
-      OFI_CHK(fi_cq_open(ofi_domain, &txCqAttr, &ptiTab[i].txCQ, NULL));
-      OFI_CHK(fi_ep_bind(ptiTab[i].txCtx, &ptiTab[i].txCQ->fid, FI_TRANSMIT));
-    } else {
-      OFI_CHK(fi_cntr_open(ofi_domain, &txCntrAttr, &ptiTab[i].txCntr, NULL));
-      OFI_CHK(fi_ep_bind(ptiTab[i].txCtx, &ptiTab[i].txCntr->fid, FI_WRITE));
-    }
+    OFI_CHK(fi_cq_open(ofi_domain, &txCqAttr, &ptiTab[i].txCQ, NULL));
+    OFI_CHK(fi_ep_bind(ptiTab[i].txCtx, &ptiTab[i].txCQ->fid, FI_TRANSMIT));
     OFI_CHK(fi_enable(ptiTab[i].txCtx));
+    atomic_init_bool(&ptiTab[i].amoBuffLock, false);
   }
 
   //
   // Receive.
   //
   // For the CQ length, allow for an appreciable proportion of the job
-  // to send requests to us at once.
+  // to send requests to each handler at once.
   //
   struct fi_cq_attr rxCqAttr = { 0 };
   rxCqAttr.format = FI_CQ_FORMAT_DATA;
-  rxCqAttr.size = chpl_numNodes * numTxCtxs;
+  rxCqAttr.size = (chpl_numNodes * numTxCtxs + numAmHandlers - 1)
+                  / numAmHandlers;
   rxCqAttr.wait_obj = FI_WAIT_NONE;
 
-  OFI_CHK(fi_endpoint(ofi_domain, ofi_info, &ofi_rxEp, NULL));
-  OFI_CHK(fi_ep_bind(ofi_rxEp, &ofi_av->fid, 0));
-  OFI_CHK(fi_cq_open(ofi_domain, &rxCqAttr, &ofi_rxCQ, NULL));
-  OFI_CHK(fi_ep_bind(ofi_rxEp, &ofi_rxCQ->fid, FI_RECV));
-  OFI_CHK(fi_enable(ofi_rxEp));
+  OFI_CHK(fi_scalable_ep(ofi_domain, ofi_info, &ofi_rxEp, NULL));
+  OFI_CHK(fi_scalable_ep_bind(ofi_rxEp, &ofi_av->fid, 0));
+
+  //
+  // Have the provider give back an AM request multi-receive buffer
+  // when there isn't room left in it for the largest request.
+  //
+  const size_t minMultiRecv = sizeof(amRequest_t);
+
+  for (int i = 0; i < numAmHandlers; i++) {
+    struct amHandlerInfo_t* amh = &amhTab[i];
+    amh->idx = i;
+    amh->tcip = &ptiTab[numTxCtxs + i];
+    OFI_CHK(fi_rx_context(ofi_rxEp, i, NULL, &amh->rxCtx, NULL));
+    OFI_CHK(fi_cq_open(ofi_domain, &rxCqAttr, &amh->rxCQ, NULL));
+    OFI_CHK(fi_ep_bind(amh->rxCtx, &amh->rxCQ->fid, FI_RECV));
+    OFI_CHK(fi_setopt(&amh->rxCtx->fid, FI_OPT_ENDPOINT,
+                      FI_OPT_MIN_MULTI_RECV,
+                      &minMultiRecv, sizeof(minMultiRecv)));
+    OFI_CHK(fi_enable(amh->rxCtx));
+  }
 }
 
 
@@ -535,7 +686,8 @@ void init_ofiForAms(void) {
   // that times the number of nodes in the job.  We also know from that
   // same test that the Chapel runtime comm=ugni AM handler can only
   // handle just over 1.5m "fast" AM requests per second.  Ours cannot
-  // achieve that rate yet, but it's a reasonable upper limit.
+  // achieve that rate yet, but it's a reasonable upper limit.  Requests
+  // are spread over the AM handlers, so each one gets its share.
   //
   {
     const int maxAmsPerSecPerInitiator = 150000;
@@ -544,26 +696,32 @@ void init_ofiForAms(void) {
     const int maxAmsPerSecPerHandler = 1500000;
     if (numAmLZs > maxAmsPerSecPerHandler)
       numAmLZs = maxAmsPerSecPerHandler;
+
+    numAmLZs = (numAmLZs + numAmHandlers - 1) / numAmHandlers;
   }
 
-  //
-  // Create space for inbound AM request landing zones.
-  //
-  CHPL_CALLOC(comm_amReqLZs, numAmLZs);
+  for (int i = 0; i < numAmHandlers; i++) {
+    struct amHandlerInfo_t* amh = &amhTab[i];
 
-  //
-  // Pre-post multi-receive buffer for inbound AM requests.
-  //
-  ofi_iov_reqs.iov_base = comm_amReqLZs;
-  ofi_iov_reqs.iov_len = numAmLZs * sizeof(*comm_amReqLZs);
-  ofi_msg_reqs.msg_iov = &ofi_iov_reqs;
-  ofi_msg_reqs.desc = NULL;
-  ofi_msg_reqs.iov_count = 1;
-  ofi_msg_reqs.addr = FI_ADDR_UNSPEC;
-  ofi_msg_reqs.context = NULL;
-  ofi_msg_reqs.data = 0x0;
-  OFI_CHK(fi_recvmsg(ofi_rxEp, &ofi_msg_reqs, FI_MULTI_RECV));
-  DBG_PRINTF(DBG_AM | DBG_AMRECV, "pre-post fi_recvmsg(AMReqs)");
+    //
+    // Create space for inbound AM request landing zones.
+    //
+    CHPL_CALLOC(amh->reqLZs, numAmLZs);
+
+    //
+    // Pre-post multi-receive buffer for inbound AM requests.
+    //
+    amh->iovReqs.iov_base = amh->reqLZs;
+    amh->iovReqs.iov_len = numAmLZs * sizeof(amh->reqLZs[0]);
+    amh->msgReqs.msg_iov = &amh->iovReqs;
+    amh->msgReqs.desc = NULL;
+    amh->msgReqs.iov_count = 1;
+    amh->msgReqs.addr = FI_ADDR_UNSPEC;
+    amh->msgReqs.context = NULL;
+    amh->msgReqs.data = 0x0;
+    OFI_CHK(fi_recvmsg(amh->rxCtx, &amh->msgReqs, FI_MULTI_RECV));
+    DBG_PRINTF(DBG_AM | DBG_AMRECV, "pre-post fi_recvmsg(AMReqs[%d])", i);
+  }
 
   //
   // Create initiator-side AM request and 'finished' space.
@@ -580,8 +738,58 @@ void init_ofiForAms(void) {
 }
 
 
+//
+// For each data type, whether the provider can do all the network
+// atomic operations we need on it.  We don't mix provider atomics with
+// processor atomics (in AMs) for any one type, because the former need
+// not be atomic with respect to the latter.
+//
+static chpl_bool amoNative[FI_DATATYPE_LAST];
+
+
 static
 void init_ofiForRma(void) {
+  if ((ofi_info->caps & FI_ATOMIC) == 0) {
+    DBG_PRINTF(DBG_AMO, "provider has no atomics; using AMs for AMOs");
+    return;
+  }
+
+  static const struct {
+    enum fi_datatype type;
+    chpl_bool isInt;
+  } amoTypes[] = { { FI_INT32, true },
+                   { FI_UINT32, true },
+                   { FI_INT64, true },
+                   { FI_UINT64, true },
+                   { FI_FLOAT, false },
+                   { FI_DOUBLE, false }, };
+
+  struct fid_ep* ep = ptiTab[0].txCtx;
+
+  for (int i = 0; i < sizeof(amoTypes) / sizeof(amoTypes[0]); i++) {
+    const enum fi_datatype type = amoTypes[i].type;
+    size_t count;
+    chpl_bool ok;
+
+    ok = fi_atomicvalid(ep, type, FI_ATOMIC_WRITE, &count) == 0
+         && fi_atomicvalid(ep, type, FI_SUM, &count) == 0
+         && fi_fetch_atomicvalid(ep, type, FI_ATOMIC_READ, &count) == 0
+         && fi_fetch_atomicvalid(ep, type, FI_ATOMIC_WRITE, &count) == 0
+         && fi_fetch_atomicvalid(ep, type, FI_SUM, &count) == 0
+         && fi_compare_atomicvalid(ep, type, FI_CSWAP, &count) == 0;
+
+    if (ok && amoTypes[i].isInt) {
+      static const enum fi_op bitOps[] = { FI_BAND, FI_BOR, FI_BXOR };
+      for (int j = 0; ok && j < sizeof(bitOps) / sizeof(bitOps[0]); j++) {
+        ok = fi_atomicvalid(ep, type, bitOps[j], &count) == 0
+             && fi_fetch_atomicvalid(ep, type, bitOps[j], &count) == 0;
+      }
+    }
+
+    amoNative[type] = ok;
+    DBG_PRINTF(DBG_AMO, "AMOs on %s: %s",
+               fi_tostr(&type, FI_TYPE_ATOMIC_TYPE), ok ? "native" : "AM");
+  }
 }
 
 
@@ -730,19 +938,20 @@ void fini_ofi(void) {
   CHPL_FREE(comm_amFinFlags);
 
   CHPL_FREE(comm_amReqs);
-  CHPL_FREE(comm_amReqLZs);
 
   CHPL_FREE(ofi_rxAddrs);
 
+  for (int i = 0; i < numAmHandlers; i++) {
+    OFI_CHK(fi_close(&amhTab[i].rxCtx->fid));
+    OFI_CHK(fi_close(&amhTab[i].rxCQ->fid));
+    CHPL_FREE(amhTab[i].reqLZs);
+  }
   OFI_CHK(fi_close(&ofi_rxEp->fid));
-  OFI_CHK(fi_close(&ofi_rxCQ->fid));
+  CHPL_FREE(amhTab);
 
   for (int i = 0; i < ptiTabLen; i++) {
     OFI_CHK(fi_close(&ptiTab[i].txCtx->fid));
-    if (i < ptiTabLen - 1)
-      OFI_CHK(fi_close(&ptiTab[i].txCQ->fid));
-    else
-      OFI_CHK(fi_close(&ptiTab[i].txCntr->fid));
+    OFI_CHK(fi_close(&ptiTab[i].txCQ->fid));
   }
 
   OFI_CHK(fi_close(&ofi_txEp->fid));
@@ -1025,21 +1234,17 @@ int mrGetRemoteKey(uint64_t* pKey, int iNode, void* addr, int len) {
 // Interface: Active Message support
 //
 
-#define num_am_handlers 1
-
 static int am_handler_count;
 static atomic_bool am_handlers_please_exit;
 static pthread_cond_t amh_startStop_cond = PTHREAD_COND_INITIALIZER;
 static pthread_mutex_t amh_startStop_mutex = PTHREAD_MUTEX_INITIALIZER;
 
-struct ofi_am_info {
-  c_nodeid_t node;
-  c_sublocid_t subloc;
-  chpl_bool serial_state; // To prevent creation of new tasks
-  chpl_bool fast;
-  chpl_bool blocking;
-  chpl_fn_int_t fid;
-  void* ack;
+//
+// What a non-"fast" large executeOn task gets as its argument.
+//
+struct amExecOnLrgTask_t {
+  chpl_task_bundle_t task;
+  struct amRequest_execOnLrg xol;
 };
 
 
@@ -1050,44 +1255,57 @@ static
 void init_am_handler(void) {
   atomic_init_bool(&am_handlers_please_exit, false);
 
-  if (num_am_handlers > 0) {
-    // Start AM handler thread(s).  Don't proceed from here until at
-    // least one is running.
-    PTHREAD_CHK(pthread_mutex_lock(&amh_startStop_mutex));
+  //
+  // Start the AM handler threads.  Don't proceed from here until they
+  // are all running, so nobody can send a request to one that isn't.
+  //
+  PTHREAD_CHK(pthread_mutex_lock(&amh_startStop_mutex));
 
-    for (int i = 0; i < num_am_handlers; i++) {
-      if (chpl_task_createCommTask(am_handler, NULL) != 0) {
-        INTERNAL_ERROR_V("unable to start AM handler thread");
-      }
+  for (int i = 0; i < numAmHandlers; i++) {
+    if (chpl_task_createCommTask(am_handler, &amhTab[i]) != 0) {
+      INTERNAL_ERROR_V("unable to start AM handler thread");
     }
+  }
 
-    // Some AM handler thread we created will release us.
+  // The last AM handler thread to start will release us.
+  while (am_handler_count < numAmHandlers) {
     PTHREAD_CHK(pthread_cond_wait(&amh_startStop_cond,
                                   &amh_startStop_mutex));
-    PTHREAD_CHK(pthread_mutex_unlock(&amh_startStop_mutex));
   }
+  PTHREAD_CHK(pthread_mutex_unlock(&amh_startStop_mutex));
 }
 
 
 static
 void fini_am_handler(void) {
   //
-  // Tear down the AM handler thread(s).  On node 0, don't proceed from
-  // here until the last one has finished (TODO).
+  // Tear down the AM handler threads.  Don't proceed from here until
+  // the last one has finished.
   //
   PTHREAD_CHK(pthread_mutex_lock(&amh_startStop_mutex));
   atomic_store_bool(&am_handlers_please_exit, true);
-  PTHREAD_CHK(pthread_cond_wait(&amh_startStop_cond,
-                                &amh_startStop_mutex));
+  while (am_handler_count > 0) {
+    PTHREAD_CHK(pthread_cond_wait(&amh_startStop_cond,
+                                  &amh_startStop_mutex));
+  }
   PTHREAD_CHK(pthread_mutex_unlock(&amh_startStop_mutex));
 
   atomic_destroy_bool(&am_handlers_please_exit);
 }
 
 
-#if 0
-static void handle_am(struct fi_cq_data_entry*);
-#endif
+static int processRxAmReqCQ(struct amHandlerInfo_t*);
+static void handle_am(struct amHandlerInfo_t*, amRequest_t*);
+static void amHandleExecOn(struct amHandlerInfo_t*,
+                           struct amRequest_execOn*);
+static void amHandleExecOnLrg(struct amHandlerInfo_t*,
+                              struct amRequest_execOnLrg*);
+static void amWrapExecOnBody(chpl_comm_on_bundle_t*);
+static void amWrapExecOnLrgBody(struct amExecOnLrgTask_t*);
+static void amSendDone(c_nodeid_t, chpl_bool32*);
+static void amHandleAMO(struct amRequest_AMO*);
+static void amRequestCommon(c_nodeid_t, amRequest_t*, size_t,
+                            chpl_bool32*);
 
 static void execute_on_common(c_nodeid_t, c_sublocid_t,
                               chpl_fn_int_t,
@@ -1095,73 +1313,51 @@ static void execute_on_common(c_nodeid_t, c_sublocid_t,
                               chpl_bool, chpl_bool);
 
 
-int chpl_comm_numPollingTasks(void) { return 1; }
+int chpl_comm_numPollingTasks(void) { return numAmHandlers; }
 
 
 void chpl_comm_make_progress(void) { }
 
 
 /*
- * The AM handler runs this.
+ * The AM handlers run this.
  */
-static void am_handler(void *argNil) {
-#if 0
-  struct progress_thread_info* pti = args;
-  const int id = pti->id;
-  const int num_rbufs = 2;
-  struct iovec iov[num_rbufs];
-  struct fi_msg msg[num_rbufs];
-  struct ofi_am_info* dst_buf[num_rbufs];
-  const int rbuf_len = 10;
-  const size_t rbuf_size = rbuf_len*sizeof(dst_buf[0][0]);
-  const int num_cqes = rbuf_len;
-  struct fi_cq_data_entry cqes[num_cqes];
-  int num_read;
-
-  int i;
+static void am_handler(void *arg) {
+  struct amHandlerInfo_t* amh = (struct amHandlerInfo_t*) arg;
 
-  for (i = 0; i < num_rbufs; i++) {
-    dst_buf[i] = chpl_mem_allocMany(rbuf_len, sizeof(dst_buf[i][0]),
-                                    CHPL_RT_MD_COMM_UTIL, 0, 0);
-    iov[i].iov_base = dst_buf[i];
-    iov[i].iov_len = rbuf_size;
-    msg[i].msg_iov = &iov[i];
-    msg[i].desc = (void **) fi_mr_desc(ofi.mr);
-    msg[i].iov_count = 1;
-    msg[i].addr = FI_ADDR_UNSPEC;
-    msg[i].context = (void *) (uint64_t) i;
-    msg[i].data = 0x0;
-    OFI_CHK(fi_recvmsg(ofi.am_rx_ep[id], &msg[i], FI_MULTI_RECV));
-  }
-#endif
+  //
+  // Do our own RMA on our own tx context, including RMA done by the
+  // "fast" executeOn bodies we run.
+  //
+  setTxCtxInfo(amh->tcip);
 
   // Count this AM handler thread as running.  The creator thread
-  // wants to be released as soon as at least one AM handler thread
-  // is running, so if we're the first, do that.
+  // wants to be released once all of them are running, so if we're
+  // the last, do that.
   PTHREAD_CHK(pthread_mutex_lock(&amh_startStop_mutex));
-  if (++am_handler_count == 1)
+  if (++am_handler_count == numAmHandlers)
     PTHREAD_CHK(pthread_cond_signal(&amh_startStop_cond));
   PTHREAD_CHK(pthread_mutex_unlock(&amh_startStop_mutex));
 
+  DBG_PRINTF(DBG_AM, "AM handler %d running", amh->idx);
+
   // Wait for events
   while (!atomic_load_bool(&am_handlers_please_exit)) {
-#if 0
-    num_read = fi_cq_read(ofi.am_rx_cq[id], cqes, num_cqes);
-    if (num_read > 0) {
-      for (i = 0; i < num_read; i++) {
-        handle_am(&cqes[i]);
-        // send ack
-      }
-    } else {
-      if (num_read != -FI_EAGAIN) {
-        INTERNAL_ERROR_V("%s", fi_strerror(-num_read));
-      }
+    if (processRxAmReqCQ(amh) == 0) {
+      sched_yield();
     }
-#else
-    sched_yield();
-#endif
   }
 
+  DBG_PRINTF(DBG_STATS,
+             "AM handler %d: %" PRIu64 " reqs, "
+             "%" PRIu64 " fast executeOns, %" PRIu64 " queued to tasks; "
+             "queue depth avg %.2f, max %d",
+             amh->idx, amh->numReqs, amh->numFast, amh->numQueued,
+             (amh->numPolls == 0)
+             ? 0.0
+             : (double) amh->numReqs / (double) amh->numPolls,
+             amh->maxDepth);
+
   // Un-count this AM handler thread.  Whoever told us to exit wants to
   // be released once all the AM handler threads are done, so if we're
   // the last, do that.
@@ -1191,13 +1387,6 @@ void chpl_comm_execute_on(c_nodeid_t node, c_sublocid_t subloc,
 }
 
 
-#ifdef BLAH
-static void fork_nb_wrapper(chpl_comm_on_bundle_t *f) {
-  chpl_ftable_call(f->task_bundle.requested_fid, f);
-}
-#endif
-
-
 void chpl_comm_execute_on_nb(c_nodeid_t node, c_sublocid_t subloc,
                              chpl_fn_int_t fid,
                              chpl_comm_on_bundle_t *arg, size_t arg_size) {
@@ -1242,18 +1431,260 @@ static void execute_on_common(c_nodeid_t node, c_sublocid_t subloc,
                               chpl_fn_int_t fid,
                               chpl_comm_on_bundle_t* arg, size_t arg_size,
                               chpl_bool fast, chpl_bool blocking) {
-  INTERNAL_ERROR_V("Remote ons not yet implemented");
+  //
+  // For a blocking executeOn the target tells us when the body is done
+  // by PUTting to our 'done' flag, so that has to be in registered
+  // memory.
+  //
+  chpl_bool32* pDone = NULL;
+  if (blocking) {
+    pDone = allocBounceBuf(sizeof(*pDone));
+  }
+
+  amRequest_t req;
+
+  if (offsetof(struct amRequest_execOn, hdr) + arg_size <= sizeof(req)) {
+    //
+    // The whole argument bundle fits in the request.  Send only as
+    // much of the request as we're using.
+    //
+    req.xo = (struct amRequest_execOn) { .b = { .op = am_opExecOn,
+                                                .node = chpl_nodeID, },
+                                         .fid = fid,
+                                         .subloc = subloc,
+                                         .fast = fast,
+                                         .pDone = pDone,
+                                         .argSize = arg_size, };
+    memcpy(&req.xo.hdr, arg, arg_size);
+    amRequestCommon(node, &req,
+                    offsetof(struct amRequest_execOn, hdr) + arg_size,
+                    pDone);
+  } else {
+    //
+    // The argument bundle is too big to send, so the target will GET
+    // it from us.  It has to be in registered memory and has to last
+    // until the target is done with it.  For a blocking executeOn we
+    // don't return until the body is done, so the caller's bundle will
+    // do if it's registered.  Otherwise we make a copy, which the
+    // target frees (with an AM back to us) for a non-blocking one.
+    //
+    void* pArg = arg;
+    void* mrDesc;
+    if (!blocking || mrGetLocalDesc(&mrDesc, arg, arg_size) != 0) {
+      pArg = allocBounceBuf(arg_size);
+      memcpy(pArg, arg, arg_size);
+    }
+
+    req.xol = (struct amRequest_execOnLrg) { .b = { .op = am_opExecOnLrg,
+                                                    .node = chpl_nodeID, },
+                                             .fid = fid,
+                                             .subloc = subloc,
+                                             .pDone = pDone,
+                                             .state = arg->task_bundle.state,
+                                             .pArg = pArg,
+                                             .argSize = arg_size, };
+    amRequestCommon(node, &req, sizeof(req.xol), pDone);
+
+    if (blocking && pArg != arg) {
+      freeBounceBuf(pArg);
+    }
+  }
 
-  // bundle args
-  // send to remote AM port
+  if (pDone != NULL) {
+    freeBounceBuf(pDone);
+  }
 }
 
 
-#if 0
-static void handle_am(struct fi_cq_data_entry* cqe) {
+//
+// Handle whatever AM requests have arrived for the given AM handler,
+// returning how many there were.
+//
+static
+int processRxAmReqCQ(struct amHandlerInfo_t* amh) {
+  struct fi_cq_data_entry cqes[16];
+  const size_t maxEvents = sizeof(cqes) / sizeof(cqes[0]);
+  int ret;
+
+  CHK_TRUE((ret = fi_cq_read(amh->rxCQ, cqes, maxEvents)) > 0
+           || ret == -FI_EAGAIN);
+
+  if (ret <= 0) {
+    return 0;
+  }
+
+  const int numEvents = ret;
+  int numReqs = 0;
+  for (int i = 0; i < numEvents; i++) {
+    if ((cqes[i].flags & FI_RECV) != 0 && cqes[i].len > 0) {
+      DBG_PRINTF(DBG_AM | DBG_AMRECV,
+                 "AM handler %d: CQ rx AM req @ buf %p, len %zd",
+                 amh->idx, cqes[i].buf, cqes[i].len);
+
+      //
+      // Requests are packed into the landing zones at whatever offsets
+      // they happen to land, so copy each one out to get it aligned.
+      //
+      amRequest_t req;
+      CHK_TRUE(cqes[i].len <= sizeof(req));
+      memcpy(&req, cqes[i].buf, cqes[i].len);
+      handle_am(amh, &req);
+      numReqs++;
+    }
+
+    if ((cqes[i].flags & FI_MULTI_RECV) != 0) {
+      //
+      // The provider has given back the multi-receive buffer.  All the
+      // requests in it have been handled, so we can re-post it.
+      //
+      OFI_CHK(fi_recvmsg(amh->rxCtx, &amh->msgReqs, FI_MULTI_RECV));
+      DBG_PRINTF(DBG_AM | DBG_AMRECV,
+                 "AM handler %d: re-post fi_recvmsg(AMReqs)", amh->idx);
+    }
+  }
+
+  if (numReqs > 0) {
+    amh->numPolls++;
+    amh->numReqs += numReqs;
+    if (numReqs > amh->maxDepth) {
+      amh->maxDepth = numReqs;
+    }
+  }
 
+  return numEvents;
+}
+
+
+static
+void handle_am(struct amHandlerInfo_t* amh, amRequest_t* req) {
+  switch (req->b.op) {
+  case am_opExecOn:
+    amHandleExecOn(amh, &req->xo);
+    break;
+
+  case am_opExecOnLrg:
+    amHandleExecOnLrg(amh, &req->xol);
+    break;
+
+  case am_opFreeArg:
+    freeBounceBuf(req->fa.pArg);
+    break;
+
+  case am_opAMO:
+    amHandleAMO(&req->amo);
+    break;
+
+  default:
+    INTERNAL_ERROR_V("unexpected AM req op %d", (int) req->b.op);
+    break;
+  }
+}
+
+
+//
+// A "fast" executeOn body is run right here in the AM handler, since
+// the compiler has told us it won't block or run long.  Any other is
+// handed off to a task, so that it can't hold up the requests behind
+// it in the queue.
+//
+static
+void amHandleExecOn(struct amHandlerInfo_t* amh,
+                    struct amRequest_execOn* xo) {
+  chpl_comm_on_bundle_t* bundle = &xo->hdr;
+
+  if (xo->fast) {
+    amh->numFast++;
+    chpl_ftable_call(xo->fid, bundle);
+    if (xo->pDone != NULL) {
+      amSendDone(xo->b.node, xo->pDone);
+    }
+    return;
+  }
+
+  amh->numQueued++;
+
+  //
+  // Save what the wrapper needs in the comm part of the bundle.  The
+  // task layer makes its own copy of the bundle.
+  //
+  bundle->comm.fid = xo->fid;
+  bundle->comm.caller = xo->b.node;
+  bundle->comm.ack = xo->pDone;
+
+  chpl_task_startMovedTask(xo->fid,
+                           ((xo->pDone == NULL)
+                            ? (chpl_fn_p) chpl_ftable[xo->fid]
+                            : (chpl_fn_p) amWrapExecOnBody),
+                           chpl_comm_on_bundle_task_bundle(bundle),
+                           xo->argSize, xo->subloc, chpl_nullTaskID);
+}
+
+
+static
+void amHandleExecOnLrg(struct amHandlerInfo_t* amh,
+                       struct amRequest_execOnLrg* xol) {
+  amh->numQueued++;
+
+  //
+  // We have to GET the argument bundle, so this is never run in the
+  // AM handler.
+  //
+  struct amExecOnLrgTask_t task;
+  task.task.state = xol->state;
+  task.xol = *xol;
+
+  chpl_task_startMovedTask(xol->fid,
+                           (chpl_fn_p) amWrapExecOnLrgBody,
+                           &task.task, sizeof(task),
+                           xol->subloc, chpl_nullTaskID);
+}
+
+
+static
+void amWrapExecOnBody(chpl_comm_on_bundle_t* bundle) {
+  chpl_ftable_call(bundle->comm.fid, bundle);
+  amSendDone(bundle->comm.caller, (chpl_bool32*) bundle->comm.ack);
+}
+
+
+static
+void amWrapExecOnLrgBody(struct amExecOnLrgTask_t* task) {
+  struct amRequest_execOnLrg* xol = &task->xol;
+  const c_nodeid_t node = xol->b.node;
+
+  //
+  // Get the argument bundle from the initiator.  For a non-blocking
+  // executeOn the initiator's copy can go as soon as we have it.
+  //
+  chpl_comm_on_bundle_t* bundle;
+  bundle = chpl_mem_alloc(xol->argSize, CHPL_RT_MD_COMM_FRK_RCV_ARG, 0, 0);
+  (void) ofi_get(bundle, node, xol->pArg, xol->argSize, true /*blocking*/);
+
+  if (xol->pDone == NULL) {
+    amRequest_t req = { .fa = { .b = { .op = am_opFreeArg,
+                                       .node = chpl_nodeID, },
+                                .pArg = xol->pArg, }, };
+    amRequestCommon(node, &req, sizeof(req.fa), NULL);
+  }
+
+  chpl_ftable_call(xol->fid, bundle);
+
+  if (xol->pDone != NULL) {
+    amSendDone(node, xol->pDone);
+  }
+
+  chpl_mem_free(bundle, 0, 0);
+}
+
+
+//
+// Tell the initiator an AM is done.
+//
+static
+void amSendDone(c_nodeid_t node, chpl_bool32* pDone) {
+  static chpl_bool32 done = true;
+  (void) ofi_put(&done, node, pDone, sizeof(done), true /*blocking*/);
 }
-#endif
 
 
 ////////////////////////////////////////
@@ -1261,23 +1692,49 @@ static void handle_am(struct fi_cq_data_entry* cqe) {
 // Interface: RMA support
 //
 
-static inline chpl_comm_nb_handle_t ofi_put(void*, c_nodeid_t, void*, size_t);
-static inline chpl_comm_nb_handle_t ofi_get(void*, c_nodeid_t, void*, size_t);
+//
+// Every PUT and GET carries one of these as its operation context, so
+// that when the completion event shows up in the tx CQ we know which
+// operation finished.  Blocking operations use one on the stack; for
+// non-blocking ones it is allocated here and handed back to the caller
+// as the chpl_comm_nb_handle_t.
+//
+typedef struct {
+  atomic_bool complete;
+  struct perTxCtxInfo_t* tcip;          // tx context the op was posted on
+  void* bounceBuf;                      // non-NULL if bounce buffered
+  void* addr;                           // GET: where the data goes
+  size_t size;
+} nb_handle_t;
 
-static void waitForTxCQ(struct perTxCtxInfo_t*, int);
-static struct perTxCtxInfo_t* getTxCtxInfo(void);
-static void releaseTxCtxInfo(struct perTxCtxInfo_t*);
+typedef nb_handle_t* nb_handle;
 
-static void* allocBounceBuf(size_t);
-static void freeBounceBuf(void*);
+static void waitForTxCQ(struct perTxCtxInfo_t*, nb_handle);
+static int checkTxCQ(struct perTxCtxInfo_t*);
+static chpl_bool retireNbHandle(chpl_comm_nb_handle_t*);
 
 
 chpl_comm_nb_handle_t chpl_comm_put_nb(void *addr, c_nodeid_t node,
                                        void* raddr, size_t size,
                                        int32_t typeIndex, int32_t commID,
                                        int ln, int32_t fn) {
-  chpl_comm_put(addr, node, raddr, size, typeIndex, commID, ln, fn);
-  return NULL;
+  assert(addr != NULL
+         && raddr != NULL
+         && node != chpl_nodeID);
+
+  // Communications callback support
+  if (chpl_comm_have_callbacks(chpl_comm_cb_event_kind_put_nb)) {
+      chpl_comm_cb_info_t cb_data =
+        {chpl_comm_cb_event_kind_put_nb, chpl_nodeID, node,
+         .iu.comm={addr, raddr, size, typeIndex, commID, ln, fn}};
+      chpl_comm_do_callbacks (&cb_data);
+  }
+
+  chpl_comm_diags_verbose_printf("%s:%d: remote non-blocking put to %d",
+                                 chpl_lookupFilename(fn), ln, (int) node);
+  chpl_comm_diags_incr(put_nb);
+
+  return ofi_put(addr, node, raddr, size, false /*blocking*/);
 }
 
 
@@ -1285,8 +1742,23 @@ chpl_comm_nb_handle_t chpl_comm_get_nb(void* addr, c_nodeid_t node,
                                        void* raddr, size_t size,
                                        int32_t typeIndex, int32_t commID,
                                        int ln, int32_t fn) {
-  chpl_comm_get(addr, node, raddr, size, typeIndex, commID, ln, fn);
-  return NULL;
+  assert(addr != NULL
+         && raddr != NULL
+         && node != chpl_nodeID);
+
+  // Communications callback support
+  if (chpl_comm_have_callbacks(chpl_comm_cb_event_kind_get_nb)) {
+      chpl_comm_cb_info_t cb_data =
+        {chpl_comm_cb_event_kind_get_nb, chpl_nodeID, node,
+         .iu.comm={addr, raddr, size, typeIndex, commID, ln, fn}};
+      chpl_comm_do_callbacks (&cb_data);
+  }
+
+  chpl_comm_diags_verbose_printf("%s:%d: remote non-blocking get from %d",
+                                 chpl_lookupFilename(fn), ln, (int) node);
+  chpl_comm_diags_incr(get_nb);
+
+  return ofi_get(addr, node, raddr, size, false /*blocking*/);
 }
 
 
@@ -1296,7 +1768,10 @@ int chpl_comm_test_nb_complete(chpl_comm_nb_handle_t h) {
   }
   chpl_comm_diags_incr(test_nb);
 
-  // fi_cq_readfrom?
+  //
+  // Handles are cleared when they are retired in chpl_comm_wait_nb_some()
+  // or chpl_comm_try_nb_some(), so only NULL ones are complete.
+  //
   return ((void*) h) == NULL;
 }
 
@@ -1310,11 +1785,24 @@ void chpl_comm_wait_nb_some(chpl_comm_nb_handle_t* h, size_t nhandles) {
   }
   chpl_comm_diags_incr(wait_nb);
 
-  size_t i;
-  // fi_cq_readfrom?
-  for( i = 0; i < nhandles; i++ ) {
-    assert(h[i] == NULL);
-  }
+  //
+  // Each pass over the handles drains whatever completions are in the
+  // CQs, so a single pass can retire many of them.  If a pass doesn't
+  // finish everything, let other tasks run before we look again.
+  //
+  size_t numPending;
+  do {
+    numPending = 0;
+    for (size_t i = 0; i < nhandles; i++) {
+      if (h[i] != NULL && !retireNbHandle(&h[i])) {
+        numPending++;
+      }
+    }
+
+    if (numPending > 0) {
+      chpl_task_yield();
+    }
+  } while (numPending > 0);
 }
 
 
@@ -1328,12 +1816,39 @@ int chpl_comm_try_nb_some(chpl_comm_nb_handle_t* h, size_t nhandles) {
   }
   chpl_comm_diags_incr(try_nb);
 
-  size_t i;
-  // fi_cq_readfrom?
-  for( i = 0; i < nhandles; i++ ) {
-    assert(h[i] == NULL);
+  int numRetired = 0;
+  for (size_t i = 0; i < nhandles; i++) {
+    if (h[i] != NULL && retireNbHandle(&h[i])) {
+      numRetired++;
+    }
   }
-  return 0;
+  return numRetired > 0;
+}
+
+
+//
+// If the operation for the given handle is done (checking the CQ it was
+// posted on if needed), free the handle, clear it, and return true.
+//
+// This polls the CQ of the tx context the operation was posted on.
+// Tasks stay on the thread they start on and tx contexts belong to
+// threads, so that is also the calling thread's context.
+//
+static
+chpl_bool retireNbHandle(chpl_comm_nb_handle_t* ph) {
+  nb_handle h = (nb_handle) *ph;
+
+  if (!atomic_load_bool(&h->complete)) {
+    (void) checkTxCQ(h->tcip);
+    if (!atomic_load_bool(&h->complete)) {
+      return false;
+    }
+  }
+
+  atomic_destroy_bool(&h->complete);
+  CHPL_FREE(h);
+  *ph = NULL;
+  return true;
 }
 
 
@@ -1360,7 +1875,7 @@ void chpl_comm_put(void* addr, c_nodeid_t node, void* raddr,
                                  chpl_lookupFilename(fn), ln, (int) node);
   chpl_comm_diags_incr(put);
 
-  (void) ofi_put(addr, node, raddr, size);
+  (void) ofi_put(addr, node, raddr, size, true /*blocking*/);
 }
 
 
@@ -1387,7 +1902,7 @@ void chpl_comm_get(void* addr, int32_t node, void* raddr,
                                  chpl_lookupFilename(fn), ln, (int) node);
   chpl_comm_diags_incr(get);
 
-  (void) ofi_get(addr, node, raddr, size);
+  (void) ofi_get(addr, node, raddr, size, true /*blocking*/);
 }
 
 
@@ -1421,115 +1936,228 @@ void chpl_comm_get_strd(void* dstaddr_arg, size_t* dststrides,
 }
 
 
-static inline
-chpl_comm_nb_handle_t ofi_put(void* addr, c_nodeid_t node,
-                              void* raddr, size_t size) {
-  struct perTxCtxInfo_t* tcip;
-  CHK_TRUE((tcip = getTxCtxInfo()) != NULL);
-
-  void* mrDesc;
+//
+// Post an RMA operation, riding out any transient lack of resources by
+// retiring completions until the provider can take it.
+//
+#define OFI_RIDE_OUT_EAGAIN(tcip, expr)                                 \
+    do {                                                                \
+      int _rc;                                                          \
+      while ((_rc = (expr)) == -FI_EAGAIN) {                            \
+        (void) checkTxCQ(tcip);                                         \
+      }                                                                 \
+      if (_rc != FI_SUCCESS) {                                          \
+        INTERNAL_ERROR_V("%s: %s", #expr, fi_strerror(- _rc));          \
+      }                                                                 \
+    } while (0)
+
+
+static inline
+nb_handle allocNbHandle(struct perTxCtxInfo_t* tcip, nb_handle hStack,
+                        chpl_bool blocking) {
+  nb_handle h;
+
+  //
+  // Never have more operations in flight than the CQ can hold
+  // completions for.
+  //
+  while (tcip->numTxsOut >= txCQSize) {
+    (void) checkTxCQ(tcip);
+  }
+
+  if (blocking) {
+    h = hStack;
+  } else {
+    CHPL_CALLOC(h, 1);
+  }
+
+  atomic_init_bool(&h->complete, false);
+  h->tcip = tcip;
+  h->bounceBuf = NULL;
+  h->addr = NULL;
+  h->size = 0;
+  return h;
+}
+
+
+static inline
+chpl_comm_nb_handle_t ofi_put(void* addr, c_nodeid_t node,
+                              void* raddr, size_t size,
+                              chpl_bool blocking) {
+  struct perTxCtxInfo_t* tcip;
+  CHK_TRUE((tcip = getTxCtxInfo()) != NULL);
+
+  nb_handle_t hStack;
+  nb_handle h = allocNbHandle(tcip, &hStack, blocking);
+
+  void* mrDesc;
   void* myAddr = addr;
   if (mrGetLocalDesc(&mrDesc, myAddr, size) != 0) {
     myAddr = allocBounceBuf(size);
     CHK_TRUE(mrGetLocalDesc(&mrDesc, myAddr, size) == 0);
     memcpy(myAddr, addr, size);
+    h->bounceBuf = myAddr;
   }
 
   uint64_t mrKey;
   CHK_TRUE(mrGetRemoteKey(&mrKey, node, raddr, size) == 0);
 
-  OFI_CHK(fi_write(tcip->txCtx, myAddr, size,
-                   mrDesc, ofi_rxAddrs[node], (uint64_t) raddr, mrKey, 0));
+  OFI_RIDE_OUT_EAGAIN(tcip,
+                      fi_write(tcip->txCtx, myAddr, size,
+                               mrDesc, ofi_rxAddrs[node], (uint64_t) raddr,
+                               mrKey, h));
+  tcip->numTxsOut++;
+  tcip->numWritesTxed++;
   DBG_PRINTF(DBG_RMA | DBG_RMAWRITE,
-             "tx write: %d:%p <= %p%s, size %zd, key 0x%" PRIx64,
+             "tx write%s: %d:%p <= %p%s, size %zd, key 0x%" PRIx64 ", ctx %p",
+             blocking ? "" : " nb",
              (int) node, raddr, addr, (myAddr == addr) ? "" : "(B)", size,
-             mrKey);
+             mrKey, h);
 
-  waitForTxCQ(tcip, 1);
+  if (blocking) {
+    waitForTxCQ(tcip, h);
+    atomic_destroy_bool(&h->complete);
+    h = NULL;
+  }
 
   releaseTxCtxInfo(tcip);
 
-  if (myAddr != addr) {
-    freeBounceBuf(myAddr);
-  }
-
-  return NULL;
+  return h;
 }
 
 
 static inline
 chpl_comm_nb_handle_t ofi_get(void *addr, c_nodeid_t node,
-                              void* raddr, size_t size) {
+                              void* raddr, size_t size,
+                              chpl_bool blocking) {
   struct perTxCtxInfo_t* tcip;
   CHK_TRUE((tcip = getTxCtxInfo()) != NULL);
 
+  nb_handle_t hStack;
+  nb_handle h = allocNbHandle(tcip, &hStack, blocking);
+
   void* mrDesc;
   void* myAddr = addr;
   if (mrGetLocalDesc(&mrDesc, myAddr, size) != 0) {
     myAddr = allocBounceBuf(size);
     CHK_TRUE(mrGetLocalDesc(&mrDesc, myAddr, size) == 0);
+    h->bounceBuf = myAddr;
+    h->addr = addr;
+    h->size = size;
   }
 
   uint64_t mrKey;
   CHK_TRUE(mrGetRemoteKey(&mrKey, node, raddr, size) == 0);
 
-  OFI_CHK(fi_read(tcip->txCtx, addr, size,
-                  mrDesc, ofi_rxAddrs[node], (uint64_t) raddr, mrKey, 0));
-  DBG_PRINTF(DBG_RMA | DBG_RMAWRITE,
-             "tx read: %p <= %d:%p, len %zd, key 0x%" PRIx64,
-             addr, (int) node, raddr, size, mrKey);
-
-  waitForTxCQ(tcip, 1);
+  OFI_RIDE_OUT_EAGAIN(tcip,
+                      fi_read(tcip->txCtx, myAddr, size,
+                              mrDesc, ofi_rxAddrs[node], (uint64_t) raddr,
+                              mrKey, h));
+  tcip->numTxsOut++;
+  tcip->numReadsTxed++;
+  DBG_PRINTF(DBG_RMA | DBG_RMAREAD,
+             "tx read%s: %p%s <= %d:%p, len %zd, key 0x%" PRIx64 ", ctx %p",
+             blocking ? "" : " nb",
+             addr, (myAddr == addr) ? "" : "(B)", (int) node, raddr, size,
+             mrKey, h);
+
+  if (blocking) {
+    waitForTxCQ(tcip, h);
+    atomic_destroy_bool(&h->complete);
+    h = NULL;
+  }
 
   releaseTxCtxInfo(tcip);
 
-  if (myAddr != addr) {
-    memcpy(addr, myAddr, size);
-    freeBounceBuf(myAddr);
+  return h;
+}
+
+
+//
+// Finish off the operation for a handle whose completion event we have
+// just seen.  For a bounce buffered GET this is where the data reaches
+// its real destination.  Setting the complete flag is the last thing we
+// do, because after that the owner is free to release the handle.
+//
+static inline
+void completeNbHandle(nb_handle h) {
+  if (h->bounceBuf != NULL) {
+    if (h->addr != NULL) {
+      memcpy(h->addr, h->bounceBuf, h->size);
+    }
+    freeBounceBuf(h->bounceBuf);
   }
 
-  return NULL;
+  atomic_store_bool(&h->complete, true);
 }
 
 
+//
+// Retire whatever completions are in the tx CQ, a batch at a time, and
+// return how many there were.
+//
 static
-void waitForTxCQ(struct perTxCtxInfo_t* tcip, int numOut) {
-  if (numOut > 0) {
-    struct fi_cq_entry cqes[numOut];
-    int numRetired = 0;
-
-    do {
-      int ret;
-      CHK_TRUE((ret = fi_cq_read(tcip->txCQ, cqes, numOut)) > 0
-               || ret == -FI_EAGAIN);
-
-      if (ret > 0) {
-        const int numEvents = ret;
-        numRetired += numEvents;
-        for (int i = 0; i < numEvents; i++) {
-          DBG_PRINTF(DBG_ACK, "CQ ack tx");
-        }
-      }
-    } while (numRetired < numOut);
+int checkTxCQ(struct perTxCtxInfo_t* tcip) {
+  struct fi_cq_entry cqes[16];
+  const size_t maxEvents = sizeof(cqes) / sizeof(cqes[0]);
+  int ret;
+
+  CHK_TRUE((ret = fi_cq_read(tcip->txCQ, cqes, maxEvents)) > 0
+           || ret == -FI_EAGAIN);
+
+  if (ret <= 0) {
+    return 0;
+  }
+
+  const int numEvents = ret;
+  for (int i = 0; i < numEvents; i++) {
+    DBG_PRINTF(DBG_ACK, "CQ ack tx, ctx %p", cqes[i].op_context);
+    completeNbHandle((nb_handle) cqes[i].op_context);
+  }
+  tcip->numTxsOut -= numEvents;
+
+  return numEvents;
+}
+
+
+//
+// Wait for the operation with the given handle to complete.  Other
+// operations' completions may come in first; those are retired too.
+//
+static
+void waitForTxCQ(struct perTxCtxInfo_t* tcip, nb_handle h) {
+  while (!atomic_load_bool(&h->complete)) {
+    (void) checkTxCQ(tcip);
   }
 }
 
 
+static __thread struct perTxCtxInfo_t* myTcip;
+
+
 static inline
 struct perTxCtxInfo_t* getTxCtxInfo(void) {
-  static __thread struct perTxCtxInfo_t* tcip;
-
-  if (tcip == NULL) {
+  if (myTcip == NULL) {
     PTHREAD_CHK(pthread_mutex_lock(&pti_mutex));
-    if (ptiTabIdx >= ptiTabLen - 1) {
+    if (ptiTabIdx >= numTxCtxs) {
       INTERNAL_ERROR_V("out of ptiTab[] entries");
     }
-    tcip = &ptiTab[ptiTabIdx++];
+    myTcip = &ptiTab[ptiTabIdx++];
     PTHREAD_CHK(pthread_mutex_unlock(&pti_mutex));
-    DBG_PRINTF(DBG_THREADS, "I have ptiTab[%td]", tcip - ptiTab);
+    DBG_PRINTF(DBG_THREADS, "I have ptiTab[%td]", myTcip - ptiTab);
   }
 
-  return tcip;
+  return myTcip;
+}
+
+
+//
+// The AM handlers use this to claim their own tx contexts.
+//
+static inline
+void setTxCtxInfo(struct perTxCtxInfo_t* tcip) {
+  myTcip = tcip;
+  DBG_PRINTF(DBG_THREADS, "I have ptiTab[%td]", myTcip - ptiTab);
 }
 
 
@@ -1555,6 +2183,724 @@ static void freeBounceBuf(void* p) {
 }
 
 
+//
+// Send an AM request and wait for the send to complete.  If the caller
+// gives us a 'done' flag, also wait for the target node to set it.
+//
+static
+void amRequestCommon(c_nodeid_t node, amRequest_t* req, size_t reqSize,
+                     chpl_bool32* pDone) {
+  struct perTxCtxInfo_t* tcip;
+  CHK_TRUE((tcip = getTxCtxInfo()) != NULL);
+
+  nb_handle_t hStack;
+  nb_handle h = allocNbHandle(tcip, &hStack, true /*blocking*/);
+
+  void* mrDesc;
+  void* myReq = req;
+  if (mrGetLocalDesc(&mrDesc, myReq, reqSize) != 0) {
+    myReq = allocBounceBuf(reqSize);
+    CHK_TRUE(mrGetLocalDesc(&mrDesc, myReq, reqSize) == 0);
+    memcpy(myReq, req, reqSize);
+    h->bounceBuf = myReq;
+  }
+
+  //
+  // Each tx context always sends to the same one of the target's AM
+  // handlers, which spreads the load evenly when all the threads are
+  // sending.
+  //
+  const fi_addr_t rxAddr = fi_rx_addr(ofi_rxAddrs[node],
+                                      tcip->idx % numAmHandlers, rxCtxBits);
+  OFI_RIDE_OUT_EAGAIN(tcip,
+                      fi_send(tcip->txCtx, myReq, reqSize, mrDesc,
+                              rxAddr, h));
+  tcip->numTxsOut++;
+  tcip->numAmReqsTxed++;
+  DBG_PRINTF(DBG_AM | DBG_AMSEND,
+             "tx AM req to %d: op %d, len %zd",
+             (int) node, (int) req->b.op, reqSize);
+
+  waitForTxCQ(tcip, h);
+  atomic_destroy_bool(&h->complete);
+
+  releaseTxCtxInfo(tcip);
+
+  if (pDone != NULL) {
+    while (!*(volatile chpl_bool32*) pDone) {
+      chpl_task_yield();
+    }
+  }
+}
+
+
+////////////////////////////////////////
+//
+// Interface: network atomics
+//
+// Each operation on a data type the provider fully supports (see
+// init_ofiForRma()) is done with libfabric atomics, even when the
+// object is local, so that all the operations on an object are atomic
+// with respect to each other.  Otherwise the operation is done with
+// processor atomics: directly if the object is local, and by the
+// target node's AM handler if not.
+//
+
+static void doAMO(c_nodeid_t, void*, const void*, const void*, void*,
+                  enum fi_op, enum fi_datatype, size_t);
+static void doAMOBuff(c_nodeid_t, void*, const void*,
+                      enum fi_op, enum fi_datatype, size_t);
+
+
+//
+// Atomic Put functions:
+//   _f: interface function name suffix (type)
+//   _t: C type
+//   _o: libfabric data type
+//
+#define DEFN_CHPL_COMM_ATOMIC_PUT(_f, _t, _o)                           \
+  void chpl_comm_atomic_put_##_f(void* desired, int32_t node,           \
+                                 void* object, int ln, int32_t fn) {    \
+    DBG_PRINTF(DBG_AMO, "chpl_comm_atomic_put_" #_f "(%p, %d, %p)",     \
+               desired, (int) node, object);                            \
+    doAMO(node, object, desired, NULL, NULL,                            \
+          FI_ATOMIC_WRITE, _o, sizeof(_t));                             \
+  }
+
+DEFN_CHPL_COMM_ATOMIC_PUT(int32, int32_t, FI_INT32)
+DEFN_CHPL_COMM_ATOMIC_PUT(int64, int64_t, FI_INT64)
+DEFN_CHPL_COMM_ATOMIC_PUT(uint32, uint32_t, FI_UINT32)
+DEFN_CHPL_COMM_ATOMIC_PUT(uint64, uint64_t, FI_UINT64)
+DEFN_CHPL_COMM_ATOMIC_PUT(real32, _real32, FI_FLOAT)
+DEFN_CHPL_COMM_ATOMIC_PUT(real64, _real64, FI_DOUBLE)
+
+#undef DEFN_CHPL_COMM_ATOMIC_PUT
+
+
+//
+// Atomic Get functions:
+//   _f: interface function name suffix (type)
+//   _t: C type
+//   _o: libfabric data type
+//
+#define DEFN_CHPL_COMM_ATOMIC_GET(_f, _t, _o)                           \
+  void chpl_comm_atomic_get_##_f(void* result, int32_t node,            \
+                                 void* object, int ln, int32_t fn) {    \
+    DBG_PRINTF(DBG_AMO, "chpl_comm_atomic_get_" #_f "(%p, %d, %p)",     \
+               result, (int) node, object);                             \
+    doAMO(node, object, NULL, NULL, result,                             \
+          FI_ATOMIC_READ, _o, sizeof(_t));                              \
+  }
+
+DEFN_CHPL_COMM_ATOMIC_GET(int32, int32_t, FI_INT32)
+DEFN_CHPL_COMM_ATOMIC_GET(int64, int64_t, FI_INT64)
+DEFN_CHPL_COMM_ATOMIC_GET(uint32, uint32_t, FI_UINT32)
+DEFN_CHPL_COMM_ATOMIC_GET(uint64, uint64_t, FI_UINT64)
+DEFN_CHPL_COMM_ATOMIC_GET(real32, _real32, FI_FLOAT)
+DEFN_CHPL_COMM_ATOMIC_GET(real64, _real64, FI_DOUBLE)
+
+#undef DEFN_CHPL_COMM_ATOMIC_GET
+
+
+//
+// Atomic Exchange functions:
+//   _f: interface function name suffix (type)
+//   _t: C type
+//   _o: libfabric data type
+//
+#define DEFN_CHPL_COMM_ATOMIC_XCHG(_f, _t, _o)                          \
+  void chpl_comm_atomic_xchg_##_f(void* desired, int32_t node,          \
+                                  void* object, void* result,           \
+                                  int ln, int32_t fn) {                 \
+    DBG_PRINTF(DBG_AMO, "chpl_comm_atomic_xchg_" #_f "(%p, %d, %p, %p)", \
+               desired, (int) node, object, result);                    \
+    doAMO(node, object, desired, NULL, result,                          \
+          FI_ATOMIC_WRITE, _o, sizeof(_t));                             \
+  }
+
+DEFN_CHPL_COMM_ATOMIC_XCHG(int32, int32_t, FI_INT32)
+DEFN_CHPL_COMM_ATOMIC_XCHG(int64, int64_t, FI_INT64)
+DEFN_CHPL_COMM_ATOMIC_XCHG(uint32, uint32_t, FI_UINT32)
+DEFN_CHPL_COMM_ATOMIC_XCHG(uint64, uint64_t, FI_UINT64)
+DEFN_CHPL_COMM_ATOMIC_XCHG(real32, _real32, FI_FLOAT)
+DEFN_CHPL_COMM_ATOMIC_XCHG(real64, _real64, FI_DOUBLE)
+
+#undef DEFN_CHPL_COMM_ATOMIC_XCHG
+
+
+//
+// Atomic Compare Exchange functions:
+//   _f: interface function name suffix (type)
+//   _t: C type
+//   _o: libfabric data type
+//
+#define DEFN_CHPL_COMM_ATOMIC_CMPXCHG(_f, _t, _o)                       \
+  void chpl_comm_atomic_cmpxchg_##_f(void* expected, void* desired,     \
+                                     int32_t node, void* object,        \
+                                     chpl_bool32* result,               \
+                                     int ln, int32_t fn) {              \
+    DBG_PRINTF(DBG_AMO,                                                 \
+               "chpl_comm_atomic_cmpxchg_" #_f "(%p, %p, %d, %p, %p)",  \
+               expected, desired, (int) node, object, result);          \
+    doAMO(node, object, desired, expected, result,                      \
+          FI_CSWAP, _o, sizeof(_t));                                    \
+  }
+
+DEFN_CHPL_COMM_ATOMIC_CMPXCHG(int32, int32_t, FI_INT32)
+DEFN_CHPL_COMM_ATOMIC_CMPXCHG(int64, int64_t, FI_INT64)
+DEFN_CHPL_COMM_ATOMIC_CMPXCHG(uint32, uint32_t, FI_UINT32)
+DEFN_CHPL_COMM_ATOMIC_CMPXCHG(uint64, uint64_t, FI_UINT64)
+DEFN_CHPL_COMM_ATOMIC_CMPXCHG(real32, _real32, FI_FLOAT)
+DEFN_CHPL_COMM_ATOMIC_CMPXCHG(real64, _real64, FI_DOUBLE)
+
+#undef DEFN_CHPL_COMM_ATOMIC_CMPXCHG
+
+
+//
+// Atomic binary operations, non-fetching, buffered non-fetching, and
+// fetching:
+//   _n: interface function name operation
+//   _c: libfabric operation
+//   _f: interface function name suffix (type)
+//   _t: C type
+//   _o: libfabric data type
+//
+#define DEFN_CHPL_COMM_ATOMIC_BINARY(_n, _c, _f, _t, _o)                \
+  void chpl_comm_atomic_##_n##_##_f(void* operand, int32_t node,        \
+                                    void* object,                       \
+                                    int ln, int32_t fn) {               \
+    DBG_PRINTF(DBG_AMO, "chpl_comm_atomic_" #_n "_" #_f "(%p, %d, %p)", \
+               operand, (int) node, object);               \
+    doAMO(node, object, operand, NULL, NULL, _c, _o, sizeof(_t));       \
+  }                                                                     \
+                                                                        \
+  void chpl_comm_atomic_##_n##_buff_##_f(void* operand, int32_t node,   \
+                                         void* object,                  \
+                                         int ln, int32_t fn) {          \
+    DBG_PRINTF(DBG_AMO,                                                 \
+               "chpl_comm_atomic_" #_n "_buff_" #_f "(%p, %d, %p)",     \
+               operand, (int) node, object);               \
+    doAMOBuff(node, object, operand, _c, _o, sizeof(_t));               \
+  }                                                                     \
+                                                                        \
+  void chpl_comm_atomic_fetch_##_n##_##_f(void* operand, int32_t node,  \
+                                          void* object, void* result,   \
+                                          int ln, int32_t fn) {         \
+    DBG_PRINTF(DBG_AMO,                                                 \
+               "chpl_comm_atomic_fetch_" #_n "_" #_f "(%p, %d, %p, %p)", \
+               operand, (int) node, object, result);       \
+    doAMO(node, object, operand, NULL, result, _c, _o, sizeof(_t));     \
+  }
+
+DEFN_CHPL_COMM_ATOMIC_BINARY(and, FI_BAND, int32, int32_t, FI_INT32)
+DEFN_CHPL_COMM_ATOMIC_BINARY(and, FI_BAND, int64, int64_t, FI_INT64)
+DEFN_CHPL_COMM_ATOMIC_BINARY(and, FI_BAND, uint32, uint32_t, FI_UINT32)
+DEFN_CHPL_COMM_ATOMIC_BINARY(and, FI_BAND, uint64, uint64_t, FI_UINT64)
+
+DEFN_CHPL_COMM_ATOMIC_BINARY(or, FI_BOR, int32, int32_t, FI_INT32)
+DEFN_CHPL_COMM_ATOMIC_BINARY(or, FI_BOR, int64, int64_t, FI_INT64)
+DEFN_CHPL_COMM_ATOMIC_BINARY(or, FI_BOR, uint32, uint32_t, FI_UINT32)
+DEFN_CHPL_COMM_ATOMIC_BINARY(or, FI_BOR, uint64, uint64_t, FI_UINT64)
+
+DEFN_CHPL_COMM_ATOMIC_BINARY(xor, FI_BXOR, int32, int32_t, FI_INT32)
+DEFN_CHPL_COMM_ATOMIC_BINARY(xor, FI_BXOR, int64, int64_t, FI_INT64)
+DEFN_CHPL_COMM_ATOMIC_BINARY(xor, FI_BXOR, uint32, uint32_t, FI_UINT32)
+DEFN_CHPL_COMM_ATOMIC_BINARY(xor, FI_BXOR, uint64, uint64_t, FI_UINT64)
+
+DEFN_CHPL_COMM_ATOMIC_BINARY(add, FI_SUM, int32, int32_t, FI_INT32)
+DEFN_CHPL_COMM_ATOMIC_BINARY(add, FI_SUM, int64, int64_t, FI_INT64)
+DEFN_CHPL_COMM_ATOMIC_BINARY(add, FI_SUM, uint32, uint32_t, FI_UINT32)
+DEFN_CHPL_COMM_ATOMIC_BINARY(add, FI_SUM, uint64, uint64_t, FI_UINT64)
+DEFN_CHPL_COMM_ATOMIC_BINARY(add, FI_SUM, real32, _real32, FI_FLOAT)
+DEFN_CHPL_COMM_ATOMIC_BINARY(add, FI_SUM, real64, _real64, FI_DOUBLE)
+
+#undef DEFN_CHPL_COMM_ATOMIC_BINARY
+
+
+//
+// Atomic subtract functions.  There is no libfabric subtract, so these
+// negate the operand and add.
+//   _f: interface function name suffix (type)
+//   _t: C type
+//
+#define DEFN_CHPL_COMM_ATOMIC_SUB(_f, _t)                               \
+  void chpl_comm_atomic_sub_##_f(void* operand, int32_t node,           \
+                                 void* object,                          \
+                                 int ln, int32_t fn) {                  \
+    _t nOperand = - *(_t*) operand;                                     \
+    chpl_comm_atomic_add_##_f(&nOperand, node, object, ln, fn);         \
+  }                                                                     \
+                                                                        \
+  void chpl_comm_atomic_sub_buff_##_f(void* operand, int32_t node,      \
+                                      void* object,                     \
+                                      int ln, int32_t fn) {             \
+    _t nOperand = - *(_t*) operand;                                     \
+    chpl_comm_atomic_add_buff_##_f(&nOperand, node, object, ln, fn);    \
+  }                                                                     \
+                                                                        \
+  void chpl_comm_atomic_fetch_sub_##_f(void* operand, int32_t node,     \
+                                       void* object, void* result,      \
+                                       int ln, int32_t fn) {            \
+    _t nOperand = - *(_t*) operand;                                     \
+    chpl_comm_atomic_fetch_add_##_f(&nOperand, node, object, result,    \
+                                    ln, fn);                            \
+  }
+
+DEFN_CHPL_COMM_ATOMIC_SUB(int32, int32_t)
+DEFN_CHPL_COMM_ATOMIC_SUB(int64, int64_t)
+DEFN_CHPL_COMM_ATOMIC_SUB(uint32, uint32_t)
+DEFN_CHPL_COMM_ATOMIC_SUB(uint64, uint64_t)
+DEFN_CHPL_COMM_ATOMIC_SUB(real32, _real32)
+DEFN_CHPL_COMM_ATOMIC_SUB(real64, _real64)
+
+#undef DEFN_CHPL_COMM_ATOMIC_SUB
+
+
+//
+// Processor atomic operations, for each type:
+//   _t: chpl-atomics type name suffix (also the C type)
+//   _m: chpl_amo_datum_t member
+//
+// For FI_CSWAP the result is whether the exchange happened, not the old
+// value.  That's what the interface needs, and we can't get the latter
+// from chpl-atomics anyway.
+//
+#define CPU_AMO_COMMON_OPS(_t, _m)                                      \
+    case FI_ATOMIC_READ:                                                \
+      res._m = atomic_load_##_t(obj);                                   \
+      break;                                                            \
+                                                                        \
+    case FI_ATOMIC_WRITE:                                               \
+      if (result == NULL) {                                             \
+        atomic_store_##_t(obj, opnd->_m);                               \
+      } else {                                                          \
+        res._m = atomic_exchange_##_t(obj, opnd->_m);                   \
+      }                                                                 \
+      break;                                                            \
+                                                                        \
+    case FI_CSWAP:                                                      \
+      *(chpl_bool32*) result =                                          \
+        atomic_compare_exchange_strong_##_t(obj, cmpr->_m, opnd->_m);   \
+      return;                                                           \
+                                                                        \
+    case FI_SUM:                                                        \
+      res._m = atomic_fetch_add_##_t(obj, opnd->_m);                    \
+      break;
+
+#define DEFN_CPU_AMO_INT(_t, _m)                                        \
+  static                                                                \
+  void doCpuAMO_##_t(atomic_##_t* obj,                                  \
+                     const chpl_amo_datum_t* opnd,                      \
+                     const chpl_amo_datum_t* cmpr,                      \
+                     void* result, enum fi_op ofiOp) {                  \
+    chpl_amo_datum_t res;                                               \
+                                                                        \
+    switch (ofiOp) {                                                    \
+    CPU_AMO_COMMON_OPS(_t, _m)                                          \
+                                                                        \
+    case FI_BAND:                                                       \
+      res._m = atomic_fetch_and_##_t(obj, opnd->_m);                    \
+      break;                                                            \
+                                                                        \
+    case FI_BOR:                                                        \
+      res._m = atomic_fetch_or_##_t(obj, opnd->_m);                     \
+      break;                                                            \
+                                                                        \
+    case FI_BXOR:                                                       \
+      res._m = atomic_fetch_xor_##_t(obj, opnd->_m);                    \
+      break;                                                            \
+                                                                        \
+    default:                                                            \
+      INTERNAL_ERROR_V("unexpected AMO op %d", (int) ofiOp);            \
+      break;                                                            \
+    }                                                                   \
+                                                                        \
+    if (result != NULL) {                                               \
+      memcpy(result, &res._m, sizeof(res._m));                          \
+    }                                                                   \
+  }
+
+#define DEFN_CPU_AMO_REAL(_t, _m)                                       \
+  static                                                                \
+  void doCpuAMO_##_t(atomic_##_t* obj,                                  \
+                     const chpl_amo_datum_t* opnd,                      \
+                     const chpl_amo_datum_t* cmpr,                      \
+                     void* result, enum fi_op ofiOp) {                  \
+    chpl_amo_datum_t res;                                               \
+                                                                        \
+    switch (ofiOp) {                                                    \
+    CPU_AMO_COMMON_OPS(_t, _m)                                          \
+                                                                        \
+    default:                                                            \
+      INTERNAL_ERROR_V("unexpected AMO op %d", (int) ofiOp);            \
+      break;                                                            \
+    }                                                                   \
+                                                                        \
+    if (result != NULL) {                                               \
+      memcpy(result, &res._m, sizeof(res._m));                          \
+    }                                                                   \
+  }
+
+DEFN_CPU_AMO_INT(int_least32_t, i32)
+DEFN_CPU_AMO_INT(int_least64_t, i64)
+DEFN_CPU_AMO_INT(uint_least32_t, u32)
+DEFN_CPU_AMO_INT(uint_least64_t, u64)
+DEFN_CPU_AMO_REAL(_real32, r32)
+DEFN_CPU_AMO_REAL(_real64, r64)
+
+#undef DEFN_CPU_AMO_INT
+#undef DEFN_CPU_AMO_REAL
+#undef CPU_AMO_COMMON_OPS
+
+
+static
+void doCpuAMO(void* obj, const void* opnd, const void* cmpr, void* result,
+              enum fi_op ofiOp, enum fi_datatype ofiType, size_t size) {
+  chpl_amo_datum_t myOpnd;
+  chpl_amo_datum_t myCmpr;
+
+  if (opnd != NULL) {
+    memcpy(&myOpnd, opnd, size);
+  }
+  if (cmpr != NULL) {
+    memcpy(&myCmpr, cmpr, size);
+  }
+
+  switch (ofiType) {
+  case FI_INT32:
+    doCpuAMO_int_least32_t(obj, &myOpnd, &myCmpr, result, ofiOp);
+    break;
+  case FI_UINT32:
+    doCpuAMO_uint_least32_t(obj, &myOpnd, &myCmpr, result, ofiOp);
+    break;
+  case FI_INT64:
+    doCpuAMO_int_least64_t(obj, &myOpnd, &myCmpr, result, ofiOp);
+    break;
+  case FI_UINT64:
+    doCpuAMO_uint_least64_t(obj, &myOpnd, &myCmpr, result, ofiOp);
+    break;
+  case FI_FLOAT:
+    doCpuAMO__real32(obj, &myOpnd, &myCmpr, result, ofiOp);
+    break;
+  case FI_DOUBLE:
+    doCpuAMO__real64(obj, &myOpnd, &myCmpr, result, ofiOp);
+    break;
+  default:
+    INTERNAL_ERROR_V("unexpected AMO type %d", (int) ofiType);
+    break;
+  }
+}
+
+
+//
+// Do an AMO with libfabric atomics.
+//
+static
+void ofi_amo(c_nodeid_t node, void* object,
+             const void* opnd, const void* cmpr, void* result,
+             enum fi_op ofiOp, enum fi_datatype ofiType, size_t size) {
+  struct perTxCtxInfo_t* tcip;
+  CHK_TRUE((tcip = getTxCtxInfo()) != NULL);
+
+  nb_handle_t hStack;
+  nb_handle h = allocNbHandle(tcip, &hStack, true /*blocking*/);
+
+  //
+  // The local operands and result have to be in registered memory.
+  //
+  struct amoBuf {
+    chpl_amo_datum_t opnd;
+    chpl_amo_datum_t cmpr;
+    chpl_amo_datum_t result;
+  } bufStack;
+  struct amoBuf* buf = &bufStack;
+
+  void* mrDesc;
+  if (mrGetLocalDesc(&mrDesc, buf, sizeof(*buf)) != 0) {
+    buf = allocBounceBuf(sizeof(*buf));
+    CHK_TRUE(mrGetLocalDesc(&mrDesc, buf, sizeof(*buf)) == 0);
+  }
+
+  if (opnd != NULL) {
+    memcpy(&buf->opnd, opnd, size);
+  }
+  if (cmpr != NULL) {
+    memcpy(&buf->cmpr, cmpr, size);
+  }
+
+  uint64_t mrKey;
+  CHK_TRUE(mrGetRemoteKey(&mrKey, node, object, size) == 0);
+
+  if (ofiOp == FI_CSWAP) {
+    OFI_RIDE_OUT_EAGAIN(tcip,
+                        fi_compare_atomic(tcip->txCtx,
+                                          &buf->opnd, 1, mrDesc,
+                                          &buf->cmpr, mrDesc,
+                                          &buf->result, mrDesc,
+                                          ofi_rxAddrs[node],
+                                          (uint64_t) object, mrKey,
+                                          ofiType, ofiOp, h));
+  } else if (result != NULL) {
+    OFI_RIDE_OUT_EAGAIN(tcip,
+                        fi_fetch_atomic(tcip->txCtx,
+                                        &buf->opnd, 1, mrDesc,
+                                        &buf->result, mrDesc,
+                                        ofi_rxAddrs[node],
+                                        (uint64_t) object, mrKey,
+                                        ofiType, ofiOp, h));
+  } else {
+    OFI_RIDE_OUT_EAGAIN(tcip,
+                        fi_atomic(tcip->txCtx,
+                                  &buf->opnd, 1, mrDesc,
+                                  ofi_rxAddrs[node],
+                                  (uint64_t) object, mrKey,
+                                  ofiType, ofiOp, h));
+  }
+  tcip->numTxsOut++;
+  DBG_PRINTF(DBG_AMO,
+             "tx AMO: op %d, type %d, %d:%p, key 0x%" PRIx64 ", ctx %p",
+             (int) ofiOp, (int) ofiType, (int) node, object, mrKey, h);
+
+  waitForTxCQ(tcip, h);
+  atomic_destroy_bool(&h->complete);
+
+  releaseTxCtxInfo(tcip);
+
+  if (ofiOp == FI_CSWAP) {
+    *(chpl_bool32*) result = (memcmp(&buf->result, &buf->cmpr, size) == 0);
+  } else if (result != NULL) {
+    memcpy(result, &buf->result, size);
+  }
+
+  if (buf != &bufStack) {
+    freeBounceBuf(buf);
+  }
+}
+
+
+//
+// Do an AMO on a remote object with an AM, for data types the provider
+// can't handle.
+//
+static
+void amRequestAMO(c_nodeid_t node, void* object,
+                  const void* opnd, const void* cmpr, void* result,
+                  enum fi_op ofiOp, enum fi_datatype ofiType, size_t size) {
+  //
+  // The target PUTs the result and then the 'done' flag back to us, so
+  // they have to be in registered memory.
+  //
+  struct amoDone {
+    chpl_amo_datum_t result;
+    chpl_bool32 done;
+  } *pAmoDone;
+  pAmoDone = allocBounceBuf(sizeof(*pAmoDone));
+
+  amRequest_t req = { .amo = { .b = { .op = am_opAMO,
+                                      .node = chpl_nodeID, },
+                               .ofiOp = ofiOp,
+                               .ofiType = ofiType,
+                               .size = size,
+                               .obj = object,
+                               .result = ((result == NULL)
+                                          ? NULL
+                                          : &pAmoDone->result),
+                               .pDone = &pAmoDone->done, }, };
+  if (opnd != NULL) {
+    memcpy(&req.amo.opnd, opnd, size);
+  }
+  if (cmpr != NULL) {
+    memcpy(&req.amo.cmpr, cmpr, size);
+  }
+
+  amRequestCommon(node, &req, sizeof(req.amo), &pAmoDone->done);
+
+  if (result != NULL) {
+    memcpy(result, &pAmoDone->result,
+           (ofiOp == FI_CSWAP) ? sizeof(chpl_bool32) : size);
+  }
+
+  freeBounceBuf(pAmoDone);
+}
+
+
+//
+// The AM handler runs this for AMO requests.
+//
+static
+void amHandleAMO(struct amRequest_AMO* amo) {
+  chpl_amo_datum_t result;
+
+  doCpuAMO(amo->obj, &amo->opnd, &amo->cmpr,
+           (amo->result == NULL) ? NULL : &result,
+           amo->ofiOp, amo->ofiType, amo->size);
+
+  if (amo->result != NULL) {
+    (void) ofi_put(&result, amo->b.node, amo->result,
+                   (amo->ofiOp == FI_CSWAP) ? sizeof(chpl_bool32) : amo->size,
+                   true /*blocking*/);
+  }
+
+  amSendDone(amo->b.node, amo->pDone);
+}
+
+
+static
+void doAMO(c_nodeid_t node, void* object,
+           const void* opnd, const void* cmpr, void* result,
+           enum fi_op ofiOp, enum fi_datatype ofiType, size_t size) {
+  if (amoNative[ofiType]) {
+    ofi_amo(node, object, opnd, cmpr, result, ofiOp, ofiType, size);
+  } else if (node == chpl_nodeID) {
+    doCpuAMO(object, opnd, cmpr, result, ofiOp, ofiType, size);
+  } else {
+    amRequestAMO(node, object, opnd, cmpr, result, ofiOp, ofiType, size);
+  }
+}
+
+
+//
+// Buffered AMOs.
+//
+// Non-fetching AMOs on types the provider supports can be buffered.
+// Each thread collects them in the buffer of its tx context, and they
+// are all initiated together when the buffer fills or somebody calls
+// chpl_comm_atomic_buff_flush().  A buffer is protected by its lock,
+// because flushes can come from any thread.
+//
+#define AMO_BUFF_MAX 64
+
+struct amoBuffEntry {
+  c_nodeid_t node;
+  void* object;
+  enum fi_op ofiOp;
+  enum fi_datatype ofiType;
+  size_t size;
+  chpl_amo_datum_t opnd;
+};
+
+
+static inline
+void lockAmoBuff(struct perTxCtxInfo_t* tcip) {
+  while (atomic_exchange_bool(&tcip->amoBuffLock, true)) {
+    chpl_task_yield();
+  }
+}
+
+
+static inline
+void unlockAmoBuff(struct perTxCtxInfo_t* tcip) {
+  atomic_store_bool(&tcip->amoBuffLock, false);
+}
+
+
+//
+// Initiate the AMOs in one tx context's buffer on another (or the same)
+// tx context, and wait for them all to complete.  The caller must hold
+// the lock for the buffer.
+//
+static
+void amoBuffFlush(struct perTxCtxInfo_t* tcipBuff,
+                  struct perTxCtxInfo_t* tcip) {
+  const int n = tcipBuff->amoBuffLen;
+
+  if (n == 0) {
+    return;
+  }
+
+  void* mrDesc;
+  CHK_TRUE(mrGetLocalDesc(&mrDesc, tcipBuff->amoBuff,
+                          n * sizeof(tcipBuff->amoBuff[0])) == 0);
+
+  nb_handle_t hs[AMO_BUFF_MAX];
+  for (int i = 0; i < n; i++) {
+    struct amoBuffEntry* e = &tcipBuff->amoBuff[i];
+    nb_handle h = allocNbHandle(tcip, &hs[i], true /*blocking*/);
+
+    uint64_t mrKey;
+    CHK_TRUE(mrGetRemoteKey(&mrKey, e->node, e->object, e->size) == 0);
+
+    OFI_RIDE_OUT_EAGAIN(tcip,
+                        fi_atomic(tcip->txCtx,
+                                  &e->opnd, 1, mrDesc,
+                                  ofi_rxAddrs[e->node],
+                                  (uint64_t) e->object, mrKey,
+                                  e->ofiType, e->ofiOp, h));
+    tcip->numTxsOut++;
+  }
+
+  DBG_PRINTF(DBG_AMO, "tx %d buffered AMOs from ptiTab[%td]",
+             n, tcipBuff - ptiTab);
+
+  for (int i = 0; i < n; i++) {
+    waitForTxCQ(tcip, &hs[i]);
+    atomic_destroy_bool(&hs[i].complete);
+  }
+
+  tcipBuff->amoBuffLen = 0;
+}
+
+
+static
+void doAMOBuff(c_nodeid_t node, void* object, const void* opnd,
+               enum fi_op ofiOp, enum fi_datatype ofiType, size_t size) {
+  if (!amoNative[ofiType]) {
+    doAMO(node, object, opnd, NULL, NULL, ofiOp, ofiType, size);
+    return;
+  }
+
+  struct perTxCtxInfo_t* tcip;
+  CHK_TRUE((tcip = getTxCtxInfo()) != NULL);
+
+  lockAmoBuff(tcip);
+
+  if (tcip->amoBuff == NULL) {
+    CHPL_CALLOC(tcip->amoBuff, AMO_BUFF_MAX);
+  }
+
+  struct amoBuffEntry* e = &tcip->amoBuff[tcip->amoBuffLen++];
+  e->node = node;
+  e->object = object;
+  e->ofiOp = ofiOp;
+  e->ofiType = ofiType;
+  e->size = size;
+  memcpy(&e->opnd, opnd, size);
+
+  if (tcip->amoBuffLen == AMO_BUFF_MAX) {
+    amoBuffFlush(tcip, tcip);
+  }
+
+  unlockAmoBuff(tcip);
+
+  releaseTxCtxInfo(tcip);
+}
+
+
+void chpl_comm_atomic_buff_flush(void) {
+  if (chpl_numNodes <= 1) {
+    return;
+  }
+
+  struct perTxCtxInfo_t* tcip;
+  CHK_TRUE((tcip = getTxCtxInfo()) != NULL);
+
+  //
+  // Unused entries and those of the AM handlers that haven't run any
+  // "fast" executeOn bodies doing buffered AMOs have empty buffers.
+  //
+  for (int i = 0; i < ptiTabLen; i++) {
+    struct perTxCtxInfo_t* tcipBuff = &ptiTab[i];
+    if (tcipBuff->amoBuffLen > 0) {
+      lockAmoBuff(tcipBuff);
+      amoBuffFlush(tcipBuff, tcip);
+      unlockAmoBuff(tcipBuff);
+    }
+  }
+
+  releaseTxCtxInfo(tcip);
+}
+
+
 ////////////////////////////////////////
 //
 // Interface: utility
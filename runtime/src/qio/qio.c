@@ -1433,6 +1433,105 @@ qioerr qio_file_length(qio_file_t* f, int64_t *len_out)
   return err;
 }
 
+qioerr qio_file_map_region(qio_file_t* f, int64_t offset, int64_t len,
+                           qio_bool copy_on_write,
+                           void** base_out, int64_t* base_len_out,
+                           void** data_out)
+{
+  int64_t pagesize = sys_page_size();
+  int64_t file_len = 0;
+  int64_t map_start;
+  int64_t map_len;
+  int prot;
+  int flags;
+  void* base = NULL;
+  qioerr err;
+
+  *base_out = NULL;
+  *base_len_out = 0;
+  *data_out = NULL;
+
+  if( offset < 0 || len <= 0 ) {
+    QIO_RETURN_CONSTANT_ERROR(EINVAL, "invalid file region");
+  }
+
+  // Only a file descriptor can be mapped; memory files and plugin
+  // file systems have to be read through a channel.
+  if( f->fd == -1 ) {
+    QIO_RETURN_CONSTANT_ERROR(ENOSYS, "file cannot be mapped");
+  }
+
+  err = qio_file_length(f, &file_len);
+  if( err ) return err;
+
+  // Touching a mapped page past the end of the file raises SIGBUS.
+  if( offset + len > file_len ) {
+    QIO_RETURN_CONSTANT_ERROR(EEOF, "file region extends past end of file");
+  }
+
+  // mmap needs a page-aligned file offset, so map from the start of
+  // the page containing offset.
+  map_start = (offset / pagesize) * pagesize;
+  map_len = offset + len - map_start;
+
+  if( copy_on_write ) {
+    prot = PROT_READ | PROT_WRITE;
+    flags = MAP_PRIVATE;
+  } else {
+    prot = PROT_READ;
+    flags = MAP_SHARED;
+  }
+
+  err = qio_int_to_err(sys_mmap(NULL, map_len, prot, flags, f->fd, map_start, &base));
+  if( err ) return err;
+
+  *base_out = base;
+  *base_len_out = map_len;
+  *data_out = (unsigned char*) base + (offset - map_start);
+
+  return 0;
+}
+
+qioerr qio_file_pwrite_direct(qio_file_t* f, const void* ptr, int64_t len, int64_t offset)
+{
+  const unsigned char* cur = (const unsigned char*) ptr;
+  ssize_t nwritten = 0;
+  struct iovec iov;
+  qioerr err = 0;
+
+  if( offset < 0 || len < 0 ) {
+    QIO_RETURN_CONSTANT_ERROR(EINVAL, "invalid file region");
+  }
+
+  STARTING_SLOW_SYSCALL;
+
+  // pwritev can write less than asked for (on Linux it never writes more
+  // than about 2GB at once), so keep going until it's all out.
+  while( len > 0 && ! err ) {
+    iov.iov_base = (void*) cur;
+    iov.iov_len = len;
+    nwritten = 0;
+
+    if( f->fd != -1 ) {
+      err = qio_int_to_err(sys_pwritev(f->fd, &iov, 1, offset, &nwritten));
+    } else if( f->fsfns && f->fsfns->pwritev ) {
+      err = f->fsfns->pwritev(f->file_info, &iov, 1, offset, &nwritten, f->fs_info);
+    } else {
+      QIO_GET_CONSTANT_ERROR(err, ENOSYS, "missing pwritev");
+    }
+
+    if( ! err && nwritten == 0 ) err = QIO_ESHORT;
+
+    cur += nwritten;
+    len -= nwritten;
+    offset += nwritten;
+  }
+
+  DONE_SLOW_SYSCALL;
+
+  return err;
+}
+
 /* CHANNELS ----------------------------- */
 static
 qioerr _qio_channel_init(qio_channel_t* ch, qio_chtype_t type)
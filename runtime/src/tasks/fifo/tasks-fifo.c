@@ -22,12 +22,14 @@
 //
 
 #include "chplrt.h"
+#include "chpl-env-gen.h"
 #include "chpl_rt_utils_static.h"
 #include "chplcgfns.h"
 #include "chpl-comm.h"
 #include "chplexit.h"
 #include "chpl-locale-model.h"
 #include "chpl-mem.h"
+#include "chpl-sync-word.h"
 #include "chpl-tasks.h"
 #include "chpl-tasks-callbacks-internal.h"
 #include "chpl-topo.h"
@@ -43,6 +45,11 @@
 #include <sys/mman.h>
 #include <unistd.h>
 #include <math.h>
+#include <limits.h>
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
 
 
 //
@@ -60,6 +67,7 @@ typedef struct task_pool_struct {
   task_pool_p      list_prev;
   task_pool_p      next;         // double-link pointers for pool
   task_pool_p      prev;
+  chpl_bool        cacheable;    // can be reused via the descriptor cache
 
   chpl_task_prvDataImpl_t chpl_data;
 
@@ -104,6 +112,22 @@ static int                 idle_thread_cnt;    // number of threads looking
 static uint64_t            progress_cnt;       // number of unblock operations,
                                                //   as a proxy for progress
 
+//
+// Task descriptor cache.  Allocating and freeing a descriptor for each
+// task is a large part of what a small task costs, so descriptors with
+// room for up to TASK_DESC_CACHE_PAYLOAD bytes of task arguments are
+// put on a free list when their tasks finish, and reused from there.
+// The list is protected by threading_lock, which is already held where
+// descriptors are created and taken anyway after a task finishes, so it
+// is shared rather than per-thread: in a coforall the descriptors are
+// created by one thread but released by all the others.
+//
+#define TASK_DESC_CACHE_PAYLOAD 256
+#define TASK_DESC_CACHE_MAX     1024
+
+static task_pool_p         free_ptask_head;    // head of descriptor cache
+static int                 free_ptask_cnt;     // number of cached descriptors
+
 static chpl_thread_mutex_t block_report_lock;   // critical section lock
 static lockReport_t* lockReportHead = NULL;
 static lockReport_t* lockReportTail = NULL;
@@ -137,6 +161,8 @@ static void                    check_for_deadlock(void);
 static void                    thread_begin(void*);
 static void                    thread_end(void);
 static void                    maybe_add_thread(void);
+static task_pool_p             alloc_ptask(size_t, int, int32_t);
+static void                    release_ptask(task_pool_p);
 static task_pool_p             add_to_task_pool(chpl_fn_int_t, chpl_fn_p,
                                                 chpl_task_bundle_t*, size_t,
                                                 chpl_bool, task_pool_p*,
@@ -302,6 +328,100 @@ void chpl_sync_destroyAux(chpl_sync_aux_t *s) {
   chpl_thread_mutexDestroy(&s->lock);
 }
 
+
+// Compact sync words (see chpl-sync-word.h)
+
+//
+// Each task has a thread to itself, so a waiter that is oversubscribing
+// the hardware can sleep on the word with a futex.  That needs the word
+// to be a plain 32-bit memory location, which it isn't with locks-based
+// atomics, and there we yield instead.
+//
+#if defined(__linux__) && !defined(CHPL_ATOMICS_LOCKS)
+#define SYNC_WORD_USE_FUTEX 1
+#endif
+
+static chpl_bool sync_word_ready(chpl_sync_word_t* w, uint_least32_t want) {
+  uint_least32_t s = atomic_load_uint_least32_t(&w->state);
+
+  return (s & CHPL_SYNC_WORD_LOCKED) == 0
+         && (want == CHPL_SYNC_WORD_WANT_ANY
+             || (s & CHPL_SYNC_WORD_FULL) == want);
+}
+
+static void sync_word_suspend(chpl_sync_word_t* w, uint_least32_t want,
+                              chpl_bool suspend_using_futex) {
+#ifdef SYNC_WORD_USE_FUTEX
+  if (suspend_using_futex) {
+    uint_least32_t s = atomic_load_uint_least32_t(&w->state);
+
+    if (sync_word_ready(w, want))
+      return;
+
+    // Tell whoever releases the word to wake us, then sleep unless the
+    // word has changed in the meantime.
+    if ((s & CHPL_SYNC_WORD_WAITERS) == 0) {
+      if (!atomic_compare_exchange_strong_uint_least32_t(
+             &w->state, s, s | CHPL_SYNC_WORD_WAITERS))
+        return;
+      s |= CHPL_SYNC_WORD_WAITERS;
+    }
+
+    (void) syscall(SYS_futex, (uint32_t*) &w->state, FUTEX_WAIT_PRIVATE,
+                   (uint32_t) s, NULL, NULL, 0);
+    return;
+  }
+#endif
+
+  chpl_thread_yield();
+}
+
+void chpl_sync_word_wait(chpl_sync_word_t* w, uint_least32_t want,
+                         int32_t lineno, int32_t filename) {
+  chpl_bool suspend_using_futex;
+
+  // As in sync_wait_and_lock(), only sleep if we're oversubscribing
+  // the hardware, and otherwise spin-wait.
+  suspend_using_futex = (chpl_thread_getNumThreads() >=
+                         chpl_topo_getNumCPUsLogical(true));
+
+  while (!chpl_sync_word_tryLock(w, want)) {
+    if (set_block_loc(lineno, filename)) {
+      // all other tasks appear to be blocked
+      struct timeval deadline, now;
+
+      gettimeofday(&deadline, NULL);
+      deadline.tv_sec += 1;
+      do {
+        chpl_thread_yield();
+        if (!sync_word_ready(w, want))
+          gettimeofday(&now, NULL);
+      } while (!sync_word_ready(w, want)
+               && (now.tv_sec < deadline.tv_sec
+                   || (now.tv_sec == deadline.tv_sec
+                       && now.tv_usec < deadline.tv_usec)));
+      if (!sync_word_ready(w, want))
+        check_for_deadlock();
+    }
+    else {
+      do {
+        sync_word_suspend(w, want, suspend_using_futex);
+      } while (!sync_word_ready(w, want));
+    }
+    unset_block_loc();
+  }
+
+  if (blockreport)
+    progress_cnt++;
+}
+
+void chpl_sync_word_wake(chpl_sync_word_t* w) {
+#ifdef SYNC_WORD_USE_FUTEX
+  (void) syscall(SYS_futex, (uint32_t*) &w->state, FUTEX_WAKE_PRIVATE,
+                 INT_MAX, NULL, NULL, 0);
+#endif
+}
+
 static void setup_main_thread_private_data(void)
 {
   thread_private_data_t* tp;
@@ -338,6 +458,8 @@ void chpl_task_init(void) {
   idle_thread_cnt = 0;
   extra_task_cnt = 0;
   task_pool_head = task_pool_tail = NULL;
+  free_ptask_head = NULL;
+  free_ptask_cnt = 0;
 
   chpl_thread_init(thread_begin, thread_end);
 
@@ -371,6 +493,13 @@ void chpl_task_exit(void) {
     return;
 
   chpl_thread_exit();
+
+  while (free_ptask_head != NULL) {
+    task_pool_p ptask = free_ptask_head;
+    free_ptask_head = ptask->next;
+    chpl_mem_free(ptask, 0, 0);
+  }
+  free_ptask_cnt = 0;
 }
 
 
@@ -624,6 +753,7 @@ void chpl_task_executeTasksInList(void** p_task_list_void) {
   task_pool_p* p_task_list_head = (task_pool_p*) p_task_list_void;
   task_pool_p curr_ptask;
   task_pool_p child_ptask;
+  task_pool_p done_ptask = NULL;
 
   // Note: this function needs to tolerate an empty task
   // list. That will happen for coforalls inside a serial block, say.
@@ -636,6 +766,12 @@ void chpl_task_executeTasksInList(void** p_task_list_void) {
     // begin critical section
     chpl_thread_mutexLock(&threading_lock);
 
+    // release the previous child's descriptor while we hold the lock
+    if (done_ptask != NULL) {
+      release_ptask(done_ptask);
+      done_ptask = NULL;
+    }
+
     if ((child_ptask = *p_task_list_head) != NULL) {
       task_to_run_fun = child_ptask->bundle.requested_fn;
       dequeue_task(child_ptask);
@@ -699,8 +835,13 @@ void chpl_task_executeTasksInList(void** p_task_list_void) {
     chpl_thread_mutexUnlock(&extra_task_lock);
 
     set_current_ptask(curr_ptask);
-    chpl_mem_free(child_ptask, 0, 0);
+    done_ptask = child_ptask;
+  }
 
+  if (done_ptask != NULL) {
+    chpl_thread_mutexLock(&threading_lock);
+    release_ptask(done_ptask);
+    chpl_thread_mutexUnlock(&threading_lock);
   }
 }
 
@@ -1231,11 +1372,12 @@ thread_begin(void* ptask_void) {
     }
 
     tp->ptask = NULL;
-    chpl_mem_free(ptask, 0, 0);
 
     // begin critical section
     chpl_thread_mutexLock(&threading_lock);
 
+    release_ptask(ptask);
+
     //
     // finished task; increment idle count
     //
@@ -1297,6 +1439,52 @@ static void maybe_add_thread(void) {
 }
 
 
+// get a task descriptor with room for the given argument payload,
+// from the descriptor cache if the payload is small enough
+// assumes threading_lock has already been acquired!
+static inline
+task_pool_p alloc_ptask(size_t payload_size, int lineno, int32_t filename) {
+  task_pool_p ptask;
+
+  if (payload_size > TASK_DESC_CACHE_PAYLOAD) {
+    ptask = (task_pool_p) chpl_mem_alloc(sizeof(task_pool_t) + payload_size,
+                                         CHPL_RT_MD_TASK_ARG_AND_POOL_DESC,
+                                         lineno, filename);
+    ptask->cacheable = false;
+    return ptask;
+  }
+
+  if ((ptask = free_ptask_head) != NULL) {
+    free_ptask_head = ptask->next;
+    free_ptask_cnt--;
+  }
+  else {
+    ptask = (task_pool_p) chpl_mem_alloc(sizeof(task_pool_t)
+                                         + TASK_DESC_CACHE_PAYLOAD,
+                                         CHPL_RT_MD_TASK_ARG_AND_POOL_DESC,
+                                         lineno, filename);
+    ptask->cacheable = true;
+  }
+
+  return ptask;
+}
+
+
+// return a finished task's descriptor to the cache, or free it
+// assumes threading_lock has already been acquired!
+static inline
+void release_ptask(task_pool_p ptask) {
+  if (ptask->cacheable && free_ptask_cnt < TASK_DESC_CACHE_MAX) {
+    ptask->next = free_ptask_head;
+    free_ptask_head = ptask;
+    free_ptask_cnt++;
+  }
+  else {
+    chpl_mem_free(ptask, 0, 0);
+  }
+}
+
+
 // create a task from the given function pointer and arguments
 // and append it to the end of the task pool
 // assumes threading_lock has already been acquired!
@@ -1318,9 +1506,7 @@ task_pool_p add_to_task_pool(chpl_fn_int_t fid, chpl_fn_p fp,
   assert(a_size >= sizeof(chpl_task_bundle_t));
 
   payload_size = a_size - sizeof(chpl_task_bundle_t);
-  ptask = (task_pool_p) chpl_mem_alloc(sizeof(task_pool_t) + payload_size,
-                                       CHPL_RT_MD_TASK_ARG_AND_POOL_DESC,
-                                       lineno, filename);
+  ptask = alloc_ptask(payload_size, lineno, filename);
 
   memcpy(&ptask->bundle, a, a_size);
 
@@ -0,0 +1,4 @@
+// The precomp script compiles this program once into an empty
+// --c-cache-dir under a different executable name.  Compiling it again
+// should reuse the cached object.
+writeln("hello from the object cache");
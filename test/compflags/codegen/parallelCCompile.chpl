@@ -0,0 +1,45 @@
+// Exercise the code that --parallel-c-compile treats specially: small
+// functions defined in the header, functions called through a virtual
+// method table or as first-class functions, and task functions.
+
+class Shape {
+  proc area(): real { return 0.0; }
+}
+
+class Square: Shape {
+  var side: real;
+  override proc area(): real { return side * side; }
+}
+
+class Circle: Shape {
+  var r: real;
+  override proc area(): real { return 3.0 * r * r; }
+}
+
+proc twice(x: int) { return 2 * x; }
+
+proc applyTo(f, x: int) { return f(x); }
+
+proc sumTo(n: int) {
+  var total = 0;
+  for i in 1..n do
+    total += twice(i);
+  return total;
+}
+
+var square = new owned Square(2.0);
+var circle = new owned Circle(1.0);
+var shapes = [square.borrow(): Shape, circle.borrow(): Shape];
+
+for s in shapes do
+  writeln(s.area());
+
+writeln(sumTo(10));
+writeln(applyTo(twice, 21));
+
+var done: sync bool;
+begin {
+  writeln(shapes[1].area() + shapes[2].area());
+  done = true;
+}
+done;
@@ -0,0 +1,24 @@
+//
+// Standard module functions that are only reached through a 'use' rename,
+// a forwarding rename or a method name in a string must survive
+// --prune-standard-functions.
+//
+use List only list;
+use Path only basename as base;
+use Reflection;
+
+record R {
+  var l: list(int);
+
+  forwarding l only append as add;
+}
+
+var r: R;
+
+r.add(1);
+r.add(2);
+
+writeln(r.l);
+writeln(base("/a/b/c.chpl"));
+writeln(canResolveMethod(r.l, "shrink"));
+writeln(canResolveMethod(r.l, "concat", r.l));
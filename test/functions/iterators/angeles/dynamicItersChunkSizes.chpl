@@ -0,0 +1,39 @@
+// Measures the cost of handing out chunks in the DynamicIters iterators.
+// Each iteration does very little work, so the times are dominated by how
+// fast the tasks can claim chunks. The dynamic iterator is run with a range
+// of chunk sizes; guided and adaptive choose their own chunk sizes.
+
+use DynamicIters;
+use Time;
+
+config const nTasks:int=4;
+config const n:int=100000;
+config const quiet:bool=true;
+
+const chunkSizes=[1, 4, 16, 64, 256];
+
+var A:[0..#n] int;
+
+for chunkSize in chunkSizes do
+  run("dynamic chunkSize=" + chunkSize:string, chunkSize);
+run("guided");
+run("adaptive");
+
+proc run(name:string, chunkSize:int=1) {
+  var t:Timer;
+  A=0;
+
+  t.start();
+  if name.startsWith("dynamic") then
+    forall i in dynamic(0..#n, chunkSize, nTasks) do A[i]+=1;
+  else if name == "guided" then
+    forall i in guided(0..#n, nTasks) do A[i]+=1;
+  else
+    forall i in adaptive(0..#n, nTasks) do A[i]+=1;
+  t.stop();
+
+  const correct=&& reduce (A == 1);
+  writeln(name, ": ", if correct then "Correct" else "Incorrect");
+  if !quiet then
+    writeln("Time ", name, " ", t.elapsed(TimeUnits.milliseconds));
+}
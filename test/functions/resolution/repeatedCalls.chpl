@@ -0,0 +1,63 @@
+// Calls that match the same candidates must be resolved the same way each
+// time, and differently when the actuals' types, param values or the scope
+// of the call differ.
+
+proc f(x: int(8))  { writeln("f(int(8))");  }
+proc f(x: int)     { writeln("f(int)");     }
+proc f(x: real)    { writeln("f(real)");    }
+
+record R { var x: int; }
+class C { }
+class D: C { }
+
+proc f(x: R)                 { writeln("f(R)"); }
+proc f(x: unmanaged C)       { writeln("f(C)"); }
+
+proc g(x: int, y: int)  { writeln("g(int, int)");  }
+proc g(x: int, y: real) { writeln("g(int, real)"); }
+
+var a: [1..3] int;
+
+proc accessor(i: int) ref   { writeln("ref");   return a[i]; }
+proc accessor(i: int)       { writeln("value"); return a[i]; }
+
+var i = 1;
+param small: int(8) = 1;
+
+f(1);
+f(1);
+f(1000);
+f(1000);
+f(i);
+f(i);
+f(small);
+f(small);
+f(1.0);
+
+var r: R;
+var d = new unmanaged D();
+
+f(r);
+f(r);
+f(d);
+f(d);
+delete d;
+
+g(1, 2);
+g(1, 2.0);
+g(y=2, x=1);
+g(y=2.0, x=1);
+
+accessor(1) = 5;
+writeln(accessor(1));
+accessor(2) = 6;
+writeln(accessor(2));
+
+{
+  proc f(x: int) { writeln("inner f(int)"); }
+
+  f(i);
+  f(i);
+}
+
+f(i);
@@ -0,0 +1,87 @@
+use IO;
+
+config const n = 1000;
+config const filename = "maparray.bin";
+
+var A: [1..n] int;
+for i in 1..n do A[i] = i * i;
+
+var B: [0..3, 0..4] real;
+for (i, j) in B.domain do B[i, j] = i + j / 10.0;
+
+{
+  var f = open(filename, iomode.cwr);
+  f.writeArray(A);
+  f.writeArray(B, offset=n * 8);
+  f.close();
+}
+
+var f = open(filename, iomode.r);
+writeln(f.length() == n * 8 + B.size * 8);
+
+// Read-only mappings of both arrays.
+{
+  var MA = f.mapArray(int, {1..n});
+  writeln(MA.domain, " ", && reduce (MA == A));
+
+  var MB = f.mapArray(real, {0..3, 0..4}, offset=n * 8);
+  writeln(MB);
+}
+
+// An element offset into the file that isn't page-aligned.
+{
+  var M = f.mapArray(int, {0..9}, offset=500 * 8);
+  writeln(M);
+}
+
+// Copy-on-write changes stay private to the array.
+{
+  var M = f.mapArray(int, {1..n}, copyOnWrite=true);
+  M[1] = -1;
+  forall i in 2..n do M[i] += 1;
+  writeln(M[1], " ", M[2], " ", M[n]);
+
+  var M2 = f.mapArray(int, {1..n});
+  writeln(M2[1], " ", M2[2], " ", M2[n]);
+}
+
+// Resizing the domain moves the elements into ordinary memory.
+{
+  var D = {1..4};
+  var M = f.mapArray(int, D, copyOnWrite=true);
+  D = {1..6};
+  M[5] = 55;
+  writeln(M);
+}
+
+// A read-only array shares the file's pages, so it sees later writes.
+{
+  var M = f.mapArray(int, {1..4});
+  var g = open(filename, iomode.rw);
+  var C: [1..2] int = [-2, -3];
+  g.writeArray(C, offset=8);
+  g.close();
+  writeln(M);
+  g = open(filename, iomode.rw);
+  C = A[2..3];
+  g.writeArray(C, offset=8);
+  g.close();
+}
+
+// An empty domain maps nothing.
+{
+  var M = f.mapArray(int, {1..0});
+  writeln(M.size);
+}
+
+// The region must lie within the file.
+try {
+  var M = f.mapArray(int, {1..n}, offset=200 * 8);
+  writeln(M[1]);
+} catch e: SystemError {
+  writeln("error: ", e.err == EEOF);
+} catch {
+  writeln("unexpected error");
+}
+
+f.close();
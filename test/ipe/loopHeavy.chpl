@@ -0,0 +1,95 @@
+var calls : int = 0;
+
+proc SumTo(n : int) : int
+{
+  var i   : int = 0;
+  var sum : int = 0;
+
+  while (i < n)
+  {
+    i     = i + 1;
+    sum   = sum + i;
+  }
+
+  calls = calls + 1;
+
+  return sum;
+}
+
+proc Collatz(start : int) : int
+{
+  var n     : int = start;
+  var steps : int = 0;
+
+  while (n != 1)
+  {
+    if (n - n / 2 * 2 == 0) then
+      n = n / 2;
+    else
+      n = 3 * n + 1;
+
+    steps = steps + 1;
+  }
+
+  return steps;
+}
+
+proc Fib(n : int) : int
+{
+  var retval : int = n;
+
+  if (n > 1) then
+    retval = Fib(n - 1) + Fib(n - 2);
+
+  return retval;
+}
+
+proc Harmonic(n : int) : real
+{
+  var i   : int  = 1;
+  var sum : real = 0.0;
+  var x   : real = 1.0;
+
+  while (i <= n)
+  {
+    sum = sum + 1.0 / x;
+    x   = x + 1.0;
+    i   = i + 1;
+  }
+
+  return sum;
+}
+
+proc IsBig(x : real) : bool
+{
+  return x >= 10.0;
+}
+
+writeln(c'SumTo(100)      = ', SumTo(100));
+writeln(c'Collatz(27)     = ', Collatz(27));
+writeln(c'Fib(20)         = ', Fib(20));
+writeln(c'Harmonic(100)   = ', Harmonic(100));
+writeln(c'IsBig(Harmonic) = ', IsBig(Harmonic(100)));
+writeln(c'abs(-7)         = ', abs(-7));
+
+var i     : int  = 0;
+var total : int  = 0;
+var maxC  : int  = 0;
+var neg   : real = 0.0;
+
+while (i < 30)
+{
+  i     = i + 1;
+  total = total + SumTo(i);
+
+  if (Collatz(i) > maxC) then
+    maxC = Collatz(i);
+
+  neg   = neg - 0.5;
+}
+
+writeln(c'total           = ', total);
+writeln(c'maxC            = ', maxC);
+writeln(c'neg             = ', -neg);
+writeln(c'calls           = ', calls);
+quit();
@@ -17,11 +17,15 @@ use DistributedIters;
 
   - ``guided``
     The distributed guided load-balancing iterator.
+
+  - ``workStealing``
+    The distributed work-stealing load-balancing iterator.
 */
 enum iterator
 {
   dynamic,
-  guided
+  guided,
+  workStealing
 };
 
 /*
@@ -95,6 +99,8 @@ proc testIteratorSerial(c)
                              do array[i] = (array[i] + 1);
     when iterator.guided do for i in distributedGuided(c)
                             do array[i] = (array[i] + 1);
+    when iterator.workStealing do for i in distributedWorkStealing(c)
+                                  do array[i] = (array[i] + 1);
   }
   checkCorrectness(array, c);
 }
@@ -123,6 +129,14 @@ proc testIteratorZippered(array,
                           base # target.size)
       do array[i,j] = (array[i,j] + 1);
     }
+    when iterator.workStealing
+    {
+      forall (i,j) in zip(distributedWorkStealing(target,
+                                                  coordinated=coordinated,
+                                                  workerLocales=workerLocales),
+                          base # target.size)
+      do array[i,j] = (array[i,j] + 1);
+    }
   }
   checkCorrectnessZippered(array, target, base);
 }
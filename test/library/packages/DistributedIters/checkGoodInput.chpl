@@ -18,11 +18,15 @@ var A:[rng] int=0;
 
   - ``guided``
     The distributed guided load-balancing iterator.
+
+  - ``workStealing``
+    The distributed work-stealing load-balancing iterator.
 */
 enum iterator
 {
   dynamic,
-  guided
+  guided,
+  workStealing
 };
 
 /*
@@ -136,6 +140,48 @@ select mode
     for i in distributedGuided(testBlockDistributedDomain)
     do A[i] = A[i]+1;
   }
+  when iterator.workStealing
+  {
+    writeln("Checking a range...");
+    for i in distributedWorkStealing(testRange)
+    do A[i] = A[i]+1;
+
+    writeln("Checking a strided range...");
+    for i in distributedWorkStealing(testStridedRange)
+    do A[i] = A[i]+1;
+
+    writeln("Checking a counted range...");
+    for i in distributedWorkStealing(testCountedRange)
+    do A[i] = A[i]+1;
+
+    writeln("Checking a strided counted range...");
+    for i in distributedWorkStealing(testStridedCountedRange)
+    do A[i] = A[i]+1;
+
+    writeln("Checking an aligned range...");
+    for i in distributedWorkStealing(testAlignedRange)
+    do A[i] = A[i]+1;
+
+    writeln("Checking an empty domain...");
+    for i in distributedWorkStealing(testEmptyDomain)
+    do A[i] = A[i]+1;
+
+    writeln("Checking a domain literal...");
+    for i in distributedWorkStealing(testDomainLiteral)
+    do A[i] = A[i]+1;
+
+    writeln("Checking an associative domain...");
+    for i in distributedWorkStealing(testAssociativeDomain)
+    do A[i] = A[i]+1;
+
+    writeln("Checking a sparse domain...");
+    for i in distributedWorkStealing(testSparseDomain)
+    do A[i] = A[i]+1;
+
+    writeln("Checking a block-distributed domain...");
+    for i in distributedWorkStealing(testBlockDistributedDomain)
+    do A[i] = A[i]+1;
+  }
 }
 
 // EOF
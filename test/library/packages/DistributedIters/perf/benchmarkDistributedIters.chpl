@@ -31,12 +31,16 @@ config const debug:bool = false;
 
   - ``guided``
     The distributed guided load-balancing iterator.
+
+  - ``workStealing``
+    The distributed work-stealing load-balancing iterator.
 */
 enum iterator
 {
   default,
   dynamic,
-  guided
+  guided,
+  workStealing
 };
 
 /*
@@ -97,7 +101,8 @@ config const test:testCase = testCase.uniform;
 config const coordinated:bool = false;
 
 /*
-  Dynamic-iterator--specific options.
+  Dynamic-iterator--specific options (``chunkSize`` also applies to the
+  work-stealing iterator).
 */
 config const localeChunkSize:int = 0;
 config const chunkSize:int = 1;
@@ -122,6 +127,7 @@ select mode
   when iterator.default do timeResult = testControlWorkload();
   when iterator.dynamic do timeResult = testDynamicWorkload();
   when iterator.guided do timeResult = testGuidedWorkload();
+  when iterator.workStealing do timeResult = testWorkStealingWorkload();
 }
 
 if timing
@@ -207,6 +213,40 @@ private proc testGuidedWorkload()
   return timerElapsed;
 }
 
+pragma "no doc"
+private proc testWorkStealingWorkload()
+{
+  var timer:Timer;
+
+  const replicatedDomain:domain(1) dmapped Replicated() = controlDomain;
+  var array:[controlDomain]real;
+  var replicatedArray:[replicatedDomain]real;
+
+  fillArray(array);
+
+  // Ensure all locales have the same array.
+  coforall L in Locales
+  do on L
+  do for i in controlDomain
+  do replicatedArray[i] = array[i];
+
+  timer.start();
+  forall i in distributedWorkStealing(controlRange,
+                                      chunkSize=chunkSize,
+                                      coordinated=coordinated)
+  {
+    const k:real = (array[i] * n):int;
+
+    // Simulate work.
+    isPerfect(k:int);
+  }
+  timer.stop();
+
+  const timerElapsed:real = timer.elapsed();
+  timer.clear();
+  return timerElapsed;
+}
+
 pragma "no doc"
 private proc testControlWorkload():real
 {
@@ -0,0 +1,8 @@
+use SIMD;
+
+var A: [1..10] real;
+var v: vec(real, 4);
+v.load(A, 5);
+writeln(v);
+v.load(A, 8);
+writeln(v);
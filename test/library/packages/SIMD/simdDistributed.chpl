@@ -0,0 +1,20 @@
+use SIMD, BlockDist;
+
+// Loads and stores on a distributed array may cross the blocks of
+// different locales.
+config const n = 16;
+
+const D = {1..n} dmapped Block({1..n});
+var A: [D] int(32);
+for i in D do A[i] = i: int(32);
+
+var sum: vec(int(32), 4);
+for i in 1..n by 4 {
+  var v: vec(int(32), 4);
+  v.load(A, i);
+  sum += v;
+  v *= 2: int(32);
+  v.store(A, i);
+}
+writeln(sum);
+writeln(A);
@@ -0,0 +1,56 @@
+use SIMD;
+
+// construction and arithmetic
+var a = new vec(real, 4, (1.0, 2.0, 3.0, 4.0));
+var b = new vec(real, 4, 10.0);
+var z: vec(real, 4);
+writeln(z);
+writeln(a + b);
+writeln(b - a);
+writeln(a * 2.0);
+writeln(b / a);
+writeln(-a);
+
+// masks
+const m = a < new vec(real, 4, 2.5);
+writeln(m, " ", any(m), " ", all(m));
+writeln(blend(m, a, b));
+writeln(blend(~m, a, b));
+
+// reductions
+writeln(reduceAdd(a), " ", reduceMul(a), " ", reduceMin(a), " ", reduceMax(a));
+
+// lanes
+var c = a;
+c.set(0, 42.0);
+writeln(c[0], " ", a[0]);
+
+// loads, stores, gathers and scatters
+var A: [0..#10] real = [i in 0..#10] i:real;
+var d: vec(real, 4);
+d.load(A, 3);
+writeln(d);
+d *= 2.0;
+d.store(A, 6);
+writeln(A);
+
+var idx = new vec(int, 4, (9, 0, 5, 1));
+var g: vec(real, 4);
+g.gather(A, idx);
+writeln(g);
+g.scatter(A, new vec(int, 4, (0, 1, 2, 3)));
+writeln(A);
+
+// loads along the last dimension of a 2D array
+var M: [1..2, 1..8] int(32);
+for (i, j) in M.domain do M[i, j] = (i * 10 + j): int(32);
+var r: vec(int(32), 8);
+r.load(M, (2, 1));
+writeln(r);
+writeln(r & new vec(int(32), 8, 1: int(32)));
+
+// other widths and element types
+var f = new vec(real(32), 16, 0.5: real(32));
+writeln(reduceAdd(f));
+var h = new vec(int, 8, (1, 2, 3, 4, 5, 6, 7, 8));
+writeln(reduceMax(h), " ", any(h == new vec(int, 8, 9)));
@@ -0,0 +1,24 @@
+use SIMD;
+
+// Loads and stores through views must follow the view's indices, not the
+// memory layout of the array they view.
+var M: [1..4, 1..4] real;
+for (i, j) in M.domain do M[i, j] = i * 10 + j;
+
+var v: vec(real, 4);
+
+// rank change: column 3 is strided in memory
+v.load(M[.., 3], 1);
+writeln(v);
+v.store(M[2, ..], 1);
+writeln(M);
+
+// slice and reindexing
+var A: [1..8] real = [i in 1..8] i;
+v.load(A[3..6], 3);
+writeln(v);
+v.load(A.reindex(0..7), 4);
+writeln(v);
+v *= 2.0;
+v.store(A[5..8], 5);
+writeln(A);
@@ -0,0 +1,58 @@
+use List;
+
+// Indexing, growth at both ends and removal.
+var l: list(int);
+for i in 1..10 do l.append(i);
+l.prepend(0);
+l.push_front(-1);
+writeln(l);
+writeln(l[1], " ", l[l.length]);
+l[3] = 100;
+const front = l.pop_front(), back = l.pop_back();
+writeln(front, " ", back);
+l.remove(5);
+writeln(l, " (", l.length, ")");
+
+// reserve and shrink
+l.reserve(100);
+writeln(l.capacity >= 100);
+l.shrink();
+writeln(l.capacity == l.length);
+
+// Appending an array
+var A = [20, 30, 40];
+l.append(A);
+writeln(l);
+
+// Parallel iteration, including zippering with a range
+var total = 0;
+forall x in l with (+ reduce total) do total += x;
+writeln(total == + reduce l);
+forall (x, i) in zip(l, 1..) do x = i * i;
+writeln(l);
+
+// Copies are independent
+var m = l;
+m[1] = -1;
+m.append(0);
+writeln(l[1], " ", m[1], " ", l.length, " ", m.length);
+
+// Elements that own memory
+var s: list(string);
+s.append("alpha", "beta", "gamma");
+s.push_front("omega");
+s.remove("beta");
+const last = s.pop_back();
+writeln(s, " ", last);
+
+// Parallel-safe appends
+var p: list(int, parSafe=true);
+forall i in 1..1000 with (ref p) do p.append(i);
+writeln(p.length, " ", + reduce p);
+
+// Concatenating lists that differ in parSafe
+var q: list(int);
+q.append(1, 2);
+q.concat(p);
+p.concat(q);
+writeln(q.length, " ", p.length);
@@ -0,0 +1,43 @@
+use Memory;
+
+config const n = 10000;
+
+const before = memoryUsed();
+var region = new owned MemoryRegion(chunkSize=4096);
+
+// Allocate from many tasks at once, and check that no two allocations
+// overlap by filling each one and reading it back.
+var Ptrs: [1..n] c_ptr(int);
+forall i in 1..n {
+  const len = 1 + i % 7;
+  var p = region.alloc(int, len);
+  for j in 0..#len do p[j] = i;
+  Ptrs[i] = p;
+}
+
+var ok = true;
+forall i in 1..n with (&& reduce ok) {
+  for j in 0..#(1 + i % 7) do
+    ok &&= Ptrs[i][j] == i;
+}
+writeln("allocations intact: ", ok);
+
+// Each request is rounded up to a multiple of 16 bytes.
+var expected = 0;
+for i in 1..n do expected += ((1 + i % 7) * 8 + 15) / 16 * 16;
+writeln("used matches requests: ", region.used() == expected);
+writeln("reserved covers used: ", region.reserved() >= region.used());
+
+// A large request gets a chunk of its own.
+var big = region.alloc(uint(8), 1 << 20);
+big[(1 << 20) - 1] = 42;
+writeln("large allocation: ", big[(1 << 20) - 1]);
+
+writeln("tracked: ", memoryUsed() - before >= region.reserved());
+
+region.reset();
+writeln("after reset: ", region.used(), " ", region.reserved());
+
+var p = region.alloc(real, 4);
+p[3] = 1.5;
+writeln("reused: ", p[3]);
@@ -0,0 +1,82 @@
+//
+// Bulk transfers between distributed arrays that do not share a
+// distribution.  'targetLocales' may repeat a locale so that several
+// local pieces exist even when running on a single locale.
+//
+use BlockDist, CyclicDist, BlockCycDist;
+
+config const n = 20;
+
+const targets3 = [i in 0..#3] Locales[i % numLocales],
+      targets2 = [i in 0..#2] Locales[(i+1) % numLocales],
+      targets4: [0..1, 0..1] locale = [(i,j) in {0..1, 0..1}] Locales[(2*i+j) % numLocales];
+
+proc check(A, B, msg) {
+  const success = chpl__bulkTransferArray(A, B);
+  var ok = success;
+  for (a, b) in zip(A, B) do
+    if a != b then ok = false;
+  writeln(msg, ": ", if ok then "OK" else "FAILED");
+}
+
+proc fill(ref B) {
+  var i = 0;
+  for b in B {
+    i += 1;
+    b = i;
+  }
+}
+
+{
+  const D1 = {1..n} dmapped Block({1..n}, targetLocales=targets3),
+        D2 = {1..n} dmapped Block({1..n}, targetLocales=targets2);
+  var A: [D1] int, B: [D2] int;
+  fill(B);
+  check(A, B, "Block = Block (targetLocales)");
+}
+
+{
+  const D1 = {1..n, 1..n} dmapped Block({1..n, 1..n}, targetLocales=targets4),
+        D2 = {1..n, 1..n} dmapped Block({1..n/2, 1..n}, targetLocales=targets3);
+  var A: [D1] real, B: [D2] real;
+  fill(B);
+  check(A, B, "Block = Block (boundingBox)");
+}
+
+{
+  const D1 = {1..n} dmapped Block({1..n}, targetLocales=targets3),
+        D2 = {1..2*n} dmapped Block({1..2*n}, targetLocales=targets2);
+  var A: [D1] int, B: [D2] int;
+  fill(B);
+  check(A[2..n-1], B[n+2..2*n-1], "Block = Block (translated views)");
+}
+
+{
+  const D1 = {1..n, 1..n} dmapped Block({1..n, 1..n}, targetLocales=targets3),
+        D2 = {1..n, 1..n} dmapped Cyclic(startIdx=(1,1), targetLocales=targets4);
+  var A: [D1] int, B: [D2] int;
+  fill(B);
+  check(A, B, "Block = Cyclic");
+  fill(A);
+  check(B, A, "Cyclic = Block");
+}
+
+{
+  const D1 = {1..n, 1..n} dmapped Block({1..n, 1..n}, targetLocales=targets2),
+        D2 = {1..n, 1..n} dmapped BlockCyclic(startIdx=(1,1), blocksize=(3,4),
+                                              targetLocales=targets4);
+  var A: [D1] int, B: [D2] int;
+  fill(B);
+  check(A, B, "Block = BlockCyclic");
+  fill(A);
+  check(B, A, "BlockCyclic = Block");
+}
+
+{
+  const D1 = {1..n} dmapped Cyclic(startIdx=1, targetLocales=targets2),
+        D2 = {1..n} dmapped BlockCyclic(startIdx=1, blocksize=3,
+                                        targetLocales=targets3);
+  var A: [D1] int, B: [D2] int;
+  fill(B);
+  check(A, B, "Cyclic = BlockCyclic");
+}
@@ -0,0 +1,45 @@
+record R {
+  var s: string;
+  var A: [1..3] int;
+}
+
+proc make(n: int) {
+  var r = new R("hello" + n:string);
+  r.A[1] = n;
+  var r2 = r;   // r is dead after this copy
+  return r2;
+}
+
+proc take(in x: R) {
+  writeln(x);
+}
+
+proc views() {
+  var A: [1..4] int = 1;
+  var B = A[2..3];   // B must not become the view of A
+  B = 5;
+  writeln(A, " ", B);
+}
+
+proc borrowedString() {
+  var w = new string(c"borrowed", isowned=false, needToCopy=false);
+  var x = w;         // w does not own its buffer, so this copy must stay
+  writeln(x);
+}
+
+proc main() {
+  var q = make(3);
+  take(q);
+
+  var s = "abc" * 3;
+  var t = s;    // s is dead after this copy
+  writeln(t);
+
+  var u = "xyz";
+  var v = u;    // u is still used below, so this copy must stay
+  v += "!";
+  writeln(u, " ", v);
+
+  views();
+  borrowedString();
+}
@@ -0,0 +1,30 @@
+// Loads of the array class (X._instance) and of its metadata (shiftedData,
+// blk) only depend on the arrays, so they should be hoisted out of these
+// call-free loops even though X and Y are passed by reference.
+
+config const n = 6;
+
+proc axpy(ref X: [] real, const ref Y: [] real, a: real) {
+  for i in 1..n do
+    X[i] += a * Y[i];
+}
+
+proc transpose(ref X: [] real, const ref Y: [] real) {
+  for i in 1..n do
+    for j in 1..n do
+      X[i, j] = Y[j, i];
+}
+
+proc main() {
+  var A, B: [1..n] real;
+  var M, T: [1..n, 1..n] real;
+
+  for i in 1..n do B[i] = i;
+  for (i, j) in {1..n, 1..n} do M[i, j] = i * 10 + j;
+
+  axpy(A, B, 2.0);
+  transpose(T, M);
+
+  writeln(A);
+  writeln(T);
+}
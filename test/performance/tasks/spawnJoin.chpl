@@ -0,0 +1,60 @@
+//
+// Measures the latency of spawning and joining small tasks: a single
+// begin waited for by a sync block, a two-statement cobegin, and a
+// coforall over numTasks iterations.
+//
+use Time;
+
+config const numTrials = 1000;
+
+// Tasks created by each coforall trial
+config const numTasks = 100;
+
+config const printPerf = false;
+
+var count: atomic int;
+
+proc check(expected: int) {
+  if count.read() != expected then
+    halt("expected ", expected, " tasks to run, but ", count.read(), " did");
+  count.write(0);
+}
+
+proc report(key: string, t: Timer, tasks: int) {
+  if printPerf then
+    writeln(key, " ", t.elapsed(TimeUnits.microseconds) / tasks);
+}
+
+{
+  var t: Timer;
+  t.start();
+  for 1..numTrials do
+    sync begin count.add(1);
+  t.stop();
+  check(numTrials);
+  report("begin:", t, numTrials);
+}
+
+{
+  var t: Timer;
+  t.start();
+  for 1..numTrials do
+    cobegin {
+      count.add(1);
+      count.add(1);
+    }
+  t.stop();
+  check(2 * numTrials);
+  report("cobegin:", t, 2 * numTrials);
+}
+
+{
+  var t: Timer;
+  t.start();
+  for 1..numTrials do
+    coforall 1..numTasks do
+      count.add(1);
+  t.stop();
+  check(numTrials * numTasks);
+  report("coforall:", t, numTrials * numTasks);
+}
@@ -0,0 +1,35 @@
+// Reductions whose tasks run on many locales combine their results per
+// locale and then across locales in a tree.  Check that every task's
+// contribution is counted exactly once.
+
+use BlockDist;
+
+config const n = 100000;
+config const trials = 5;
+
+const D = {1..n} dmapped Block({1..n});
+var A: [D] int = 1..n;
+const expected = n * (n + 1) / 2;
+
+for trial in 1..trials {
+  const s = + reduce A;
+  if s != expected then writeln("reduce expression: ", s);
+
+  var x = 0;
+  forall a in A with (+ reduce x) do x += a;
+  if x != expected then writeln("forall reduce intent: ", x);
+
+  var y = 0;
+  coforall loc in Locales with (+ reduce y) do on loc {
+    var z = 0;
+    coforall tid in 1..here.maxTaskPar with (+ reduce z) do z += tid;
+    y += z;
+  }
+  const perLocale = here.maxTaskPar * (here.maxTaskPar + 1) / 2;
+  if y != perLocale * numLocales then writeln("coforall reduce intent: ", y);
+
+  const (minVal, minIdx) = minloc reduce zip([a in A] (a - n/3) * (a - n/3), D);
+  if minVal != 0 || minIdx != n/3 then writeln("minloc: ", (minVal, minIdx));
+}
+
+writeln("done");
@@ -0,0 +1,64 @@
+// Scans of 1-D default rectangular and Block arrays are computed in
+// parallel, in chunks.  Check the results against a serial scan for
+// several numbers of tasks and locales, including chunks and blocks
+// with no elements.
+
+use BlockDist;
+
+config const n = 1000;
+
+// Keeps the last nonzero element: associative, but not commutative
+class LastNonzeroOp: ReduceScanOp {
+  type eltType;
+  var value: eltType;
+
+  proc identity return 0:eltType;
+  proc accumulate(x) { if x != 0 then value = x; }
+  proc accumulateOntoState(ref state, x) { if x != 0 then state = x; }
+  proc combine(x) { if x.value != 0 then value = x.value; }
+  proc generate() return value;
+  proc clone() return new unmanaged LastNonzeroOp(eltType=eltType);
+}
+
+proc check(name, A, B, op) {
+  var expected = op.identity;
+  var ok = true;
+  for (a, b) in zip(A, B) {
+    op.accumulateOntoState(expected, a);
+    if b != expected then ok = false;
+  }
+  writeln(name, ": ", if ok then "ok" else "wrong", " ", B.domain);
+  delete op;
+}
+
+for len in (0, 1, 2, 7, n) {
+  var A: [1..len] int = [i in 1..len] (i * 7919) % 101 - 50;
+  check("+", A, + scan A, new unmanaged SumReduceScanOp(eltType=int));
+  check("max", A, max scan A, new unmanaged MaxReduceScanOp(eltType=int));
+  check("min", A, min scan A, new unmanaged MinReduceScanOp(eltType=int));
+  check("^", A, ^ scan A, new unmanaged BitwiseXorReduceScanOp(eltType=int));
+
+  var Z: [1..len] int = [i in 1..len] if i % 3 == 0 then i else 0;
+  check("last", Z, LastNonzeroOp scan Z,
+        new unmanaged LastNonzeroOp(eltType=int));
+
+  // The sum of bools is an int, so this scan is computed serially
+  var Bools: [1..len] bool = [i in 1..len] i % 2 == 0;
+  const BoolSums = + scan Bools;
+  check("+ bool", Bools, BoolSums, new unmanaged SumReduceScanOp(eltType=bool));
+
+  var R: [0..#2*len by 2] real = [i in 0..#len] i / 2.0;
+  check("+ real", R, + scan R, new unmanaged SumReduceScanOp(eltType=real));
+
+  if len > 0 {
+    const targets = [loc in 0..#4] Locales[loc % numLocales];
+    const D = {1..len} dmapped Block({1..len}, targetLocales=targets);
+    var BA: [D] int = A;
+    const BS = + scan BA;
+    check("+ Block", BA, BS, new unmanaged SumReduceScanOp(eltType=int));
+    var BZ: [D] int = Z;
+    check("last Block", BZ, LastNonzeroOp scan BZ,
+          new unmanaged LastNonzeroOp(eltType=int));
+    writeln(BS.domain.dist.type:string);
+  }
+}
@@ -0,0 +1,37 @@
+// Remote on-statements whose argument bundles are too large to be sent
+// in a single active message, blocking and non-blocking.
+
+config param n = 16384;
+config const trials = 40;
+
+proc makeTuple() {
+  var t: n*int;
+  for i in 1..n do t(i) = i;
+  return t;
+}
+
+const t = makeTuple();
+const expected = n * (n + 1) / 2;
+
+var sums: [LocaleSpace] sync int;
+
+for trial in 1..trials {
+  for loc in Locales do on loc {
+    var s = 0;
+    for i in 1..n do s += t(i);
+    if s != expected then writeln("blocking on ", here.id, ": ", s);
+  }
+
+  for loc in Locales do begin on loc {
+    var s = 0;
+    for i in 1..n do s += t(i);
+    sums[here.id] = s;
+  }
+
+  for loc in Locales {
+    const s = sums[loc.id];
+    if s != expected then writeln("non-blocking on ", loc.id, ": ", s);
+  }
+}
+
+writeln("done");
@@ -0,0 +1,47 @@
+//
+// Have every task on every locale do executeOns to locale 0 at once,
+// with on-statement argument bundles both small enough to go in the
+// comm layer's request and too large to, and in blocking, non-blocking
+// and "fast" forms.
+//
+config const onsPerTask = 1000;
+
+record big {
+  var x: 32*int;
+}
+
+var smallCnt, bigCnt, nbCnt, fastCnt: atomic int;
+
+coforall loc in Locales do on loc {
+  coforall 1..here.maxTaskPar {
+    var b: big;
+    for i in 1..b.x.size do
+      b.x[i] = i;
+
+    for 1..onsPerTask {
+      const i = 1;
+      on Locales[0] do smallCnt.add(i);
+
+      on Locales[0] {
+        var sum = 0;
+        for j in 1..b.x.size do
+          sum += b.x[j];
+        if sum == b.x.size * (b.x.size + 1) / 2 then
+          bigCnt.add(1);
+      }
+
+      on Locales[0] do fastCnt.add(1);
+    }
+
+    sync {
+      for 1..onsPerTask do
+        begin on Locales[0] do nbCnt.add(1);
+    }
+  }
+}
+
+const want = onsPerTask * + reduce [loc in Locales] loc.maxTaskPar;
+writeln(smallCnt.read() == want);
+writeln(bigCnt.read() == want);
+writeln(nbCnt.read() == want);
+writeln(fastCnt.read() == want);
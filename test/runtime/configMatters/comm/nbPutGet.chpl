@@ -0,0 +1,26 @@
+//
+// Check remote PUTs and GETs done with the comm layer's non-blocking
+// interface.  With --cache-remote, dirty cache lines are written back
+// and sequential reads, forward and backward, are prefetched using
+// non-blocking operations, and many of them are in flight at once.
+//
+config const n = 100000;
+
+var A: [1..n] int;
+
+on Locales[numLocales - 1] {
+  for i in 1..n do
+    A[i] = i;
+
+  var sum = 0;
+  for i in 1..n do
+    sum += A[i];
+  writeln(sum == n * (n + 1) / 2);
+
+  sum = 0;
+  for i in 1..n by -1 do
+    sum += A[i];
+  writeln(sum == n * (n + 1) / 2);
+}
+
+writeln(+ reduce A == n * (n + 1) / 2);
@@ -0,0 +1,95 @@
+// Check find, rfind and count against a brute force search, for short and
+// long needles, contiguous and strided regions, and overlapping matches.
+
+use Random;
+
+config const seed = 314159;
+config const trials = 300;
+
+proc naiveMatch(hay: string, needle: string, i: int) {
+  for j in 0..#needle.length do
+    if hay.buff[i+j-1] != needle.buff[j] then return false;
+  return true;
+}
+
+proc naiveFind(hay: string, needle: string, r: range) {
+  const lo = r.low, hi = r.high - needle.length + 1;
+  if needle.isEmptyString() then return 0;
+  for i in lo..hi do
+    if naiveMatch(hay, needle, i) then return i;
+  return 0;
+}
+
+proc naiveRFind(hay: string, needle: string, r: range) {
+  const lo = r.low, hi = r.high - needle.length + 1;
+  if needle.isEmptyString() then return if r.size == 0 then 0 else r.size + 1;
+  for i in lo..hi by -1 do
+    if naiveMatch(hay, needle, i) then return i;
+  return 0;
+}
+
+proc naiveCount(hay: string, needle: string, r: range) {
+  const lo = r.low, hi = r.high - needle.length + 1;
+  if needle.isEmptyString() then return r.size + 1;
+  var n = 0;
+  for i in lo..hi do
+    if naiveMatch(hay, needle, i) then n += 1;
+  return n;
+}
+
+var rs = makeRandomStream(real, seed);
+proc randInt(n: int) return (rs.getNext() * n): int;
+
+const letters = "abc";
+
+proc randString(len: int, alphabet: int) {
+  var s: string;
+  for 1..len do s += letters[1 + randInt(alphabet)];
+  return s;
+}
+
+var failures = 0;
+for t in 1..trials {
+  const alphabet = 1 + randInt(3);
+  const hayLen = randInt(200);
+  const needleLen = if t % 2 == 0 then randInt(8) else 24 + randInt(48);
+  var hay = randString(hayLen, alphabet);
+  const needle = randString(needleLen, alphabet);
+
+  // plant the needle at least once when it fits
+  if needleLen <= hayLen && randInt(2) == 0 {
+    const at = 1 + randInt(hayLen - needleLen + 1);
+    hay = hay[..at-1] + needle + hay[at+needleLen..];
+  }
+
+  const lo = 1 + randInt(hayLen/4 + 1);
+  const r = lo..max(lo-1, hayLen - randInt(hayLen/4 + 1));
+
+  if hay.find(needle, r) != naiveFind(hay, needle, r) ||
+     hay.rfind(needle, r) != naiveRFind(hay, needle, r) ||
+     hay.count(needle, r) != naiveCount(hay, needle, r) {
+    writeln("mismatch: hay=", hay, " needle=", needle, " region=", r);
+    failures += 1;
+  }
+}
+
+// Overlapping matches are all counted.
+writeln("aaaaa".count("aa"));
+writeln("abababab".count("abab"));
+
+const long = "xy" * 40 + "needle in a haystack, well past the short path" + "yx" * 40;
+writeln(long.find("needle in a haystack, well past the short path"));
+writeln(long.rfind("needle in a haystack, well past the short path"));
+writeln(long.count("xyxyxyxyxyxyxyxyxyxyxyxyxyxyxyxyxy"));
+
+// Strided regions still use the general search.
+writeln("abcabcabc".find("aaa", 1..9 by 3));
+writeln("abcabcabc".count("b", 1..9 by 2));
+
+// replace and split are built on find.
+writeln(long.replace("needle", "pin").find("pin in a haystack"));
+var pieces = 0;
+for ("a--b--c" * 20).split("--") do pieces += 1;
+writeln(pieces);
+
+writeln(if failures == 0 then "SUCCESS" else "FAILED");
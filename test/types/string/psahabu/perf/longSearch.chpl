@@ -0,0 +1,56 @@
+use Time;
+
+config const timing = true;
+config const n = 1000;
+config const sourcePath = "moby.txt";
+
+// Read the whole book into one string to search through.
+var mobyFile = open(sourcePath, iomode.r);
+var moby: string;
+mobyFile.reader().readstring(moby);
+
+// A short needle with a common first byte, a long needle that is
+// rare, and a long needle that does not occur at all.
+const shortNeedle = "the whale";
+const longNeedle = "It is not down in any map; true places never are.";
+const missingNeedle = "the whale the whale the whale the whale the whale!";
+
+var found = 0;
+
+// find
+var tFind: Timer;
+if timing then tFind.start();
+for i in 1..n {
+  found += moby.find(longNeedle) != 0;
+  found += moby.find(missingNeedle) != 0;
+}
+if timing then tFind.stop();
+
+// count
+var tCount: Timer;
+if timing then tCount.start();
+for i in 1..n {
+  found += moby.count(shortNeedle) != 0;
+}
+if timing then tCount.stop();
+
+// hash
+var Words: [1..0] string;
+for w in moby.split() do Words.push_back(w);
+
+var tHash: Timer;
+var D: domain(string);
+if timing then tHash.start();
+for i in 1..n/100+1 {
+  D.clear();
+  for w in Words do D += w;
+}
+if timing then tHash.stop();
+
+if timing {
+  writeln("find: ", tFind.elapsed());
+  writeln("count: ", tCount.elapsed());
+  writeln("hash: ", tHash.elapsed());
+}
+if found == 2*n && D.size > 0 then
+  writeln("SUCCESS");
@@ -0,0 +1,57 @@
+// Arrays of sync variables used as fine-grained locks.  With simple value
+// types the full/empty state is stored in the elements themselves.
+
+config const n = 16;
+config const tasks = 8;
+config const iters = 1000;
+
+var locks: [0..#n] sync bool;
+var counts: [0..#n] int;
+
+// All of the locks start out empty.  Fill them to make them available.
+for l in locks do l.writeEF(true);
+
+coforall t in 0..#tasks {
+  for i in 0..#iters {
+    const j = (t + i) % n;
+
+    locks[j].readFE();
+    counts[j] += 1;
+    locks[j].writeEF(true);
+  }
+}
+
+writeln(+ reduce counts == tasks * iters);
+var allFull = true;
+for l in locks do allFull &&= l.isFull;
+writeln(allFull);
+
+// A sync variable captured by a task is the same variable.
+var done: [1..2] sync int;
+
+begin with (ref done) done[1].writeEF(1);
+cobegin {
+  done[2].writeEF(2);
+  writeln(done[1].readFE());
+}
+writeln(done[2].readFE());
+
+// The other operations.
+var r: sync real;
+
+writeln(r.isFull);
+r.writeXF(1.5);
+writeln(r.readFF(), " ", r.readXX(), " ", r.isFull);
+r.writeFF(2.5);
+writeln(r.readFE(), " ", r.isFull);
+r.reset();
+writeln(r.readXX(), " ", r.isFull);
+
+// Singles.
+var ready: [1..3] single int;
+
+coforall i in 1..3 {
+  if i > 1 then ready[i].writeEF(ready[i-1].readFF() + 1);
+  else ready[i].writeEF(1);
+}
+writeln(ready[3].readFF(), " ", ready[3].readFF(), " ", ready[3].isFull);
@@ -0,0 +1,52 @@
+// Sync and single variables used by tasks on other locales.  Copies made
+// for those tasks are aliases that forward every operation to the
+// original variable on its home locale.
+
+config const iters = 100;
+
+// Every locale updates a counter that lives on locale 0.
+var count: sync int;
+count.writeEF(0);
+
+coforall loc in Locales do on loc {
+  for i in 1..iters do
+    count.writeEF(count.readFE() + 1);
+}
+writeln(count.readFF() == numLocales * iters);
+
+// A task started on another locale fills a variable the main task waits on.
+var handoff: sync int;
+
+on Locales[numLocales - 1] {
+  begin handoff.writeEF(here.id);
+}
+writeln(handoff.readFE() == numLocales - 1);
+writeln(handoff.isFull);
+
+// A single filled on the last locale and read everywhere.
+var ready: single bool;
+var sawReady: [0..#numLocales] bool;
+
+coforall loc in Locales with (ref sawReady) do on loc {
+  if here.id == numLocales - 1 then
+    ready.writeEF(true);
+  sawReady[here.id] = ready.readFF();
+}
+writeln(&& reduce sawReady, " ", ready.isFull);
+
+// Elements of an array of syncs used as locks from every locale.
+var locks: [0..#numLocales] sync bool;
+var counts: [0..#numLocales] int;
+
+for l in locks do l.writeEF(true);
+
+coforall loc in Locales with (ref counts) do on loc {
+  for i in 0..#iters {
+    const j = (here.id + i) % numLocales;
+
+    locks[j].readFE();
+    counts[j] += 1;
+    locks[j].writeEF(true);
+  }
+}
+writeln(+ reduce counts == numLocales * iters);
@@ -18,6 +18,8 @@ def get(flag='target'):
         if not atomics_val:
             if chpl_comm.get() == 'ugni' and get('target') != 'locks':
                 atomics_val = 'ugni'
+            elif chpl_comm.get() == 'ofi' and get('target') != 'locks':
+                atomics_val = 'ofi'
             else:
                 atomics_val = 'none'
     elif flag == 'target':